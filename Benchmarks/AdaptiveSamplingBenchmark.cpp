@@ -0,0 +1,105 @@
+﻿//==============================================================================
+// BeyondLink - Beyond激光可视化系统
+// 文件：AdaptiveSamplingBenchmark.cpp
+// 作者：Yunsio
+// 日期：2025-10-06
+// 描述：自适应插值与固定样本数的性能对比
+//       同一曲线按不同原始点数生成（点越密，段越短），分别以固定 SampleCount 和
+//       不同目标像素间距的自适应插值处理，输出样本数、每帧耗时、加速比，
+//       以及主点列表颜色总和相对固定模式的比例（加法混合下的整帧亮度，应接近 1）
+//       用法：AdaptiveSamplingBenchmark [样本数=8] [重复帧数=100] [纹理尺寸=1024]
+//==============================================================================
+
+#include "BenchmarkCommon.h"
+#include "ScannerPipeline.h"
+#include "FrameArena.h"
+#include <cstdio>
+#include <cstdlib>
+
+using namespace BeyondLink::Core;
+using namespace BeyondLink::Benchmarks;
+
+namespace {
+
+//==========================================================================
+// 结构体：RunResult
+// 描述：一种模式的测量结果
+//==========================================================================
+struct RunResult {
+    double Microseconds = 0.0;
+    uint64_t Samples = 0;
+    size_t Processed = 0;
+    double Brightness = 0.0;
+};
+
+//==========================================================================
+// 函数：RunMode
+// 描述：重复处理测试帧，统计每帧耗时、样本数和主点列表颜色总和
+//==========================================================================
+RunResult RunMode(const LaserFrame& raw, ScannerPipelineParams params, int frames) {
+    FrameArena arena;
+    ScannerPipelineStats stats;
+    params.Arena = &arena;
+    const ScannerPipelineFunc pipeline = ScannerPipeline::Select(params);
+    LaserFrame processed;
+    LaserFrame beam;
+    
+    RunResult result;
+    result.Microseconds = MeasureMicroseconds(frames, [&]() {
+        arena.Reset();
+        pipeline(raw.View(), params, processed, beam);
+    });
+    
+    params.Stats = &stats;
+    pipeline(raw.View(), params, processed, beam);
+    result.Samples = stats.Samples;
+    result.Processed = processed.Size();
+    const FrameView view = processed.View();
+    for (size_t i = 0; i < view.Count; ++i) {
+        result.Brightness += static_cast<double>(view.R[i]) + view.G[i] + view.B[i];
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int sampleCount = argc > 1 ? std::atoi(argv[1]) : 8;
+    const int frames = argc > 2 ? std::atoi(argv[2]) : 100;
+    const int textureSize = argc > 3 ? std::atoi(argv[3]) : 1024;
+    if (sampleCount < 2 || frames < 1 || textureSize < 1) {
+        std::fprintf(stderr, "usage: AdaptiveSamplingBenchmark [sample count >= 2] [frames] [texture size]\n");
+        return 1;
+    }
+    
+    const size_t pointCounts[] = { 500, 2000, 8000, 32000 };
+    const float pixelSpacings[] = { 1.0f, 2.0f, 4.0f };
+    
+    LaserSettings settings;
+    settings.SampleCount = sampleCount;
+    settings.TextureSize = textureSize;
+    
+    std::printf("%-8s %-16s %10s %12s %8s %10s %10s\n",
+                "points", "mode", "samples", "us/frame", "speedup", "processed", "brightness");
+    for (size_t pointCount : pointCounts) {
+        const LaserFrame raw = MakeShowFrame(pointCount);
+        
+        settings.AdaptiveSampling = false;
+        const RunResult fixed = RunMode(raw, ScannerPipelineParams::FromSettings(settings, true, false), frames);
+        std::printf("%-8zu %-16s %10llu %12.1f %8.2f %10zu %10.3f\n", pointCount, "fixed",
+                    static_cast<unsigned long long>(fixed.Samples), fixed.Microseconds, 1.0, fixed.Processed, 1.0);
+        
+        for (float spacing : pixelSpacings) {
+            settings.AdaptiveSampling = true;
+            settings.AdaptivePixelSpacing = spacing;
+            const RunResult adaptive = RunMode(raw, ScannerPipelineParams::FromSettings(settings, true, false), frames);
+            char mode[32];
+            std::snprintf(mode, sizeof(mode), "adaptive %.0fpx", spacing);
+            std::printf("%-8zu %-16s %10llu %12.1f %8.2f %10zu %10.3f\n", pointCount, mode,
+                        static_cast<unsigned long long>(adaptive.Samples), adaptive.Microseconds,
+                        fixed.Microseconds / adaptive.Microseconds, adaptive.Processed,
+                        fixed.Brightness > 0.0 ? adaptive.Brightness / fixed.Brightness : 0.0);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,71 @@
+﻿//==============================================================================
+// BeyondLink - Beyond激光可视化系统
+// 文件：BenchmarkCommon.h
+// 作者：Yunsio
+// 日期：2025-10-06
+// 描述：性能测试公共工具：测试帧生成和计时
+//==============================================================================
+
+#pragma once
+
+#include "LaserFrame.h"
+#include <chrono>
+#include <cmath>
+
+namespace BeyondLink {
+namespace Benchmarks {
+
+//==========================================================================
+// 函数：MakeShowFrame
+// 描述：生成类似演出画面的测试帧：李萨如曲线，每 64 个点一次消隐跳转，
+//       每 500 个点一个 8 点驻留的光束
+// 参数：
+//   pointCount - 点数
+// 返回值：
+//   Core::LaserFrame - 测试帧
+//==========================================================================
+inline Core::LaserFrame MakeShowFrame(size_t pointCount) {
+    Core::LaserFrame frame;
+    frame.Reserve(pointCount);
+    for (size_t i = 0; i < pointCount; ++i) {
+        const float t = static_cast<float>(i) / static_cast<float>(pointCount) * 6.2831853f;
+        Core::LaserPoint point(0.8f * std::sin(3.0f * t), 0.8f * std::sin(4.0f * t + 0.5f),
+                               0.5f + 0.5f * std::sin(t), 0.5f + 0.5f * std::cos(t), 1.0f);
+        if (i % 64 == 63) {
+            point.R = point.G = point.B = 0.0f;
+        }
+        if (i % 500 < 8) {
+            point.Z = 1.0f;
+            if (i % 500 > 0) {
+                const Core::LaserPoint previous = frame.GetPoint(frame.Size() - 1);
+                point.X = previous.X;
+                point.Y = previous.Y;
+            }
+        }
+        frame.Append(point);
+    }
+    return frame;
+}
+
+//==========================================================================
+// 函数：MeasureMicroseconds
+// 描述：先运行一次预热（输出缓冲增长到稳定容量），再重复运行并计算平均耗时
+// 参数：
+//   repeats - 重复次数
+//   run - 被测函数
+// 返回值：
+//   double - 每次运行的平均耗时（微秒）
+//==========================================================================
+template <typename Func>
+double MeasureMicroseconds(int repeats, Func&& run) {
+    run();
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; ++i) {
+        run();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds * 1e6 / repeats;
+}
+
+} // namespace Benchmarks
+} // namespace BeyondLink
@@ -0,0 +1,163 @@
+﻿//==============================================================================
+// BeyondLink - Beyond激光可视化系统
+// 文件：InterpolationErrorBenchmark.cpp
+// 作者：Yunsio
+// 日期：2025-10-06
+// 描述：插值方式的几何误差与耗时对比
+//       圆按均匀和不均匀（相邻段长 1:3 交替）角间距取原始点，分别以线性、Catmull-Rom 和
+//       Hermite 插值、不同 SampleCount 生成样本，沿样本折线（即渲染出的线段）测量到真实圆的
+//       径向距离（像素），并输出扫描仪模拟处理每帧的耗时；
+//       用于确认三次插值以较少样本数达到线性插值较多样本数的精度
+//       用法：InterpolationErrorBenchmark [原始点数=24] [重复帧数=2000] [纹理尺寸=1024]
+//==============================================================================
+
+#include "BenchmarkCommon.h"
+#include "ScannerPipeline.h"
+#include "FrameArena.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace BeyondLink::Core;
+using namespace BeyondLink::Benchmarks;
+
+namespace {
+
+// 测试圆半径（坐标单位）
+constexpr float CircleRadius = 0.8f;
+
+// 每对相邻样本之间检查的折线位置数
+constexpr int ChordSteps = 8;
+
+//==========================================================================
+// 函数：MakeCircleFrame
+// 描述：生成闭合圆（首尾点重合），uneven 时相邻角间距按 1:3 交替
+//==========================================================================
+LaserFrame MakeCircleFrame(int pointCount, bool uneven) {
+    LaserFrame frame;
+    frame.Reserve(static_cast<size_t>(pointCount) + 1);
+    const double step = 6.283185307179586 / pointCount;
+    double angle = 0.0;
+    for (int i = 0; i <= pointCount; ++i) {
+        const double a = i == pointCount ? 0.0 : angle;
+        frame.Append(LaserPoint(static_cast<float>(CircleRadius * std::cos(a)),
+                                static_cast<float>(CircleRadius * std::sin(a)), 1.0f, 1.0f, 1.0f));
+        angle += uneven ? step * (i % 2 == 0 ? 0.5 : 1.5) : step;
+    }
+    return frame;
+}
+
+//==========================================================================
+// 结构体：ErrorResult
+// 描述：样本折线到真实圆的径向误差（像素）
+//==========================================================================
+struct ErrorResult {
+    double MaxPixels = 0.0;
+    double MeanPixels = 0.0;
+};
+
+//==========================================================================
+// 函数：MeasureError
+// 描述：按处理实例的取样位置（t = k / SampleCount）生成样本，沿相邻样本之间的线段测量径向误差
+//       跳过首尾两段：帧端点的切线取弦向量，各插值方式在这两段上相同
+//==========================================================================
+ErrorResult MeasureError(const LaserFrame& raw, LaserSettings::InterpolationMode mode, int sampleCount,
+                         double pixelsPerUnit) {
+    const FrameView view = raw.View();
+    ErrorResult result;
+    size_t measured = 0;
+    float previousX = view.X[1];
+    float previousY = view.Y[1];
+    for (size_t segment = 1; segment + 2 < view.Count; ++segment) {
+        for (int k = 1; k <= sampleCount; ++k) {
+            float x = 0.0f;
+            float y = 0.0f;
+            ScannerPipeline::GetSamplePosition(view, segment, mode,
+                                               static_cast<float>(k) / static_cast<float>(sampleCount), x, y);
+            for (int s = 1; s <= ChordSteps; ++s) {
+                const double u = static_cast<double>(s) / ChordSteps;
+                const double px = previousX + (x - previousX) * u;
+                const double py = previousY + (y - previousY) * u;
+                const double error = std::abs(std::sqrt(px * px + py * py) - CircleRadius) * pixelsPerUnit;
+                result.MaxPixels = (std::max)(result.MaxPixels, error);
+                result.MeanPixels += error;
+                measured++;
+            }
+            previousX = x;
+            previousY = y;
+        }
+    }
+    result.MeanPixels /= static_cast<double>((std::max)(measured, static_cast<size_t>(1)));
+    return result;
+}
+
+//==========================================================================
+// 函数：MeasureFrameTime
+// 描述：以指定插值方式和样本数重复进行扫描仪模拟处理，返回每帧耗时（微秒）
+//==========================================================================
+double MeasureFrameTime(const LaserFrame& raw, const LaserSettings& settings,
+                        LaserSettings::InterpolationMode mode, int sampleCount, int frames) {
+    FrameArena arena;
+    ScannerPipelineParams params = ScannerPipelineParams::FromSettings(settings, true, false);
+    params.Interpolation = mode;
+    params.SampleCount = sampleCount;
+    params.Arena = &arena;
+    const ScannerPipelineFunc pipeline = ScannerPipeline::Select(params);
+    LaserFrame processed;
+    LaserFrame beam;
+    return MeasureMicroseconds(frames, [&]() {
+        arena.Reset();
+        pipeline(raw.View(), params, processed, beam);
+    });
+}
+
+//==========================================================================
+// 函数：GetModeName
+// 描述：插值方式的显示名称
+//==========================================================================
+const char* GetModeName(LaserSettings::InterpolationMode mode) {
+    switch (mode) {
+        case LaserSettings::InterpolationMode::CatmullRom: return "catmull-rom";
+        case LaserSettings::InterpolationMode::Hermite: return "hermite";
+        default: return "linear";
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int pointCount = argc > 1 ? std::atoi(argv[1]) : 24;
+    const int frames = argc > 2 ? std::atoi(argv[2]) : 2000;
+    const int textureSize = argc > 3 ? std::atoi(argv[3]) : 1024;
+    if (pointCount < 12 || frames < 1 || textureSize < 1) {
+        std::fprintf(stderr, "usage: InterpolationErrorBenchmark [raw points >= 12] [frames] [texture size]\n");
+        return 1;
+    }
+    
+    // 原始点数不少于 12 时相邻段转角不超过 45°，三次插值不会按拐角退化为折线
+    const LaserSettings::InterpolationMode modes[] = {
+        LaserSettings::InterpolationMode::Linear,
+        LaserSettings::InterpolationMode::CatmullRom,
+        LaserSettings::InterpolationMode::Hermite
+    };
+    const int sampleCounts[] = { 2, 4, 8, 16 };
+    const double pixelsPerUnit = textureSize * 0.5;
+    
+    LaserSettings settings;
+    settings.TextureSize = textureSize;
+    
+    std::printf("%-8s %-12s %8s %12s %12s %10s\n", "spacing", "mode", "samples", "max px", "mean px", "us/frame");
+    for (int uneven = 0; uneven < 2; ++uneven) {
+        const LaserFrame raw = MakeCircleFrame(pointCount, uneven != 0);
+        for (LaserSettings::InterpolationMode mode : modes) {
+            for (int sampleCount : sampleCounts) {
+                const ErrorResult error = MeasureError(raw, mode, sampleCount, pixelsPerUnit);
+                const double microseconds = MeasureFrameTime(raw, settings, mode, sampleCount, frames);
+                std::printf("%-8s %-12s %8d %12.4f %12.4f %10.2f\n", uneven ? "uneven" : "uniform",
+                            GetModeName(mode), sampleCount, error.MaxPixels, error.MeanPixels, microseconds);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,117 @@
+﻿//==============================================================================
+// BeyondLink - Beyond激光可视化系统
+// 文件：ParallelScanBenchmark.cpp
+// 作者：Yunsio
+// 日期：2025-10-06
+// 描述：分块并行扫描的线程扩展性能测试
+//       以 1 到 N 个线程（1 = 单线程实例，n > 1 = n - 1 个工作线程加调用线程）处理同一大帧，
+//       输出每帧耗时、相对单线程的加速比，以及与单线程输出的最大位置 / 颜色误差
+//       用法：ParallelScanBenchmark [分块起始状态=auto|warmup|exact] [最大线程数=硬件线程数]
+//                                   [原始点数=20000] [平滑因子=0.83] [重复帧数=50]
+//==============================================================================
+
+#include "BenchmarkCommon.h"
+#include "ScannerPipeline.h"
+#include "WorkerPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+using namespace BeyondLink::Core;
+using namespace BeyondLink::Benchmarks;
+
+namespace {
+
+//==========================================================================
+// 函数：ParseSeeding
+// 描述：解析分块起始状态计算方式（未识别时返回 false）
+//==========================================================================
+bool ParseSeeding(const char* text, LaserSettings::ChunkSeeding& seeding) {
+    if (std::strcmp(text, "auto") == 0) {
+        seeding = LaserSettings::ChunkSeeding::Auto;
+    } else if (std::strcmp(text, "warmup") == 0) {
+        seeding = LaserSettings::ChunkSeeding::WarmUp;
+    } else if (std::strcmp(text, "exact") == 0) {
+        seeding = LaserSettings::ChunkSeeding::ExactCarry;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+//==========================================================================
+// 函数：GetMaxError
+// 描述：两帧对应点的最大位置误差和颜色误差（点数不同时返回无穷大）
+//==========================================================================
+void GetMaxError(const LaserFrame& a, const LaserFrame& b, float& position, float& color) {
+    if (a.Size() != b.Size()) {
+        position = color = INFINITY;
+        return;
+    }
+    position = 0.0f;
+    color = 0.0f;
+    const FrameView va = a.View();
+    const FrameView vb = b.View();
+    for (size_t i = 0; i < va.Count; ++i) {
+        position = (std::max)(position, (std::max)(std::abs(va.X[i] - vb.X[i]), std::abs(va.Y[i] - vb.Y[i])));
+        color = (std::max)(color, (std::max)(std::abs(va.R[i] - vb.R[i]),
+                                             (std::max)(std::abs(va.G[i] - vb.G[i]), std::abs(va.B[i] - vb.B[i]))));
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    LaserSettings::ChunkSeeding seeding = LaserSettings::ChunkSeeding::Auto;
+    if (argc > 1 && !ParseSeeding(argv[1], seeding)) {
+        std::fprintf(stderr, "usage: ParallelScanBenchmark [auto|warmup|exact] [max threads] [points] [smoothing] [frames]\n");
+        return 1;
+    }
+    const int maxThreads = argc > 2 ? std::atoi(argv[2]) : (std::max)(1, static_cast<int>(std::thread::hardware_concurrency()));
+    const int pointCount = argc > 3 ? std::atoi(argv[3]) : 20000;
+    const float smoothing = argc > 4 ? static_cast<float>(std::atof(argv[4])) : 0.83f;
+    const int frames = argc > 5 ? std::atoi(argv[5]) : 50;
+    if (maxThreads < 1 || pointCount < 2 || frames < 1) {
+        std::fprintf(stderr, "usage: ParallelScanBenchmark [auto|warmup|exact] [max threads] [points] [smoothing] [frames]\n");
+        return 1;
+    }
+    
+    const LaserFrame raw = MakeShowFrame(static_cast<size_t>(pointCount));
+    ScannerPipelineParams params;
+    params.VelocitySmoothing = smoothing;
+    params.Seeding = seeding;
+    params.ParallelMinSamples = 0;
+    const ScannerPipelineFunc pipeline = ScannerPipeline::Select(params);
+    
+    LaserFrame serialProcessed;
+    LaserFrame serialBeam;
+    const double serialMicroseconds = MeasureMicroseconds(frames, [&]() {
+        pipeline(raw.View(), params, serialProcessed, serialBeam);
+    });
+    
+    std::printf("%s, %zu samples, seeding %s, smoothing %.3f\n", ScannerPipeline::GetVariantName(params).c_str(),
+                ScannerPipeline::GetSampleCount(raw.Size(), params.SampleCount),
+                argc > 1 ? argv[1] : "auto", smoothing);
+    std::printf("threads  1: %9.1f us/frame | speedup 1.00\n", serialMicroseconds);
+    for (int threads = 2; threads <= maxThreads; ++threads) {
+        WorkerPool pool(static_cast<size_t>(threads - 1));
+        ScannerPipelineParams parallel = params;
+        parallel.Pool = &pool;
+        
+        LaserFrame processed;
+        LaserFrame beam;
+        const double microseconds = MeasureMicroseconds(frames, [&]() {
+            pipeline(raw.View(), parallel, processed, beam);
+        });
+        
+        float position = 0.0f;
+        float color = 0.0f;
+        GetMaxError(processed, serialProcessed, position, color);
+        std::printf("threads %2d: %9.1f us/frame | speedup %.2f | max error position %.3g, color %.3g\n",
+                    threads, microseconds, serialMicroseconds / microseconds, position, color);
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+﻿//==============================================================================
+// BeyondLink - Beyond激光可视化系统
+// 文件：PipelineVariantBenchmark.cpp
+// 作者：Yunsio
+// 日期：2025-10-06
+// 描述：扫描仪模拟特化实例性能测试
+//       遍历 ScannerPipeline::Select 的各实例（降采样倍数组合、样本数类别、光束画刷、光束输出），
+//       对同一测试帧重复处理，输出每帧耗时和每个插值样本的耗时；
+//       非 1/2/4/8 组合的降采样倍数走运行时通用实例，用于对比特化的收益
+//       用法：PipelineVariantBenchmark [原始点数=4000] [重复帧数=200]
+//==============================================================================
+
+#include "BenchmarkCommon.h"
+#include "ScannerPipeline.h"
+#include "FrameArena.h"
+#include <cstdio>
+#include <cstdlib>
+
+using namespace BeyondLink::Core;
+using namespace BeyondLink::Benchmarks;
+
+namespace {
+
+//==========================================================================
+// 函数：RunVariant
+// 描述：用参数选择的实例重复处理测试帧并输出耗时
+//==========================================================================
+void RunVariant(const LaserFrame& raw, const ScannerPipelineParams& params, int frames) {
+    const ScannerPipelineFunc pipeline = ScannerPipeline::Select(params);
+    LaserFrame processed;
+    LaserFrame beam;
+    const double frameMicroseconds = MeasureMicroseconds(frames, [&]() {
+        params.Arena->Reset();
+        pipeline(raw.View(), params, processed, beam);
+    });
+    
+    const size_t samples = params.ScannerSimulation ? ScannerPipeline::GetSampleCount(raw.Size(), params.SampleCount)
+                                                    : raw.Size();
+    std::printf("%-32s %9.1f us/frame %7.2f ns/sample | processed %6zu | beam %6zu\n",
+                ScannerPipeline::GetVariantName(params).c_str(), frameMicroseconds,
+                frameMicroseconds * 1e3 / static_cast<double>(samples), processed.Size(), beam.Size());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int pointCount = argc > 1 ? std::atoi(argv[1]) : 4000;
+    const int frames = argc > 2 ? std::atoi(argv[2]) : 200;
+    if (pointCount < 2 || frames < 1) {
+        std::fprintf(stderr, "usage: PipelineVariantBenchmark [points >= 2] [frames >= 1]\n");
+        return 1;
+    }
+    
+    const LaserFrame raw = MakeShowFrame(static_cast<size_t>(pointCount));
+    FrameArena arena;
+    
+    // 质量等级对应的降采样组合（特化）与一个通用组合
+    const int factors[][2] = { { 8, 8 }, { 4, 8 }, { 2, 2 }, { 1, 1 }, { 2, 4 } };
+    const int sampleCounts[] = { 1, 8, 6 };
+    
+    std::printf("%d raw points, %d frames per variant\n", pointCount, frames);
+    for (int brush = 0; brush < 2; ++brush) {
+        ScannerPipelineParams params;
+        params.ScannerSimulation = false;
+        params.BeamBrush = brush != 0;
+        params.Arena = &arena;
+        RunVariant(raw, params, frames);
+    }
+    for (const int* factor : factors) {
+        for (int sampleCount : sampleCounts) {
+            for (int flags = 0; flags < 4; ++flags) {
+                ScannerPipelineParams params;
+                params.SampleCount = sampleCount;
+                params.ProcessedFactor = factor[0];
+                params.BeamFactor = factor[1];
+                params.BeamBrush = (flags & 1) != 0;
+                params.BeamOutput = (flags & 2) == 0;
+                params.Arena = &arena;
+                RunVariant(raw, params, frames);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,134 @@
+﻿//==============================================================================
+// BeyondLink - Beyond激光可视化系统
+// 文件：ReceiveLatencyBenchmark.cpp
+// 作者：Yunsio
+// 日期：2025-10-06
+// 描述：回环接收延迟性能测试
+//       分别以阻塞接收和低延迟（忙轮询）模式启动 LaserProtocol，
+//       由发送线程按固定间隔向 127.0.0.1 发送数据包，比较两种模式的到达到分发延迟直方图
+//       数据包间隔大于处理耗时，接收线程每次都从空闲状态被唤醒（阻塞模式）或在自旋中取到数据包
+//       用法：ReceiveLatencyBenchmark [数据包数=2000] [间隔微秒=1000] [端口=5599] [自旋预算微秒=2000]
+//==============================================================================
+
+#include "LaserProtocol.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+using namespace BeyondLink::Core;
+
+namespace {
+
+//==========================================================================
+// 函数：SendPackets
+// 描述：按固定间隔向本机端口发送数据包
+//       负载不是有效的 Beyond 帧（全零），解码器会拒绝，测量的是唤醒与分发路径本身
+// 返回值：
+//   成功发送的数据包数
+//==========================================================================
+int SendPackets(int port, int count, int intervalMicroseconds) {
+#ifdef _WIN32
+    SOCKET sender = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sender == INVALID_SOCKET) {
+        return 0;
+    }
+#else
+    int sender = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sender < 0) {
+        return 0;
+    }
+#endif
+    
+    sockaddr_in target;
+    std::memset(&target, 0, sizeof(target));
+    target.sin_family = AF_INET;
+    target.sin_port = htons(static_cast<unsigned short>(port));
+    target.sin_addr.s_addr = inet_addr("127.0.0.1");
+    
+    std::vector<char> payload(64, 0);
+    int sent = 0;
+    auto next = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; ++i) {
+        next += std::chrono::microseconds(intervalMicroseconds);
+        std::this_thread::sleep_until(next);
+        if (sendto(sender, payload.data(), static_cast<int>(payload.size()), 0,
+                   reinterpret_cast<const sockaddr*>(&target), sizeof(target)) > 0) {
+            sent++;
+        }
+    }
+    
+#ifdef _WIN32
+    closesocket(sender);
+#else
+    close(sender);
+#endif
+    return sent;
+}
+
+//==========================================================================
+// 函数：RunMode
+// 描述：以指定接收模式运行一轮回环测试并输出延迟统计
+// 返回值：
+//   true - 协议启动成功且收到了数据包
+//==========================================================================
+bool RunMode(bool lowLatency, int port, int count, int intervalMicroseconds, int spinBudget) {
+    LaserSettings settings;
+    settings.NetworkPort = port;
+    settings.MaxLaserDevices = 1;
+    settings.LowLatencyReceive = lowLatency;
+    settings.BusyPollBudgetMicroseconds = spinBudget;
+    
+    LaserProtocol protocol(settings);
+    protocol.SetSourceResolver([](int, int) -> LaserSource* { return nullptr; });
+    if (!protocol.Start()) {
+        std::fprintf(stderr, "Failed to start receiver on port %d\n", port);
+        return false;
+    }
+    
+    const int sent = SendPackets(port, count, intervalMicroseconds);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    const LaserProtocol::LatencyStats stats = protocol.GetLatencyStats();
+    protocol.Stop();
+    
+    std::printf("%-10s sent %d | received %llu | p50 <= %llu us | p90 <= %llu us | p99 <= %llu us | max %llu us"
+                " | spin %llu | wakeups %llu | unstamped %llu\n",
+                lowLatency ? "busy-poll" : "blocking", sent,
+                static_cast<unsigned long long>(stats.Samples),
+                static_cast<unsigned long long>(stats.GetPercentile(0.5)),
+                static_cast<unsigned long long>(stats.GetPercentile(0.9)),
+                static_cast<unsigned long long>(stats.GetPercentile(0.99)),
+                static_cast<unsigned long long>(stats.MaxMicroseconds),
+                static_cast<unsigned long long>(stats.SpinReceives),
+                static_cast<unsigned long long>(stats.BlockingWakeups),
+                static_cast<unsigned long long>(stats.UnstampedReceives));
+    
+    std::printf("           histogram (us):");
+    for (int i = 0; i < LaserProtocol::LatencyStats::BucketCount; ++i) {
+        if (stats.Buckets[i] > 0) {
+            std::printf(" <%llu:%llu", 1ull << i, static_cast<unsigned long long>(stats.Buckets[i]));
+        }
+    }
+    std::printf("\n");
+    return stats.Samples > 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int count = argc > 1 ? std::atoi(argv[1]) : 2000;
+    const int intervalMicroseconds = argc > 2 ? std::atoi(argv[2]) : 1000;
+    const int port = argc > 3 ? std::atoi(argv[3]) : 5599;
+    const int spinBudget = argc > 4 ? std::atoi(argv[4]) : 2000;
+    
+    // 自旋预算不小于发送间隔时，低延迟模式在两个数据包之间不回退为阻塞等待
+    const bool blockingOk = RunMode(false, port, count, intervalMicroseconds, spinBudget);
+    const bool busyPollOk = RunMode(true, port, count, intervalMicroseconds, spinBudget);
+    return blockingOk && busyPollOk ? 0 : 1;
+}
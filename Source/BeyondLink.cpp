@@ -7,6 +7,7 @@
 //==============================================================================
 
 #include "BeyondLink.h"
+#include <algorithm>
 #include <iostream>
 
 namespace BeyondLink {
@@ -57,15 +58,27 @@ bool BeyondLinkSystem::Initialize(HWND hwnd) {
     // 创建网络协议处理器
     m_Protocol = std::make_unique<Core::LaserProtocol>(m_Settings);
     
-    // 设置数据回调
-    m_Protocol->SetDataCallback([this](int deviceID, const std::vector<Core::LaserPoint>& points) {
-        OnLaserDataReceived(deviceID, points);
+    // 设置目标激光源查找（解码器直接写入激光源接收缓冲）
+    m_Protocol->SetSourceResolver([this](int deviceID, int subnetID) {
+        return ResolveInboundSource(deviceID, subnetID);
     });
 
+    // 工作线程池：常驻线程，处理期间不再创建线程
+    if (m_Settings.EnableParallelProcessing || m_Settings.ParallelScannerSimulation) {
+        m_WorkerPool = std::make_unique<Core::WorkerPool>(
+            Core::WorkerPool::GetDefaultWorkerCount(m_Settings.WorkerThreadCount));
+    }
+
     // 为所有设备创建激光源
     for (int i = 0; i < m_Settings.MaxLaserDevices; ++i) {
         EnsureLaserSource(i);
     }
+    
+    // 区域流模式：预留扁平索引表，区域流在首次收到数据时创建
+    if (m_Settings.EnableZoneStreams) {
+        std::lock_guard<std::mutex> lock(m_SourcesMutex);
+        m_ZoneStreams.assign(static_cast<size_t>(m_Settings.MaxLaserDevices) * Core::LaserProtocol::SubnetCount, nullptr);
+    }
 
     m_Initialized = true;
     std::cout << "BeyondLink System initialized successfully" << std::endl;
@@ -73,6 +86,13 @@ bool BeyondLinkSystem::Initialize(HWND hwnd) {
     std::cout << "- Network Port: " << m_Settings.NetworkPort << std::endl;
     std::cout << "- Texture Size: " << m_Settings.TextureSize << std::endl;
     std::cout << "- Scanner Simulation: " << (m_Settings.ScannerSimulation ? "Enabled" : "Disabled") << std::endl;
+    if (m_WorkerPool) {
+        std::cout << "- Worker Threads: " << m_WorkerPool->GetConcurrency() - 1
+                  << (m_Settings.EnableParallelProcessing ? " (parallel device update)" : "") << std::endl;
+    }
+    if (m_Settings.EnableZoneStreams) {
+        std::cout << "- Zone Streams: Enabled (" << (m_Settings.CompositeZoneStreams ? "composited per device" : "separate textures") << ")" << std::endl;
+    }
     
     return true;
 }
@@ -95,6 +115,8 @@ void BeyondLinkSystem::Shutdown() {
     {
         std::lock_guard<std::mutex> lock(m_SourcesMutex);
         m_LaserSources.clear();
+        m_ZoneStreams.clear();
+        m_PendingZoneStreams.clear();
     }
 
     // 关闭渲染器
@@ -105,6 +127,10 @@ void BeyondLinkSystem::Shutdown() {
 
     // 清理协议处理器
     m_Protocol.reset();
+    
+    // 停止工作线程（激光源已清理，不再有引用）
+    m_UpdateQueue.clear();
+    m_WorkerPool.reset();
 
     m_Initialized = false;
     std::cout << "BeyondLink System shutdown complete" << std::endl;
@@ -164,22 +190,138 @@ void BeyondLinkSystem::StopNetworkReceiver() {
 //==========================================================================
 // 函数：Update
 // 描述：更新所有激光源的点数据处理（应用扫描仪模拟等）
+//       激光源列表在锁内取快照，处理期间不持有 m_SourcesMutex，接收线程可继续解码
+//       EnableParallelProcessing 时各激光源在线程池上并行处理，主线程只在结束时同步
 //==========================================================================
 void BeyondLinkSystem::Update() {
     if (!m_Initialized) {
         return;
     }
 
-    // 更新所有激光源的点数据处理
-    std::lock_guard<std::mutex> lock(m_SourcesMutex);
-    for (auto& pair : m_LaserSources) {
-        auto& source = pair.second;
-        if (source) {
-            source->UpdatePointList(m_Settings.ScannerSimulation);
+    {
+        std::lock_guard<std::mutex> lock(m_SourcesMutex);
+        RegisterPendingZoneStreams();
+        
+        m_UpdateQueue.clear();
+        for (auto& pair : m_LaserSources) {
+            if (pair.second) {
+                m_UpdateQueue.emplace_back(pair.second->GetInputPointCount(), pair.second);
+            }
+        }
+        AllocatePointBudget();
+    }
+
+    const bool scannerSimulation = m_Settings.ScannerSimulation;
+    if (m_Settings.EnableParallelProcessing && m_WorkerPool && m_UpdateQueue.size() > 1) {
+        // 点数多的激光源排在前面，各线程先拿到重任务，剩余负载由工作窃取平衡
+        std::sort(m_UpdateQueue.begin(), m_UpdateQueue.end(),
+                  [](const auto& a, const auto& b) { return a.first > b.first; });
+        
+        // 达到分块阈值的大帧逐个在主线程处理，帧内分块独占线程池
+        // （嵌套的 ParallelFor 会串行执行，放进设备并行里反而失去帧内并行）
+        size_t chunkedCount = 0;
+        if (m_Settings.ParallelScannerSimulation) {
+            const size_t sampleFactor = static_cast<size_t>((std::max)(1, m_Settings.SampleCount));
+            const size_t minSamples = static_cast<size_t>((std::max)(0, m_Settings.ParallelScanMinSamples));
+            while (chunkedCount < m_UpdateQueue.size() &&
+                   m_UpdateQueue[chunkedCount].first * sampleFactor >= minSamples) {
+                m_UpdateQueue[chunkedCount].second->UpdatePointList(scannerSimulation);
+                ++chunkedCount;
+            }
+        }
+        m_WorkerPool->ParallelFor(m_UpdateQueue.size() - chunkedCount,
+                                  [this, scannerSimulation, chunkedCount](size_t index) {
+            m_UpdateQueue[chunkedCount + index].second->UpdatePointList(scannerSimulation);
+        });
+    } else {
+        for (auto& entry : m_UpdateQueue) {
+            entry.second->UpdatePointList(scannerSimulation);
         }
     }
 }
 
+//==========================================================================
+// 函数：AllocatePointBudget
+// 描述：加权注水分配：比例系数 λ = 剩余预算 / Σ(优先级 × 需求)，
+//       λ × 优先级 ≥ 1 的激光源按需求满额分配并从剩余预算中扣除，重复直到没有满额的激光源，
+//       其余激光源分得 λ × 优先级 × 需求（至少 1 点，必须保留的点仍会输出）
+//       需求取上一次处理抽取前的主点数，尚未处理过时以原始点数估计
+//==========================================================================
+void BeyondLinkSystem::AllocatePointBudget() {
+    const size_t budget = static_cast<size_t>((std::max)(0, m_Settings.FramePointBudget));
+    
+    size_t totalDemand = 0;
+    m_BudgetDemands.clear();
+    for (const auto& entry : m_UpdateQueue) {
+        const size_t demand = entry.second->GetPointDemand();
+        m_BudgetDemands.push_back(demand > 0 ? demand : entry.first);
+        totalDemand += m_BudgetDemands.back();
+    }
+    if (budget == 0 || totalDemand <= budget) {
+        for (auto& entry : m_UpdateQueue) {
+            entry.second->SetPointBudget(0);
+        }
+        return;
+    }
+    
+    // 权重 = 优先级 × 需求，满额分配后权重置为 -1
+    m_BudgetWeights.clear();
+    for (size_t i = 0; i < m_UpdateQueue.size(); ++i) {
+        int deviceID = m_UpdateQueue[i].second->GetDeviceID();
+        if (deviceID >= ZoneStreamIDBase) {
+            deviceID = (deviceID - ZoneStreamIDBase) / Core::LaserProtocol::SubnetCount;
+        }
+        auto it = m_DevicePriorities.find(deviceID);
+        const double priority = it != m_DevicePriorities.end() ? it->second : 1.0;
+        m_BudgetWeights.push_back(priority * static_cast<double>(m_BudgetDemands[i]));
+    }
+    
+    double remaining = static_cast<double>(budget);
+    double scale = 0.0;
+    bool capped = true;
+    while (capped) {
+        capped = false;
+        double totalWeight = 0.0;
+        for (double weight : m_BudgetWeights) {
+            totalWeight += (std::max)(0.0, weight);
+        }
+        if (!(totalWeight > 0.0)) {
+            scale = 0.0;
+            break;
+        }
+        scale = remaining / totalWeight;
+        for (size_t i = 0; i < m_UpdateQueue.size(); ++i) {
+            const double demand = static_cast<double>(m_BudgetDemands[i]);
+            if (m_BudgetWeights[i] > 0.0 && scale * m_BudgetWeights[i] >= demand) {
+                remaining -= demand;
+                m_BudgetWeights[i] = -1.0;
+                capped = true;
+            }
+        }
+    }
+    
+    for (size_t i = 0; i < m_UpdateQueue.size(); ++i) {
+        if (m_BudgetWeights[i] < 0.0 || m_BudgetDemands[i] == 0) {
+            m_UpdateQueue[i].second->SetPointBudget(0);
+        } else {
+            const size_t share = static_cast<size_t>(scale * m_BudgetWeights[i]);
+            m_UpdateQueue[i].second->SetPointBudget((std::max)(static_cast<size_t>(1), share));
+        }
+    }
+}
+
+//==========================================================================
+// 函数：SetDevicePriority
+// 描述：设置设备的点数预算优先级（负值按 0 处理）
+// 参数：
+//   deviceID - 设备 ID
+//   priority - 优先级
+//==========================================================================
+void BeyondLinkSystem::SetDevicePriority(int deviceID, float priority) {
+    std::lock_guard<std::mutex> lock(m_SourcesMutex);
+    m_DevicePriorities[deviceID] = (std::max)(0.0f, priority);
+}
+
 //==========================================================================
 // 函数：Render
 // 描述：渲染所有激光源到各自的纹理
@@ -242,22 +384,143 @@ Core::LaserProtocol::NetworkStats BeyondLinkSystem::GetNetworkStats() const {
 }
 
 //==========================================================================
-// 函数：OnLaserDataReceived
-// 描述：网络数据接收回调函数，将接收到的点数据传递给对应的激光源
+// 函数：GetLatencyStats
+// 描述：获取网络接收到分发的延迟直方图
+// 返回值：
+//   LatencyStats - 延迟统计结构体
+//==========================================================================
+Core::LaserProtocol::LatencyStats BeyondLinkSystem::GetLatencyStats() const {
+    if (m_Protocol) {
+        return m_Protocol->GetLatencyStats();
+    }
+    return Core::LaserProtocol::LatencyStats();
+}
+
+//==========================================================================
+// 函数：GetFrameCacheStats
+// 描述：汇总所有激光源（含区域流）的帧缓存统计
+// 返回值：
+//   FrameCacheStats - 帧缓存统计结构体
+//==========================================================================
+Core::FrameCacheStats BeyondLinkSystem::GetFrameCacheStats() {
+    std::lock_guard<std::mutex> lock(m_SourcesMutex);
+    
+    Core::FrameCacheStats total;
+    for (const auto& pair : m_LaserSources) {
+        total.Merge(pair.second->GetFrameCacheStats());
+    }
+    return total;
+}
+
+//==========================================================================
+// 函数：GetArenaPeakBytes
+// 描述：汇总所有激光源（含区域流）帧内存池的单帧峰值
+// 返回值：
+//   size_t - 峰值字节数之和
+//==========================================================================
+size_t BeyondLinkSystem::GetArenaPeakBytes() {
+    std::lock_guard<std::mutex> lock(m_SourcesMutex);
+    
+    size_t total = 0;
+    for (const auto& pair : m_LaserSources) {
+        total += pair.second->GetArenaPeakBytes();
+    }
+    return total;
+}
+
+//==========================================================================
+// 函数：GetPipelineStats
+// 描述：汇总所有激光源（含区域流）的扫描仪模拟处理统计
+// 返回值：
+//   ScannerPipelineStats - 处理统计结构体
+//==========================================================================
+Core::ScannerPipelineStats BeyondLinkSystem::GetPipelineStats() {
+    std::lock_guard<std::mutex> lock(m_SourcesMutex);
+    
+    Core::ScannerPipelineStats total;
+    for (const auto& pair : m_LaserSources) {
+        total.Merge(pair.second->GetPipelineStats());
+    }
+    return total;
+}
+
+//==========================================================================
+// 函数：GetDevicePointCount
+// 描述：获取设备的处理后点数量，区域流模式下累加该设备所有区域流
+// 参数：
+//   deviceID - 设备ID
+// 返回值：
+//   size_t - 点数量
+//==========================================================================
+size_t BeyondLinkSystem::GetDevicePointCount(int deviceID) {
+    std::lock_guard<std::mutex> lock(m_SourcesMutex);
+    
+    size_t count = 0;
+    auto it = m_LaserSources.find(deviceID);
+    if (it != m_LaserSources.end()) {
+        count += it->second->GetPointCount();
+    }
+    
+    if (deviceID >= 0 && deviceID < m_Settings.MaxLaserDevices && !m_ZoneStreams.empty()) {
+        size_t base = static_cast<size_t>(deviceID) * Core::LaserProtocol::SubnetCount;
+        for (int subnet = 0; subnet < Core::LaserProtocol::SubnetCount; ++subnet) {
+            const auto& stream = m_ZoneStreams[base + subnet];
+            if (stream) {
+                count += stream->GetPointCount();
+            }
+        }
+    }
+    return count;
+}
+
+//==========================================================================
+// 函数：GetActiveZoneCount
+// 描述：统计设备已创建（收到过数据）的区域流数量
+// 参数：
+//   deviceID - 设备ID
+// 返回值：
+//   int - 区域流数量
+//==========================================================================
+int BeyondLinkSystem::GetActiveZoneCount(int deviceID) {
+    std::lock_guard<std::mutex> lock(m_SourcesMutex);
+    
+    if (deviceID < 0 || deviceID >= m_Settings.MaxLaserDevices || m_ZoneStreams.empty()) {
+        return 0;
+    }
+    
+    int active = 0;
+    size_t base = static_cast<size_t>(deviceID) * Core::LaserProtocol::SubnetCount;
+    for (int subnet = 0; subnet < Core::LaserProtocol::SubnetCount; ++subnet) {
+        if (m_ZoneStreams[base + subnet]) {
+            active++;
+        }
+    }
+    return active;
+}
+
+//==========================================================================
+// 函数：ResolveInboundSource
+// 描述：为接收线程查找数据包的目标激光源，解码器随后直接写入其接收缓冲
+//       区域流模式下按（设备, 子网）扁平索引查找独立激光源
+//       激光源由 m_LaserSources 持有，Shutdown 先停止网络再清理，返回的裸指针在接收期间有效
 // 参数：
 //   deviceID - 设备ID
-//   points - 激光点数据列表
+//   subnetID - 子网ID（未知时为-1）
+// 返回值：
+//   目标激光源指针，找不到时返回nullptr
 //==========================================================================
-void BeyondLinkSystem::OnLaserDataReceived(int deviceID, const std::vector<Core::LaserPoint>& points) {
+Core::LaserSource* BeyondLinkSystem::ResolveInboundSource(int deviceID, int subnetID) {
+    if (m_Settings.EnableZoneStreams && subnetID >= 0) {
+        std::lock_guard<std::mutex> lock(m_SourcesMutex);
+        return GetZoneStream(deviceID, subnetID).get();
+    }
+    
     // 确保激光源存在
     EnsureLaserSource(deviceID);
 
-    // 更新激光源的点数据
     std::lock_guard<std::mutex> lock(m_SourcesMutex);
     auto it = m_LaserSources.find(deviceID);
-    if (it != m_LaserSources.end()) {
-        it->second->SetPointList(points);
-    }
+    return it != m_LaserSources.end() ? it->second.get() : nullptr;
 }
 
 //==========================================================================
@@ -272,6 +535,7 @@ void BeyondLinkSystem::EnsureLaserSource(int deviceID) {
     if (m_LaserSources.find(deviceID) == m_LaserSources.end()) {
         // 创建新的激光源
         auto source = std::make_shared<Core::LaserSource>(deviceID, m_Settings);
+        source->SetWorkerPool(m_WorkerPool.get());
         m_LaserSources[deviceID] = source;
         
         // 添加到渲染器
@@ -283,4 +547,54 @@ void BeyondLinkSystem::EnsureLaserSource(int deviceID) {
     }
 }
 
+//==========================================================================
+// 函数：GetZoneStream
+// 描述：按扁平索引查找区域流激光源，首次访问时创建
+//       渲染器注册推迟到主线程，避免接收线程与渲染循环同时修改渲染资源
+// 参数：
+//   deviceID - 设备ID
+//   subnetID - 子网ID
+// 返回值：
+//   shared_ptr<LaserSource> - 区域流激光源，越界返回nullptr
+//==========================================================================
+std::shared_ptr<Core::LaserSource> BeyondLinkSystem::GetZoneStream(int deviceID, int subnetID) {
+    if (deviceID < 0 || deviceID >= m_Settings.MaxLaserDevices ||
+        subnetID < 0 || subnetID >= Core::LaserProtocol::SubnetCount ||
+        m_ZoneStreams.empty()) {
+        return nullptr;
+    }
+    
+    auto& stream = m_ZoneStreams[static_cast<size_t>(deviceID) * Core::LaserProtocol::SubnetCount + subnetID];
+    if (!stream) {
+        int streamID = GetZoneStreamID(deviceID, subnetID);
+        stream = std::make_shared<Core::LaserSource>(streamID, m_Settings);
+        stream->SetWorkerPool(m_WorkerPool.get());
+        m_LaserSources[streamID] = stream;
+        m_PendingZoneStreams.emplace_back(deviceID, stream);
+        
+        std::cout << "Created zone stream for device " << deviceID << " subnet " << subnetID << std::endl;
+    }
+    return stream;
+}
+
+//==========================================================================
+// 函数：RegisterPendingZoneStreams
+// 描述：将新建的区域流注册到渲染器
+//       合成模式下挂到设备纹理，否则以区域流ID创建独立纹理
+//==========================================================================
+void BeyondLinkSystem::RegisterPendingZoneStreams() {
+    if (m_PendingZoneStreams.empty() || !m_Renderer) {
+        return;
+    }
+    
+    for (auto& pending : m_PendingZoneStreams) {
+        if (m_Settings.CompositeZoneStreams) {
+            m_Renderer->AddCompositeSource(pending.first, pending.second);
+        } else {
+            m_Renderer->AddLaserSource(pending.second->GetDeviceID(), pending.second);
+        }
+    }
+    m_PendingZoneStreams.clear();
+}
+
 } // namespace BeyondLink
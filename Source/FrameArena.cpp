@@ -0,0 +1,139 @@
+﻿//==============================================================================
+// BeyondLink - Beyond激光可视化系统
+// 文件：FrameArena.cpp
+// 作者：Yunsio
+// 日期：2025-10-06
+// 描述：帧内存池实现，对齐线性分配与按峰值合并内存块
+//==============================================================================
+
+#include "FrameArena.h"
+#include <algorithm>
+#include <new>
+
+namespace BeyondLink {
+namespace Core {
+
+//==========================================================================
+// 构造函数：FrameArena
+// 描述：分配初始内存块
+// 参数：
+//   initialBytes - 初始块大小
+//==========================================================================
+FrameArena::FrameArena(size_t initialBytes)
+    : m_Offset(0)
+    , m_UsedBytes(0)
+    , m_PeakBytes(0)
+{
+    AddBlock(initialBytes);
+}
+
+//==========================================================================
+// 析构函数：~FrameArena
+// 描述：释放所有内存块
+//==========================================================================
+FrameArena::~FrameArena() {
+    ReleaseBlocks();
+}
+
+//==========================================================================
+// 函数：Allocate
+// 描述：在当前块中按对齐移动偏移量，不足时追加新块
+// 参数：
+//   bytes - 字节数
+//   alignment - 对齐字节数
+// 返回值：
+//   void* - 内存首地址
+//==========================================================================
+void* FrameArena::Allocate(size_t bytes, size_t alignment) {
+    size_t aligned = (m_Offset + alignment - 1) & ~(alignment - 1);
+    
+    if (m_Blocks.empty() || aligned + bytes > m_Blocks.back().Size) {
+        // 新块按当前块大小翻倍增长，至少容纳本次请求
+        size_t current = m_Blocks.empty() ? 0 : m_Blocks.back().Size;
+        AddBlock((std::max)(bytes + alignment, current * 2));
+        aligned = 0;
+    }
+    
+    m_UsedBytes += (aligned - m_Offset) + bytes;
+    m_PeakBytes = (std::max)(m_PeakBytes, m_UsedBytes);
+    m_Offset = aligned + bytes;
+    return m_Blocks.back().Data + aligned;
+}
+
+//==========================================================================
+// 函数：AllocateFrame
+// 描述：分配 7 个对齐通道组成的帧视图
+// 参数：
+//   count - 点数量
+// 返回值：
+//   MutableFrameView - 可写帧视图
+//==========================================================================
+MutableFrameView FrameArena::AllocateFrame(size_t count) {
+    MutableFrameView view;
+    view.X = AllocateArray<float>(count);
+    view.Y = AllocateArray<float>(count);
+    view.R = AllocateArray<float>(count);
+    view.G = AllocateArray<float>(count);
+    view.B = AllocateArray<float>(count);
+    view.Z = AllocateArray<float>(count);
+    view.Focus = AllocateArray<float>(count);
+    view.Count = count;
+    return view;
+}
+
+//==========================================================================
+// 函数：Reset
+// 描述：重置偏移量；多块时合并为一个不小于峰值的块，下一帧不再溢出
+//==========================================================================
+void FrameArena::Reset() {
+    if (m_Blocks.size() > 1) {
+        size_t merged = (std::max)(GetCapacityBytes(), m_PeakBytes);
+        ReleaseBlocks();
+        AddBlock(merged);
+    }
+    m_Offset = 0;
+    m_UsedBytes = 0;
+}
+
+//==========================================================================
+// 函数：GetCapacityBytes
+// 描述：统计持有的内存块总大小
+// 返回值：
+//   size_t - 字节数
+//==========================================================================
+size_t FrameArena::GetCapacityBytes() const {
+    size_t total = 0;
+    for (const auto& block : m_Blocks) {
+        total += block.Size;
+    }
+    return total;
+}
+
+//==========================================================================
+// 函数：AddBlock
+// 描述：分配新的对齐内存块
+// 参数：
+//   minBytes - 最小字节数
+//==========================================================================
+void FrameArena::AddBlock(size_t minBytes) {
+    Block block;
+    block.Size = (std::max)(minBytes, static_cast<size_t>(DefaultAlignment));
+    block.Data = static_cast<uint8_t*>(::operator new(block.Size, std::align_val_t(DefaultAlignment)));
+    m_Blocks.push_back(block);
+    m_Offset = 0;
+}
+
+//==========================================================================
+// 函数：ReleaseBlocks
+// 描述：释放所有内存块
+//==========================================================================
+void FrameArena::ReleaseBlocks() {
+    for (auto& block : m_Blocks) {
+        ::operator delete(block.Data, std::align_val_t(DefaultAlignment));
+    }
+    m_Blocks.clear();
+    m_Offset = 0;
+}
+
+} // namespace Core
+} // namespace BeyondLink
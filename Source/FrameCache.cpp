@@ -0,0 +1,207 @@
+﻿//==============================================================================
+// BeyondLink - Beyond激光可视化系统
+// 文件：FrameCache.cpp
+// 作者：Yunsio
+// 日期：2025-10-06
+// 描述：激光帧缓存实现，帧内容哈希与有界 LRU 结果缓存
+//==============================================================================
+
+#include "FrameCache.h"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace BeyondLink {
+namespace Core {
+
+namespace {
+
+//==========================================================================
+// 函数：MixWord
+// 描述：64 位混合函数（splitmix64 终结步骤）
+//==========================================================================
+inline uint64_t MixWord(uint64_t value) {
+    value ^= value >> 30;
+    value *= 0xBF58476D1CE4E5B9ull;
+    value ^= value >> 27;
+    value *= 0x94D049BB133111EBull;
+    value ^= value >> 31;
+    return value;
+}
+
+//==========================================================================
+// 函数：RotateLeft
+// 描述：64 位循环左移
+//==========================================================================
+inline uint64_t RotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+} // namespace
+
+//==========================================================================
+// 构造函数：FrameCache
+// 描述：初始化缓存，预留索引空间
+// 参数：
+//   capacity - 最大缓存帧数
+//==========================================================================
+FrameCache::FrameCache(size_t capacity)
+    : m_Capacity((std::max)(capacity, static_cast<size_t>(1)))
+{
+    m_Index.reserve(m_Capacity);
+}
+
+//==========================================================================
+// 函数：Restore
+// 描述：查找缓存条目并取出处理结果（点列表共享，不拷贝）
+// 参数：
+//   key - 帧键
+//   processed - [输出] 主点列表
+//   beam - [输出] 光束点列表（条目未保存光束点时不变）
+//   hotBeams - [输出] 高强度光束游程
+//   pointDemand - [输出] 点预算抽取前的主点数
+// 返回值：
+//   true - 命中
+//   false - 未命中
+//==========================================================================
+bool FrameCache::Restore(uint64_t key,
+                         SharedFrame& processed,
+                         SharedFrame& beam,
+                         std::vector<HotBeamRun>& hotBeams,
+                         size_t& pointDemand) {
+    auto it = m_Index.find(key);
+    if (it == m_Index.end()) {
+        m_Stats.Misses++;
+        return false;
+    }
+    
+    // 移到最近使用位置
+    m_Entries.splice(m_Entries.begin(), m_Entries, it->second);
+    
+    const Entry& entry = *it->second;
+    processed = entry.Processed;
+    if (entry.Beam) {
+        beam = entry.Beam;
+    }
+    hotBeams.assign(entry.HotBeams.begin(), entry.HotBeams.end());
+    pointDemand = entry.PointDemand;
+    
+    m_Stats.Hits++;
+    return true;
+}
+
+//==========================================================================
+// 函数：Store
+// 描述：写入处理结果，已满时淘汰最久未使用的条目（其点列表在没有其他持有者时释放）
+// 参数：
+//   key - 帧键
+//   processed - 主点列表
+//   beam - 光束点列表（为空表示不保存）
+//   hotBeams - 高强度光束游程
+//   pointDemand - 点预算抽取前的主点数
+//==========================================================================
+void FrameCache::Store(uint64_t key,
+                       const SharedFrame& processed,
+                       const SharedFrame& beam,
+                       const std::vector<HotBeamRun>& hotBeams,
+                       size_t pointDemand) {
+    auto it = m_Index.find(key);
+    if (it == m_Index.end()) {
+        if (m_Entries.size() >= m_Capacity) {
+            // 淘汰最久未使用的条目，条目节点留给新条目
+            m_Index.erase(m_Entries.back().Key);
+            m_Entries.splice(m_Entries.begin(), m_Entries, std::prev(m_Entries.end()));
+        } else {
+            m_Entries.emplace_front();
+        }
+        it = m_Index.emplace(key, m_Entries.begin()).first;
+    } else {
+        m_Entries.splice(m_Entries.begin(), m_Entries, it->second);
+    }
+    
+    Entry& entry = *it->second;
+    entry.Key = key;
+    entry.Processed = processed;
+    entry.Beam = beam;
+    entry.HotBeams.assign(hotBeams.begin(), hotBeams.end());
+    entry.PointDemand = pointDemand;
+}
+
+//==========================================================================
+// 函数：Clear
+// 描述：清空所有缓存条目并释放内存
+//==========================================================================
+void FrameCache::Clear() {
+    m_Index.clear();
+    m_Entries.clear();
+}
+
+//==========================================================================
+// 函数：GetStats
+// 描述：获取统计信息，内存占用按各条目缓冲容量计算（光束点与主点共用的缓冲只计一次）
+// 返回值：
+//   FrameCacheStats - 统计信息
+//==========================================================================
+FrameCacheStats FrameCache::GetStats() const {
+    FrameCacheStats stats = m_Stats;
+    stats.Entries = m_Entries.size();
+    stats.MemoryBytes = 0;
+    for (const auto& entry : m_Entries) {
+        if (entry.Processed) {
+            stats.MemoryBytes += entry.Processed->GetMemoryBytes();
+        }
+        if (entry.Beam && entry.Beam != entry.Processed) {
+            stats.MemoryBytes += entry.Beam->GetMemoryBytes();
+        }
+        stats.MemoryBytes += entry.HotBeams.capacity() * sizeof(HotBeamRun);
+    }
+    return stats;
+}
+
+//==========================================================================
+// 函数：HashBytes
+// 描述：按 8 字节字计算数据块哈希，尾部不足 8 字节补零处理
+// 参数：
+//   data - 数据指针
+//   size - 字节数
+//   seed - 哈希种子
+// 返回值：
+//   uint64_t - 非零哈希值
+//==========================================================================
+uint64_t FrameCache::HashBytes(const void* data, size_t size, uint64_t seed) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint64_t hash = seed ^ (static_cast<uint64_t>(size) * 0x9E3779B97F4A7C15ull);
+    
+    size_t offset = 0;
+    for (; offset + 8 <= size; offset += 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes + offset, 8);
+        hash = RotateLeft(hash ^ (word * 0xBF58476D1CE4E5B9ull), 29) * 0x94D049BB133111EBull;
+    }
+    
+    if (offset < size) {
+        uint64_t word = 0;
+        std::memcpy(&word, bytes + offset, size - offset);
+        hash = RotateLeft(hash ^ (word * 0xBF58476D1CE4E5B9ull), 29) * 0x94D049BB133111EBull;
+    }
+    
+    hash = MixWord(hash);
+    return hash != 0 ? hash : 1;
+}
+
+//==========================================================================
+// 函数：CombineKey
+// 描述：组合帧内容哈希与处理参数签名
+// 参数：
+//   frameHash - 帧内容哈希
+//   salt - 处理参数签名
+// 返回值：
+//   uint64_t - 非零缓存键
+//==========================================================================
+uint64_t FrameCache::CombineKey(uint64_t frameHash, uint64_t salt) {
+    uint64_t key = MixWord(frameHash ^ (salt * 0x9E3779B97F4A7C15ull));
+    return key != 0 ? key : 1;
+}
+
+} // namespace Core
+} // namespace BeyondLink
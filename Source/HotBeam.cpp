@@ -0,0 +1,50 @@
+﻿//==============================================================================
+// BeyondLink - Beyond激光可视化系统
+// 文件：HotBeam.cpp
+// 作者：Yunsio
+// 日期：2025-10-06
+// 描述：高强度光束游程展开实现
+//==============================================================================
+
+#include "HotBeam.h"
+
+namespace BeyondLink {
+namespace Core {
+
+//==========================================================================
+// 函数：CountHotBeamPoints
+// 描述：累加各游程的重复次数
+// 参数：
+//   runs - 光束游程列表
+// 返回值：
+//   展开点数
+//==========================================================================
+size_t CountHotBeamPoints(const std::vector<HotBeamRun>& runs) {
+    size_t count = 0;
+    for (const HotBeamRun& run : runs) {
+        count += static_cast<size_t>((std::max)(0, run.RepeatCount));
+    }
+    return count;
+}
+
+//==========================================================================
+// 函数：ExpandHotBeams
+// 描述：按游程填充各通道，位置和颜色通道为常量填充，只有 Z 逐点计算
+// 参数：
+//   runs - 光束游程列表
+//   result - [输出] 展开后的点帧
+//==========================================================================
+void ExpandHotBeams(const std::vector<HotBeamRun>& runs, LaserFrame& result) {
+    result.Resize(CountHotBeamPoints(runs));
+    
+    MutableFrameView out = result.MutableView();
+    size_t k = 0;
+    for (const HotBeamRun& run : runs) {
+        for (int j = 0; j < run.RepeatCount; ++j, ++k) {
+            out.SetPoint(k, run.GetPoint(j));
+        }
+    }
+}
+
+} // namespace Core
+} // namespace BeyondLink
@@ -0,0 +1,215 @@
+﻿//==============================================================================
+// BeyondLink - Beyond激光可视化系统
+// 文件：LaserFrame.cpp
+// 作者：Yunsio
+// 日期：2025-10-06
+// 描述：激光帧数据容器实现，SoA 通道管理与 AoS 顶点转换
+//==============================================================================
+
+#include "LaserFrame.h"
+#include <atomic>
+
+namespace BeyondLink {
+namespace Core {
+
+//==========================================================================
+// 函数：Resize
+// 描述：调整所有通道的点数量
+// 参数：
+//   count - 新的点数量
+//==========================================================================
+void LaserFrame::Resize(size_t count) {
+    m_X.resize(count);
+    m_Y.resize(count);
+    m_R.resize(count);
+    m_G.resize(count);
+    m_B.resize(count);
+    m_Z.resize(count);
+    m_Focus.resize(count);
+}
+
+//==========================================================================
+// 函数：Reserve
+// 描述：为所有通道预留容量
+// 参数：
+//   count - 预留点数
+//==========================================================================
+void LaserFrame::Reserve(size_t count) {
+    m_X.reserve(count);
+    m_Y.reserve(count);
+    m_R.reserve(count);
+    m_G.reserve(count);
+    m_B.reserve(count);
+    m_Z.reserve(count);
+    m_Focus.reserve(count);
+}
+
+//==========================================================================
+// 函数：Clear
+// 描述：清空所有通道（保留容量）
+//==========================================================================
+void LaserFrame::Clear() {
+    m_X.clear();
+    m_Y.clear();
+    m_R.clear();
+    m_G.clear();
+    m_B.clear();
+    m_Z.clear();
+    m_Focus.clear();
+}
+
+//==========================================================================
+// 函数：Append
+// 描述：在末尾追加一个点
+// 参数：
+//   point - 激光点
+//==========================================================================
+void LaserFrame::Append(const LaserPoint& point) {
+    m_X.push_back(point.X);
+    m_Y.push_back(point.Y);
+    m_R.push_back(point.R);
+    m_G.push_back(point.G);
+    m_B.push_back(point.B);
+    m_Z.push_back(point.Z);
+    m_Focus.push_back(point.Focus);
+}
+
+//==========================================================================
+// 函数：View
+// 描述：获取只读视图
+// 返回值：
+//   FrameView - 各通道指针和点数量
+//==========================================================================
+FrameView LaserFrame::View() const {
+    FrameView view;
+    view.X = m_X.data();
+    view.Y = m_Y.data();
+    view.R = m_R.data();
+    view.G = m_G.data();
+    view.B = m_B.data();
+    view.Z = m_Z.data();
+    view.Focus = m_Focus.data();
+    view.Count = m_X.size();
+    return view;
+}
+
+//==========================================================================
+// 函数：MutableView
+// 描述：获取可写视图
+// 返回值：
+//   MutableFrameView - 各通道指针和点数量
+//==========================================================================
+MutableFrameView LaserFrame::MutableView() {
+    MutableFrameView view;
+    view.X = m_X.data();
+    view.Y = m_Y.data();
+    view.R = m_R.data();
+    view.G = m_G.data();
+    view.B = m_B.data();
+    view.Z = m_Z.data();
+    view.Focus = m_Focus.data();
+    view.Count = m_X.size();
+    return view;
+}
+
+//==========================================================================
+// 函数：Assign
+// 描述：从 AoS 点数组拆分到各通道
+// 参数：
+//   points - LaserPoint 数组
+//   count - 点数量
+//==========================================================================
+void LaserFrame::Assign(const LaserPoint* points, size_t count) {
+    Resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        m_X[i] = points[i].X;
+        m_Y[i] = points[i].Y;
+        m_R[i] = points[i].R;
+        m_G[i] = points[i].G;
+        m_B[i] = points[i].B;
+        m_Z[i] = points[i].Z;
+        m_Focus[i] = points[i].Focus;
+    }
+}
+
+//==========================================================================
+// 函数：AssignFrom
+// 描述：逐通道复制另一帧（assign 复用已有容量）
+// 参数：
+//   other - 源帧
+//==========================================================================
+void LaserFrame::AssignFrom(const LaserFrame& other) {
+    if (this == &other) {
+        return;
+    }
+    m_X.assign(other.m_X.begin(), other.m_X.end());
+    m_Y.assign(other.m_Y.begin(), other.m_Y.end());
+    m_R.assign(other.m_R.begin(), other.m_R.end());
+    m_G.assign(other.m_G.begin(), other.m_G.end());
+    m_B.assign(other.m_B.begin(), other.m_B.end());
+    m_Z.assign(other.m_Z.begin(), other.m_Z.end());
+    m_Focus.assign(other.m_Focus.begin(), other.m_Focus.end());
+}
+
+//==========================================================================
+// 函数：CopyTo
+// 描述：合并各通道为 AoS 顶点数组（渲染上传时调用）
+// 参数：
+//   points - 输出数组
+//==========================================================================
+void LaserFrame::CopyTo(LaserPoint* points) const {
+    const size_t count = Size();
+    for (size_t i = 0; i < count; ++i) {
+        LaserPoint& point = points[i];
+        point.X = m_X[i];
+        point.Y = m_Y[i];
+        point.R = m_R[i];
+        point.G = m_G[i];
+        point.B = m_B[i];
+        point.Z = m_Z[i];
+        point.Focus = m_Focus[i];
+    }
+}
+
+//==========================================================================
+// 函数：Swap
+// 描述：交换两帧的通道数组
+// 参数：
+//   other - 另一帧
+//==========================================================================
+void LaserFrame::Swap(LaserFrame& other) noexcept {
+    m_X.swap(other.m_X);
+    m_Y.swap(other.m_Y);
+    m_R.swap(other.m_R);
+    m_G.swap(other.m_G);
+    m_B.swap(other.m_B);
+    m_Z.swap(other.m_Z);
+    m_Focus.swap(other.m_Focus);
+}
+
+//==========================================================================
+// 函数：AcquireWritableFrame
+// 描述：唯一持有时复用缓冲，否则分配新缓冲并按旧帧大小预留容量
+//       共享帧均由此处以非 const 对象创建，唯一持有者写入是安全的
+// 参数：
+//   frame - [输入/输出] 共享帧
+// 返回值：
+//   LaserFrame& - 可写帧
+//==========================================================================
+LaserFrame& AcquireWritableFrame(SharedFrame& frame) {
+    if (frame && frame.use_count() == 1) {
+        // 与其他持有者释放引用时的递减同步，其读取先于此处的写入
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return const_cast<LaserFrame&>(*frame);
+    }
+    
+    auto writable = std::make_shared<LaserFrame>();
+    if (frame) {
+        writable->Reserve(frame->Size());
+    }
+    frame = writable;
+    return *writable;
+}
+
+} // namespace Core
+} // namespace BeyondLink
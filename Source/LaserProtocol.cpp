@@ -8,14 +8,82 @@
 //==============================================================================
 
 #include "LaserProtocol.h"
+#include "LaserSource.h"
 #include <iostream>
 #include <cstring>
 #include <sstream>
 #include <algorithm>
+#include <chrono>
+
+#ifdef _WIN32
+#include <intrin.h>   // For _mm_pause
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
+#include <sys/select.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>  // For _mm_pause
+#endif
+#endif
 
 namespace BeyondLink {
 namespace Core {
 
+namespace {
+
+//==========================================================================
+// 函数：SpinPause
+// 描述：自旋等待提示（x86 为 pause 指令，降低自旋对超线程兄弟核心和功耗的影响）
+//==========================================================================
+inline void SpinPause() {
+#if defined(_WIN32) || defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+//==========================================================================
+// 函数：ReadPacketClock
+// 描述：读取与内核接收时间戳同源的时钟
+//       Windows 为 QPC 计数（SIO_TIMESTAMPING），其他平台为 CLOCK_REALTIME 纳秒（SO_TIMESTAMPNS）
+//==========================================================================
+inline int64_t ReadPacketClock() {
+#ifdef _WIN32
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return now.QuadPart;
+#else
+    timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return static_cast<int64_t>(now.tv_sec) * 1000000000ll + now.tv_nsec;
+#endif
+}
+
+//==========================================================================
+// 函数：PacketClockToMicroseconds
+// 描述：将数据包时钟的差值换算为微秒（时钟回拨产生的负值按 0 计）
+//==========================================================================
+inline uint64_t PacketClockToMicroseconds(int64_t ticks) {
+    if (ticks <= 0) {
+        return 0;
+    }
+#ifdef _WIN32
+    static const int64_t frequency = []() {
+        LARGE_INTEGER value;
+        QueryPerformanceFrequency(&value);
+        return value.QuadPart;
+    }();
+    return static_cast<uint64_t>(ticks) * 1000000ull / static_cast<uint64_t>(frequency);
+#else
+    return static_cast<uint64_t>(ticks) / 1000ull;
+#endif
+}
+
+} // namespace
+
 //==========================================================================
 // 构造函数：LaserProtocol
 // 描述：初始化网络协议处理器，加载linetD2_x64.dll并获取函数指针
@@ -27,11 +95,6 @@ LaserProtocol::LaserProtocol(const LaserSettings& settings)
     , m_Port(settings.NetworkPort)
     , m_MaxDevices(settings.MaxLaserDevices)
     , m_Running(false)
-    , m_DllHandle(nullptr)
-    , m_InitDll(nullptr)
-    , m_ReadLaserData(nullptr)
-    , m_GetData(nullptr)
-    , m_Release(nullptr)
 {
 #ifdef _WIN32
     m_Socket = INVALID_SOCKET;
@@ -165,7 +228,7 @@ bool LaserProtocol::CreateSocket() {
     addr.sin_port = htons(m_Port);
     addr.sin_addr.s_addr = INADDR_ANY;
 
-    if (bind(m_Socket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+    if (::bind(m_Socket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
 #ifdef _WIN32
         std::cerr << "Bind failed: " << WSAGetLastError() << std::endl;
 #else
@@ -180,6 +243,39 @@ bool LaserProtocol::CreateSocket() {
     setsockopt(m_Socket, SOL_SOCKET, SO_RCVBUF, 
                reinterpret_cast<const char*>(&bufferSize), sizeof(bufferSize));
 
+    // 内核接收时间戳：延迟统计从数据包到达计时，而不是从取出时计时
+    if (!EnableReceiveTimestamps()) {
+        std::cerr << "Receive timestamps not available, latency is measured from dequeue" << std::endl;
+    }
+
+    // 低延迟模式：切换为非阻塞 socket，由接收线程自旋轮询
+    if (m_Settings.LowLatencyReceive) {
+#ifdef _WIN32
+        u_long nonBlocking = 1;
+        if (ioctlsocket(m_Socket, FIONBIO, &nonBlocking) != 0) {
+            std::cerr << "Failed to set non-blocking mode: " << WSAGetLastError() << std::endl;
+            CloseSocket();
+            return false;
+        }
+#else
+        int flags = fcntl(m_Socket, F_GETFL, 0);
+        if (flags < 0 || fcntl(m_Socket, F_SETFL, flags | O_NONBLOCK) < 0) {
+            std::cerr << "Failed to set non-blocking mode" << std::endl;
+            CloseSocket();
+            return false;
+        }
+#ifdef SO_BUSY_POLL
+        // 让内核在 recv 时直接轮询网卡队列（需要 CAP_NET_ADMIN，失败不影响接收）
+        int busyPoll = m_Settings.BusyPollBudgetMicroseconds;
+        if (setsockopt(m_Socket, SOL_SOCKET, SO_BUSY_POLL, &busyPoll, sizeof(busyPoll)) < 0) {
+            std::cerr << "SO_BUSY_POLL not available, falling back to user-space spin" << std::endl;
+        }
+#endif
+#endif
+        std::cout << "Low-latency receive enabled (spin budget " 
+                  << m_Settings.BusyPollBudgetMicroseconds << " us)" << std::endl;
+    }
+
 #ifdef _WIN32
     // 启用 IP_PKTINFO 以获取目标地址信息（关键！）
     DWORD optval = 1;
@@ -195,6 +291,30 @@ bool LaserProtocol::CreateSocket() {
     return true;
 }
 
+//==========================================================================
+// 函数：EnableReceiveTimestamps
+// 描述：请求内核为接收的数据包附加到达时间戳
+//       Windows 10 1809 起支持 SIO_TIMESTAMPING（QPC 计数），Linux 使用 SO_TIMESTAMPNS（CLOCK_REALTIME）
+// 返回值：
+//   true - 已启用
+//   false - 平台不支持，延迟统计从取出数据包时计时
+//==========================================================================
+bool LaserProtocol::EnableReceiveTimestamps() {
+#if defined(_WIN32) && defined(SIO_TIMESTAMPING)
+    TIMESTAMPING_CONFIG config;
+    std::memset(&config, 0, sizeof(config));
+    config.Flags = TIMESTAMPING_FLAG_RX;
+    DWORD bytes = 0;
+    return WSAIoctl(m_Socket, SIO_TIMESTAMPING, &config, sizeof(config),
+                    nullptr, 0, &bytes, nullptr, nullptr) == 0;
+#elif defined(SO_TIMESTAMPNS)
+    int enable = 1;
+    return setsockopt(m_Socket, SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable)) == 0;
+#else
+    return false;
+#endif
+}
+
 //==========================================================================
 // 函数：GetMulticastAddress
 // 描述：生成多播地址字符串（格式：239.255.{deviceID}.{subnetID}）
@@ -225,7 +345,7 @@ bool LaserProtocol::JoinMulticastGroups(const std::string& localIP) {
     
     // 为每个设备的所有子网加入多播组
     for (int deviceID = 0; deviceID < m_MaxDevices; ++deviceID) {
-        for (int subnetID = 0; subnetID <= 30; ++subnetID) {
+        for (int subnetID = 0; subnetID < SubnetCount; ++subnetID) {
             std::string multicastAddr = GetMulticastAddress(deviceID, subnetID);
             
             ip_mreq mreq;
@@ -280,14 +400,14 @@ void LaserProtocol::LeaveMulticastGroups() {
 //==========================================================================
 void LaserProtocol::CloseSocket() {
 #ifdef _WIN32
-    if (m_Socket != INVALID_SOCKET) {
-        closesocket(m_Socket);
-        m_Socket = INVALID_SOCKET;
+    const SOCKET socketHandle = m_Socket.exchange(INVALID_SOCKET);
+    if (socketHandle != INVALID_SOCKET) {
+        closesocket(socketHandle);
     }
 #else
-    if (m_Socket >= 0) {
-        close(m_Socket);
-        m_Socket = -1;
+    const int socketHandle = m_Socket.exchange(-1);
+    if (socketHandle >= 0) {
+        close(socketHandle);
     }
 #endif
 }
@@ -324,6 +444,13 @@ bool LaserProtocol::Start(const std::string& localIP) {
         return false;
     }
     
+    // 重置延迟统计
+    {
+        std::lock_guard<std::mutex> lock(m_StatsMutex);
+        m_LatencyStats = LatencyStats();
+        m_LatencyStats.BusyPollMode = m_Settings.LowLatencyReceive;
+    }
+    
     // 启动接收线程
     m_Running = true;
     m_ReceiveThread = std::thread(&LaserProtocol::ReceiveThread, this);
@@ -349,7 +476,13 @@ void LaserProtocol::Stop() {
     // 2. 关闭socket，这会立即中断阻塞的接收调用（WSARecvMsg等）
     //    关闭socket时，操作系统会自动离开所有多播组
     //    这使得接收线程能够快速退出循环
+    //    Linux 上 close 不会唤醒阻塞在 recvmsg/select 中的线程：shutdown 使其立即返回，
+    //    等接收线程退出后再关闭，避免线程使用已被复用的描述符
+#ifdef _WIN32
     CloseSocket();
+#else
+    shutdown(m_Socket, SHUT_RDWR);
+#endif
     
     // 3. 等待接收线程结束（现在应该很快返回，因为socket已关闭）
     if (m_ReceiveThread.joinable()) {
@@ -357,6 +490,9 @@ void LaserProtocol::Stop() {
         m_ReceiveThread.join();
         std::cout << "Receive thread exited" << std::endl;
     }
+#ifndef _WIN32
+    CloseSocket();
+#endif
     
     // 4. 清空多播组列表（socket已关闭，无需显式离开）
     m_JoinedGroups.clear();
@@ -371,18 +507,22 @@ void LaserProtocol::Stop() {
 // 函数：ReceiveThread
 // 描述：网络接收线程，使用WSARecvMsg接收UDP数据包并提取目标地址
 //       通过IP_PKTINFO控制消息获取目标多播地址，从而识别设备ID
+//       控制消息中的内核接收时间戳作为延迟统计的起点
 //==========================================================================
 void LaserProtocol::ReceiveThread() {
     const size_t MaxPacketSize = 65536;
     std::vector<uint8_t> buffer(MaxPacketSize);
     
+    // 句柄在线程启动前创建，Stop 关闭 socket 时不再读取成员
+    const auto socketHandle = m_Socket.load();
+    
 #ifdef _WIN32
     // 获取 WSARecvMsg 函数指针
     LPFN_WSARECVMSG WSARecvMsgFunc = nullptr;
     GUID WSARecvMsg_GUID = WSAID_WSARECVMSG;
     DWORD dwBytes = 0;
     
-    if (WSAIoctl(m_Socket, SIO_GET_EXTENSION_FUNCTION_POINTER,
+    if (WSAIoctl(socketHandle, SIO_GET_EXTENSION_FUNCTION_POINTER,
                  &WSARecvMsg_GUID, sizeof(WSARecvMsg_GUID),
                  &WSARecvMsgFunc, sizeof(WSARecvMsgFunc),
                  &dwBytes, nullptr, nullptr) != 0) {
@@ -392,6 +532,13 @@ void LaserProtocol::ReceiveThread() {
     std::cout << "WSARecvMsg function loaded successfully" << std::endl;
 #endif
     
+    // 低延迟模式的自旋状态
+    const bool busyPoll = m_Settings.LowLatencyReceive;
+    const auto spinBudget = std::chrono::microseconds((std::max)(0, m_Settings.BusyPollBudgetMicroseconds));
+    auto spinStart = std::chrono::steady_clock::now();
+    bool spinning = false;
+    bool fromSpin = false;
+    
     while (m_Running) {
 #ifdef _WIN32
         // 准备接收缓冲区
@@ -420,17 +567,36 @@ void LaserProtocol::ReceiveThread() {
         
         // 接收数据包
         DWORD bytesReceived = 0;
-        int result = WSARecvMsgFunc(m_Socket, &msg, &bytesReceived, nullptr, nullptr);
+        int result = WSARecvMsgFunc(socketHandle, &msg, &bytesReceived, nullptr, nullptr);
         
         if (result != 0 || bytesReceived == 0) {
             int error = WSAGetLastError();
+            if (busyPoll && error == WSAEWOULDBLOCK) {
+                // 预算内继续自旋，耗尽后阻塞等待可读
+                auto now = std::chrono::steady_clock::now();
+                if (!spinning) {
+                    spinning = true;
+                    spinStart = now;
+                }
+                if (now - spinStart < spinBudget) {
+                    SpinPause();
+                } else {
+                    WaitForReadable(100);
+                    spinning = false;
+                }
+                continue;
+            }
             if (error != WSAEINTR && error != WSAEWOULDBLOCK && error != 0) {
                 std::cerr << "WSARecvMsg failed: " << error << std::endl;
             }
             continue;
         }
+        const int64_t dequeuedAt = ReadPacketClock();
+        int64_t arrivedAt = 0;
+        fromSpin = spinning;
+        spinning = false;
         
-        // 提取目标地址（从 IP_PKTINFO）
+        // 提取目标地址（从 IP_PKTINFO）和内核接收时间戳（QPC 计数）
         sockaddr_in destAddr;
         std::memset(&destAddr, 0, sizeof(destAddr));
         destAddr.sin_family = AF_INET;
@@ -439,38 +605,89 @@ void LaserProtocol::ReceiveThread() {
             if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_PKTINFO) {
                 IN_PKTINFO* pktInfo = reinterpret_cast<IN_PKTINFO*>(WSA_CMSG_DATA(cmsg));
                 destAddr.sin_addr = pktInfo->ipi_addr;
-                break;
             }
+#ifdef SIO_TIMESTAMPING
+            else if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_TIMESTAMP) {
+                UINT64 stamp = 0;
+                std::memcpy(&stamp, WSA_CMSG_DATA(cmsg), sizeof(stamp));
+                arrivedAt = static_cast<int64_t>(stamp);
+            }
+#endif
         }
         
-        // 从目标地址提取设备 ID
+        // 从目标地址提取设备 ID 和子网 ID
         int extractedDeviceID = -1;
+        int extractedSubnetID = -1;
         if (destAddr.sin_addr.s_addr != 0) {
             // 解析 239.255.X.Y 格式的地址
             unsigned char* addrBytes = reinterpret_cast<unsigned char*>(&destAddr.sin_addr.s_addr);
             if (addrBytes[0] == 239 && addrBytes[1] == 255) {
                 extractedDeviceID = addrBytes[2];  // 第三个字节是设备 ID
+                extractedSubnetID = addrBytes[3];  // 第四个字节是子网（投影区域）ID
             }
         }
         
 #else
         sockaddr_in fromAddr;
-        socklen_t fromLen = sizeof(fromAddr);
+        iovec iov;
+        iov.iov_base = buffer.data();
+        iov.iov_len = buffer.size();
+        
+        // 控制消息缓冲区（用于接收 SO_TIMESTAMPNS）
+        char controlBuf[256];
+        
+        msghdr msg;
+        std::memset(&msg, 0, sizeof(msg));
+        msg.msg_name = &fromAddr;
+        msg.msg_namelen = sizeof(fromAddr);
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = controlBuf;
+        msg.msg_controllen = sizeof(controlBuf);
         
-        int bytesReceived = recvfrom(m_Socket, 
-                                     reinterpret_cast<char*>(buffer.data()), 
-                                     static_cast<int>(buffer.size()),
-                                     0,
-                                     reinterpret_cast<sockaddr*>(&fromAddr),
-                                     &fromLen);
+        int bytesReceived = static_cast<int>(recvmsg(socketHandle, &msg, 0));
         
         if (bytesReceived <= 0) {
+            if (busyPoll && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                auto now = std::chrono::steady_clock::now();
+                if (!spinning) {
+                    spinning = true;
+                    spinStart = now;
+                }
+                if (now - spinStart < spinBudget) {
+                    SpinPause();
+                } else {
+                    WaitForReadable(100);
+                    spinning = false;
+                }
+            }
             continue;
         }
+        const int64_t dequeuedAt = ReadPacketClock();
+        int64_t arrivedAt = 0;
+        fromSpin = spinning;
+        spinning = false;
+        
+#ifdef SO_TIMESTAMPNS
+        for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+                timespec stamp;
+                std::memcpy(&stamp, CMSG_DATA(cmsg), sizeof(stamp));
+                arrivedAt = static_cast<int64_t>(stamp.tv_sec) * 1000000000ll + stamp.tv_nsec;
+            }
+        }
+#endif
         
         int extractedDeviceID = -1; // Linux 需要其他方法
+        int extractedSubnetID = -1;
 #endif
         
+        // 没有内核时间戳时从取出数据包的时刻计时（不含唤醒延迟）
+        const bool stamped = arrivedAt != 0;
+        if (!stamped) {
+            arrivedAt = dequeuedAt;
+        }
+        
         // 更新统计
         {
             std::lock_guard<std::mutex> lock(m_StatsMutex);
@@ -479,101 +696,201 @@ void LaserProtocol::ReceiveThread() {
             m_Stats.LastPacketSize = bytesReceived;
         }
         
-        // 解析数据包（传递提取的设备 ID）
-        int deviceID = -1;
-        std::vector<LaserPoint> points;
-        
-        if (ParsePacket(buffer.data(), bytesReceived, extractedDeviceID, deviceID, points)) {
-            // 调用数据回调
-            std::lock_guard<std::mutex> lock(m_CallbackMutex);
-            if (m_DataCallback) {
-                m_DataCallback(deviceID, points);
-            }
+        // 原地解码：直接写入目标激光源的接收缓冲
+        if (m_SourceResolver) {
+            DecodePacketInPlace(buffer.data(), bytesReceived, extractedDeviceID, extractedSubnetID);
         }
+        
+        // 记录到达到分发延迟
+        RecordLatency(PacketClockToMicroseconds(ReadPacketClock() - arrivedAt), fromSpin, stamped);
     }
 }
 
 //==========================================================================
-// 函数：ParsePacket
-// 描述：解析Beyond激光数据包，调用linetD2_x64.dll的ReadLaserData和GetData
-//       根据提取的设备ID获取对应设备的点数据
+// 函数：WaitForReadable
+// 描述：使用select阻塞等待socket可读，超时返回以便接收线程检查停止标志
+// 参数：
+//   timeoutMs - 超时时间（毫秒）
+// 返回值：
+//   true - socket可读
+//   false - 超时或socket已关闭
+//==========================================================================
+bool LaserProtocol::WaitForReadable(int timeoutMs) {
+    const auto socketHandle = m_Socket.load();
+#ifdef _WIN32
+    if (socketHandle == INVALID_SOCKET) {
+        return false;
+    }
+#else
+    if (socketHandle < 0 || socketHandle >= FD_SETSIZE) {
+        return false;
+    }
+#endif
+    
+    fd_set readSet;
+    FD_ZERO(&readSet);
+    FD_SET(socketHandle, &readSet);
+    
+    timeval timeout;
+    timeout.tv_sec = timeoutMs / 1000;
+    timeout.tv_usec = (timeoutMs % 1000) * 1000;
+    
+#ifdef _WIN32
+    int result = select(0, &readSet, nullptr, nullptr, &timeout);
+#else
+    int result = select(socketHandle + 1, &readSet, nullptr, nullptr, &timeout);
+#endif
+    if (result <= 0) {
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(m_StatsMutex);
+    m_LatencyStats.BlockingWakeups++;
+    return true;
+}
+
+//==========================================================================
+// 函数：RecordLatency
+// 描述：将一次到达到分发的延迟计入直方图
+// 参数：
+//   microseconds - 延迟（微秒）
+//   fromSpin - 是否在自旋阶段取得数据包
+//   stamped - 起点是否为内核接收时间戳
+//==========================================================================
+void LaserProtocol::RecordLatency(uint64_t microseconds, bool fromSpin, bool stamped) {
+    // 计算桶索引：floor(log2(us)) + 1，<1us 落入桶 0
+    int bucket = 0;
+    for (uint64_t value = microseconds; value > 0 && bucket < LatencyStats::BucketCount - 1; value >>= 1) {
+        bucket++;
+    }
+    
+    std::lock_guard<std::mutex> lock(m_StatsMutex);
+    m_LatencyStats.Buckets[bucket]++;
+    m_LatencyStats.Samples++;
+    m_LatencyStats.MaxMicroseconds = (std::max)(m_LatencyStats.MaxMicroseconds, microseconds);
+    if (fromSpin) {
+        m_LatencyStats.SpinReceives++;
+    }
+    if (!stamped) {
+        m_LatencyStats.UnstampedReceives++;
+    }
+}
+
+//==========================================================================
+// 函数：GetLatencyStats
+// 描述：获取接收到分发延迟统计的快照
+// 返回值：
+//   LatencyStats - 延迟统计结构体
+//==========================================================================
+LaserProtocol::LatencyStats LaserProtocol::GetLatencyStats() const {
+    std::lock_guard<std::mutex> lock(m_StatsMutex);
+    return m_LatencyStats;
+}
+
+//==========================================================================
+// 函数：DecodePacketInPlace
+// 描述：解析数据包并将点直接写入目标激光源的接收缓冲，写完后提交发布
 // 参数：
 //   data - UDP数据包内容
 //   length - 数据包长度
 //   extractedDeviceID - 从目标多播地址提取的设备ID
-//   deviceID - [输出] 实际解析到的设备ID
-//   points - [输出] 解析出的激光点列表
+//   extractedSubnetID - 从目标多播地址提取的子网ID
 // 返回值：
-//   true - 解析成功并获取到点数据
-//   false - 解析失败或无点数据
+//   true - 成功写入并发布
+//   false - 解析失败、无点数据或找不到目标激光源
 //==========================================================================
-bool LaserProtocol::ParsePacket(const uint8_t* data, size_t length, 
-                                int extractedDeviceID, int& deviceID, std::vector<LaserPoint>& points) {
+bool LaserProtocol::DecodePacketInPlace(uint8_t* data, size_t length,
+                                        int extractedDeviceID, int extractedSubnetID) {
     if (length == 0 || !m_ReadLaserData || !m_GetData) {
         return false;
     }
     
-    // 调用 ReadLaserData 解析数据包
-    std::vector<uint8_t> dataCopy(data, data + length);
-    m_ReadLaserData(dataCopy.data(), static_cast<int>(length));
+    m_ReadLaserData(data, static_cast<int>(length));
     
-    // 使用从网络层提取的设备 ID
-    if (extractedDeviceID >= 0 && extractedDeviceID < m_MaxDevices) {
-        int pointCount = 0;
-        void* pointDataPtr = m_GetData(extractedDeviceID, &pointCount);
-        
-        if (pointCount > 0 && pointDataPtr != nullptr) {
-            deviceID = extractedDeviceID;
-            
-            // 解析点数据
-            points.clear();
-            points.reserve(pointCount);
-            
-            const float* floatData = reinterpret_cast<const float*>(pointDataPtr);
-            
-            for (int i = 0; i < pointCount; ++i) {
-                // 读取位置和颜色（偏移 i*6）
-                float X = floatData[i * 6 + 0];
-                float Y = floatData[i * 6 + 1];
-                float Focus = floatData[i * 6 + 2];
-                float R = floatData[i * 6 + 3];
-                float G = floatData[i * 6 + 4];
-                float B = floatData[i * 6 + 5];
-                
-                // 归一化颜色值（0-255 → 0-1）
-                if (R > 1.0f || G > 1.0f || B > 1.0f) {
-                    R /= 255.0f;
-                    G /= 255.0f;
-                    B /= 255.0f;
-                }
-                
-                // Y轴反转
-                Y = -Y;
-                
-                // 颜色和Focus范围保护
-                R = (std::max)(0.0f, (std::min)(1.0f, R));
-                G = (std::max)(0.0f, (std::min)(1.0f, G));
-                B = (std::max)(0.0f, (std::min)(1.0f, B));
-                Focus = (std::max)(0.0f, (std::min)(255.0f, Focus)) / 255.0f;
-                
-                // 创建点（颜色属于前一个点）
-                LaserPoint point(X, Y, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
-                points.push_back(point);
-                
-                // 将颜色赋值给前一个点
-                if (i > 0) {
-                    points[points.size() - 2].R = R;
-                    points[points.size() - 2].G = G;
-                    points[points.size() - 2].B = B;
-                    points[points.size() - 2].Focus = Focus;
-                }
-            }
-            
+    if (extractedDeviceID < 0 || extractedDeviceID >= m_MaxDevices) {
+        return false;
+    }
+    
+    int pointCount = 0;
+    void* pointDataPtr = m_GetData(extractedDeviceID, &pointCount);
+    if (pointCount <= 0 || pointDataPtr == nullptr) {
+        return false;
+    }
+    
+    LaserSource* source = m_SourceResolver(extractedDeviceID, extractedSubnetID);
+    if (!source) {
+        return false;
+    }
+    
+    // 帧缓存：DLL 输出与当前帧相同（静态画面）时跳过转换和发布
+    // 启用状态取自激光源（运行时切换设置不会更新协议的配置副本）
+    uint64_t frameHash = 0;
+    if (source->IsFrameCacheEnabled()) {
+        frameHash = FrameCache::HashBytes(pointDataPtr, static_cast<size_t>(pointCount) * 6 * sizeof(float), 
+                                          DecodedFrameHashSeed);
+        if (source->IsCurrentFrame(frameHash)) {
             return true;
         }
     }
     
-    return false;
+    MutableFrameView inbound = source->BeginInboundFrame(static_cast<size_t>(pointCount));
+    ConvertPoints(reinterpret_cast<const float*>(pointDataPtr), pointCount, inbound);
+    source->CommitInboundFrame(frameHash);
+    return true;
+}
+
+//==========================================================================
+// 函数：ConvertPoints
+// 描述：将DLL输出的点数据转换到帧的各通道（Y轴反转、颜色归一化与范围保护）
+//       协议中颜色存储在当前点但属于前一个点，最后一个点保持黑色
+// 参数：
+//   floatData - DLL输出数据，每点6个float：X, Y, Focus, R, G, B
+//   pointCount - 点数量
+//   points - [输出] 目标帧视图
+//==========================================================================
+void LaserProtocol::ConvertPoints(const float* floatData, int pointCount, const MutableFrameView& points) {
+    for (int i = 0; i < pointCount; ++i) {
+        // 读取位置和颜色（偏移 i*6）
+        float X = floatData[i * 6 + 0];
+        float Y = floatData[i * 6 + 1];
+        float Focus = floatData[i * 6 + 2];
+        float R = floatData[i * 6 + 3];
+        float G = floatData[i * 6 + 4];
+        float B = floatData[i * 6 + 5];
+        
+        // 归一化颜色值（0-255 → 0-1）
+        if (R > 1.0f || G > 1.0f || B > 1.0f) {
+            R /= 255.0f;
+            G /= 255.0f;
+            B /= 255.0f;
+        }
+        
+        // Y轴反转
+        Y = -Y;
+        
+        // 颜色和Focus范围保护
+        R = (std::max)(0.0f, (std::min)(1.0f, R));
+        G = (std::max)(0.0f, (std::min)(1.0f, G));
+        B = (std::max)(0.0f, (std::min)(1.0f, B));
+        Focus = (std::max)(0.0f, (std::min)(255.0f, Focus)) / 255.0f;
+        
+        // 写入位置（颜色属于前一个点，当前点先置为黑色）
+        points.X[i] = X;
+        points.Y[i] = Y;
+        points.R[i] = 0.0f;
+        points.G[i] = 0.0f;
+        points.B[i] = 0.0f;
+        points.Z[i] = 0.0f;
+        points.Focus[i] = 0.0f;
+        
+        // 将颜色赋值给前一个点
+        if (i > 0) {
+            points.R[i - 1] = R;
+            points.G[i - 1] = G;
+            points.B[i - 1] = B;
+            points.Focus[i - 1] = Focus;
+        }
+    }
 }
 
 } // namespace Core
@@ -8,6 +8,7 @@
 //==============================================================================
 
 #include "LaserRenderer.h"
+#include "QuantizedPoint.h"
 #include <d3dcompiler.h>
 #include <iostream>
 #include <vector>
@@ -36,6 +37,7 @@ LaserRenderer::LaserRenderer(const Core::LaserSettings& settings)
     , m_VertexShader(nullptr)
     , m_PixelShader(nullptr)
     , m_InputLayout(nullptr)
+    , m_VertexStride(settings.QuantizedVertexUpload ? sizeof(Core::QuantizedVertex) : sizeof(Core::LaserPoint))
 {
 }
 
@@ -256,6 +258,30 @@ bool LaserRenderer::CompileShaders() {
         }
     )";
 
+    // 量化顶点版本（QuantizedVertex：SNORM16 位置，UNORM8 颜色/聚焦，增益与标志位）
+    const char* quantizedVsCode = R"(
+        struct VSInput {
+            float2 Position : POSITION;
+            float4 ColorFocus : COLOR;
+            uint2 Extra : TEXCOORD0;
+        };
+        
+        struct VSOutput {
+            float4 Position : SV_POSITION;
+            float3 Color : COLOR;
+            float Focus : TEXCOORD0;
+        };
+        
+        VSOutput main(VSInput input) {
+            VSOutput output;
+            float gain = (input.Extra.y & 1) ? 1.0 : 1.0 + input.Extra.x / 85.0;
+            output.Position = float4(input.Position, 0.0, 1.0);
+            output.Color = input.ColorFocus.rgb * gain;
+            output.Focus = input.ColorFocus.a;
+            return output;
+        }
+    )";
+
     const char* psCode = R"(
         struct PSInput {
             float4 Position : SV_POSITION;
@@ -273,6 +299,9 @@ bool LaserRenderer::CompileShaders() {
     HRESULT hr;
 
     // 编译顶点着色器
+    if (m_Settings.QuantizedVertexUpload) {
+        vsCode = quantizedVsCode;
+    }
     hr = D3DCompile(vsCode, strlen(vsCode), nullptr, nullptr, nullptr,
                     "main", "vs_5_0", 0, 0, &vsBlob, &errorBlob);
     
@@ -299,10 +328,24 @@ bool LaserRenderer::CompileShaders() {
         { "TEXCOORD", 0, DXGI_FORMAT_R32_FLOAT, 0, 24, D3D11_INPUT_PER_VERTEX_DATA, 0 },        // Focus at offset 24 (not 20!)
     };
 
-    hr = m_Device->CreateInputLayout(layout, ARRAYSIZE(layout),
-                                       vsBlob->GetBufferPointer(),
-                                       vsBlob->GetBufferSize(),
-                                       &m_InputLayout);
+    // 量化输入布局（QuantizedVertex = 12字节，所有元素4字节对齐）
+    D3D11_INPUT_ELEMENT_DESC quantizedLayout[] = {
+        { "POSITION", 0, DXGI_FORMAT_R16G16_SNORM, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },      // X, Y at offset 0
+        { "COLOR", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 0, 4, D3D11_INPUT_PER_VERTEX_DATA, 0 },      // R, G, B, Focus at offset 4
+        { "TEXCOORD", 0, DXGI_FORMAT_R8G8_UINT, 0, 8, D3D11_INPUT_PER_VERTEX_DATA, 0 },        // Extra, Flags at offset 8
+    };
+
+    if (m_Settings.QuantizedVertexUpload) {
+        hr = m_Device->CreateInputLayout(quantizedLayout, ARRAYSIZE(quantizedLayout),
+                                           vsBlob->GetBufferPointer(),
+                                           vsBlob->GetBufferSize(),
+                                           &m_InputLayout);
+    } else {
+        hr = m_Device->CreateInputLayout(layout, ARRAYSIZE(layout),
+                                           vsBlob->GetBufferPointer(),
+                                           vsBlob->GetBufferSize(),
+                                           &m_InputLayout);
+    }
     vsBlob->Release();
     if (FAILED(hr)) {
         return false;
@@ -349,6 +392,19 @@ void LaserRenderer::AddLaserSource(int deviceID, std::shared_ptr<Core::LaserSour
     }
 }
 
+void LaserRenderer::AddCompositeSource(int deviceID, std::shared_ptr<Core::LaserSource> source) {
+    auto it = m_SourceResources.find(deviceID);
+    if (it == m_SourceResources.end()) {
+        std::cerr << "Cannot composite source " << source->GetDeviceID() 
+                  << ": no render target for device " << deviceID << std::endl;
+        return;
+    }
+
+    it->second.CompositeSources.push_back(source);
+    it->second.RenderedSignature = 0;
+    std::cout << "Composited laser source " << source->GetDeviceID() << " into device " << deviceID << std::endl;
+}
+
 void LaserRenderer::RemoveLaserSource(int deviceID) {
     auto it = m_SourceResources.find(deviceID);
     if (it != m_SourceResources.end()) {
@@ -404,7 +460,7 @@ bool LaserRenderer::CreateSourceResources(int deviceID) {
     resources.VertexCapacity = 10000;
     D3D11_BUFFER_DESC vbDesc = {};
     vbDesc.Usage = D3D11_USAGE_DYNAMIC;
-    vbDesc.ByteWidth = static_cast<UINT>(resources.VertexCapacity * sizeof(Core::LaserPoint));
+    vbDesc.ByteWidth = static_cast<UINT>(resources.VertexCapacity * m_VertexStride);
     vbDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
     vbDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
 
@@ -443,27 +499,21 @@ void LaserRenderer::RenderAll() {
     }
 
     for (auto& pair : m_SourceResources) {
-        int deviceID = pair.first;
-        auto& resources = pair.second;
-        
-        if (resources.Source) {
-            RenderSource(deviceID, resources.Source.get());
-        }
+        RenderSource(pair.first);
     }
 }
 
 //==========================================================================
 // 函数：RenderSource
-// 描述：渲染单个激光源到其专用纹理
-//       - 上传顶点数据到动态顶点缓冲
-//       - 设置渲染目标为设备纹理
-//       - 清除为黑色
-//       - 使用加法混合绘制点云
+// 描述：渲染设备纹理：设备自身的激光源及合成到该纹理的区域流
+//       - 所有激光源输出代数未变化时跳过上传和绘制
+//       - 首个有点数据的激光源绑定并清除渲染目标
+//       - 每个激光源上传顶点数据后以加法混合绘制
+//       - 所有激光源都无数据时保留纹理原内容
 // 参数：
 //   deviceID - 设备ID
-//   source - 激光源对象指针
 //==========================================================================
-void LaserRenderer::RenderSource(int deviceID, Core::LaserSource* source) {
+void LaserRenderer::RenderSource(int deviceID) {
     auto it = m_SourceResources.find(deviceID);
     if (it == m_SourceResources.end()) {
         return;
@@ -471,81 +521,126 @@ void LaserRenderer::RenderSource(int deviceID, Core::LaserSource* source) {
 
     auto& resources = it->second;
     
-    // 获取处理后的点数据
-    std::lock_guard<std::mutex> lock(source->GetMutex());
-    const auto& points = source->GetProcessedPoints();
+    // 组合所有激光源的输出代数，未变化则纹理内容仍然有效
+    uint64_t signature = 1 + resources.CompositeSources.size();
+    if (resources.Source) {
+        signature = signature * 0x100000001B3ull + resources.Source->GetFrameGeneration();
+    }
+    for (auto& composite : resources.CompositeSources) {
+        signature = signature * 0x100000001B3ull + composite->GetFrameGeneration();
+    }
+    if (signature == resources.RenderedSignature) {
+        return;
+    }
+    resources.RenderedSignature = signature;
+    
+    bool targetBound = false;
+    ID3D11RenderTargetView* oldRTV = nullptr;
+    ID3D11DepthStencilView* oldDSV = nullptr;
+
+    if (resources.Source) {
+        DrawSourcePoints(deviceID, resources.Source.get(), targetBound, oldRTV, oldDSV);
+    }
+    for (auto& composite : resources.CompositeSources) {
+        DrawSourcePoints(deviceID, composite.get(), targetBound, oldRTV, oldDSV);
+    }
+
+    if (!targetBound) {
+        return;
+    }
+
+    // 生成Mipmap
+    if (m_Settings.EnableMipmaps) {
+        m_Context->GenerateMips(resources.SRV);
+    }
+
+    // 恢复渲染状态
+    if (oldRTV || oldDSV) {
+        ID3D11RenderTargetView* rtvs[] = { oldRTV };
+        m_Context->OMSetRenderTargets(1, oldRTV ? rtvs : nullptr, oldDSV);
+    }
+    if (oldRTV) oldRTV->Release();
+    if (oldDSV) oldDSV->Release();
+}
+
+//==========================================================================
+// 函数：DrawSourcePoints
+// 描述：绘制单个激光源的处理后点数据到设备纹理
+// 参数：
+//   deviceID - 设备ID
+//   source - 激光源对象指针
+//   targetBound - [输入/输出] 渲染目标是否已绑定
+//   oldRTV, oldDSV - [输出] 绑定前的渲染目标
+//==========================================================================
+void LaserRenderer::DrawSourcePoints(int deviceID, Core::LaserSource* source,
+                                     bool& targetBound,
+                                     ID3D11RenderTargetView*& oldRTV, ID3D11DepthStencilView*& oldDSV) {
+    auto& resources = m_SourceResources[deviceID];
+    
+    // 获取处理结果快照（无锁，上传和绘制期间处理线程可继续更新）
+    const Core::SharedSnapshot snapshot = source->GetSnapshot();
+    const Core::LaserFrame& points = *snapshot->Processed;
     
-    if (points.empty()) {
+    if (points.Empty()) {
         return;
     }
 
     // 上传顶点数据
     UploadVertexData(points, resources.VertexBuffer, resources.VertexCapacity);
 
-    // 保存当前渲染状态
-    ID3D11RenderTargetView* oldRTV = nullptr;
-    ID3D11DepthStencilView* oldDSV = nullptr;
-    m_Context->OMGetRenderTargets(1, &oldRTV, &oldDSV);
+    if (!targetBound) {
+        // 保存当前渲染状态
+        m_Context->OMGetRenderTargets(1, &oldRTV, &oldDSV);
 
-    // 设置渲染目标
-    ID3D11RenderTargetView* rtvs[] = { resources.RTV };
-    m_Context->OMSetRenderTargets(1, rtvs, nullptr);
+        // 设置渲染目标
+        ID3D11RenderTargetView* rtvs[] = { resources.RTV };
+        m_Context->OMSetRenderTargets(1, rtvs, nullptr);
 
-    // 清除渲染目标
-    float clearColor[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
-    m_Context->ClearRenderTargetView(resources.RTV, clearColor);
+        // 清除渲染目标
+        float clearColor[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        m_Context->ClearRenderTargetView(resources.RTV, clearColor);
 
-    // 设置视口
-    m_Context->RSSetViewports(1, &m_Viewport);
+        // 设置视口
+        m_Context->RSSetViewports(1, &m_Viewport);
 
-    // 设置渲染状态
-    m_Context->OMSetBlendState(m_AdditiveBlend, nullptr, 0xffffffff);
-    m_Context->OMSetDepthStencilState(m_NoDepthState, 0);
-    m_Context->RSSetState(m_NoCullingState);
+        // 设置渲染状态
+        m_Context->OMSetBlendState(m_AdditiveBlend, nullptr, 0xffffffff);
+        m_Context->OMSetDepthStencilState(m_NoDepthState, 0);
+        m_Context->RSSetState(m_NoCullingState);
 
-    // 设置着色器
-    m_Context->VSSetShader(m_VertexShader, nullptr, 0);
-    m_Context->PSSetShader(m_PixelShader, nullptr, 0);
+        // 设置着色器
+        m_Context->VSSetShader(m_VertexShader, nullptr, 0);
+        m_Context->PSSetShader(m_PixelShader, nullptr, 0);
 
-    // 设置输入布局和拓扑
-    m_Context->IASetInputLayout(m_InputLayout);
-    m_Context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_POINTLIST);
+        // 设置输入布局和拓扑
+        m_Context->IASetInputLayout(m_InputLayout);
+        m_Context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_POINTLIST);
+        
+        targetBound = true;
+    }
 
     // 设置顶点缓冲
-    UINT stride = sizeof(Core::LaserPoint);
+    UINT stride = m_VertexStride;
     UINT offset = 0;
     ID3D11Buffer* buffers[] = { resources.VertexBuffer };
     m_Context->IASetVertexBuffers(0, 1, buffers, &stride, &offset);
 
     // 绘制
-    UINT vertexCount = static_cast<UINT>(points.size());
+    UINT vertexCount = static_cast<UINT>(points.Size());
     m_Context->Draw(vertexCount, 0);
-
-    // 生成Mipmap
-    if (m_Settings.EnableMipmaps) {
-        m_Context->GenerateMips(resources.SRV);
-    }
-
-    // 恢复渲染状态
-    if (oldRTV || oldDSV) {
-        ID3D11RenderTargetView* rtvs[] = { oldRTV };
-        m_Context->OMSetRenderTargets(1, oldRTV ? rtvs : nullptr, oldDSV);
-    }
-    if (oldRTV) oldRTV->Release();
-    if (oldDSV) oldDSV->Release();
 }
 
-void LaserRenderer::UploadVertexData(const std::vector<Core::LaserPoint>& points, 
+void LaserRenderer::UploadVertexData(const Core::LaserFrame& points, 
                                       ID3D11Buffer*& vertexBuffer, 
                                       size_t& bufferCapacity) {
-    if (points.empty()) {
+    if (points.Empty()) {
         return;
     }
 
     // 如果缓冲区不够大，重新创建更大的缓冲区
-    if (points.size() > bufferCapacity) {
+    if (points.Size() > bufferCapacity) {
         // 计算新容量（增加余量避免频繁重建）
-        bufferCapacity = points.size() + 5000;
+        bufferCapacity = points.Size() + 5000;
         
         // 释放旧缓冲区
         if (vertexBuffer) {
@@ -556,7 +651,7 @@ void LaserRenderer::UploadVertexData(const std::vector<Core::LaserPoint>& points
         // 创建新的更大缓冲区
         D3D11_BUFFER_DESC vbDesc = {};
         vbDesc.Usage = D3D11_USAGE_DYNAMIC;
-        vbDesc.ByteWidth = static_cast<UINT>(bufferCapacity * sizeof(Core::LaserPoint));
+        vbDesc.ByteWidth = static_cast<UINT>(bufferCapacity * m_VertexStride);
         vbDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
         vbDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
         
@@ -569,11 +664,15 @@ void LaserRenderer::UploadVertexData(const std::vector<Core::LaserPoint>& points
         std::cout << "Expanded vertex buffer to capacity: " << bufferCapacity << " points" << std::endl;
     }
 
-    // 映射缓冲区并上传数据
+    // 映射缓冲区并上传数据（SoA 通道在此合并为顶点布局）
     D3D11_MAPPED_SUBRESOURCE mapped;
     HRESULT hr = m_Context->Map(vertexBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
     if (SUCCEEDED(hr)) {
-        std::memcpy(mapped.pData, points.data(), points.size() * sizeof(Core::LaserPoint));
+        if (m_Settings.QuantizedVertexUpload) {
+            Core::PackQuantizedVertices(points.View(), static_cast<Core::QuantizedVertex*>(mapped.pData));
+        } else {
+            points.CopyTo(static_cast<Core::LaserPoint*>(mapped.pData));
+        }
         m_Context->Unmap(vertexBuffer, 0);
     }
 }
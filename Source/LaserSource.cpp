@@ -3,8 +3,8 @@
 // 文件：LaserSource.cpp
 // 作者：Yunsio
 // 日期：2025-10-06
-// 描述：激光源数据处理实现，负责点数据的扫描仪模拟、插值、降采样、
-//       光束检测、速度平滑和边缘淡化
+// 描述：激光源数据处理实现，负责帧缓存、输出快照和静止光束检测，
+//       扫描仪模拟（插值、递推、边缘淡化和降采样）由 ScannerPipeline 完成
 //==============================================================================
 
 #include "LaserSource.h"
@@ -14,6 +14,52 @@
 namespace BeyondLink {
 namespace Core {
 
+namespace {
+
+//==========================================================================
+// 函数：IsSamePosition
+// 描述：判断两个位置是否相同（与 LaserPoint::IsSamePosition 的默认误差一致）
+//==========================================================================
+inline bool IsSamePosition(float x0, float y0, float x1, float y1) {
+    return std::abs(x0 - x1) < 0.0001f && std::abs(y0 - y1) < 0.0001f;
+}
+
+//==========================================================================
+// 函数：IsBlank
+// 描述：判断颜色是否为空白（与 LaserPoint::IsBlankPoint 一致）
+//==========================================================================
+inline bool IsBlank(float r, float g, float b) {
+    return r <= 0.0001f && g <= 0.0001f && b <= 0.0001f;
+}
+
+//==========================================================================
+// 函数：HasProcessingChanges
+// 描述：判断两份配置是否在影响处理结果的字段上不同：
+//       ScannerPipelineParams::FromSettings 读取的字段、分块并行开关和静止光束检测参数
+//       （端口、纹理 Mipmap、帧缓存等不影响处理结果的字段不参与比较）
+//==========================================================================
+bool HasProcessingChanges(const LaserSettings& a, const LaserSettings& b) {
+    for (int i = 0; i < 4; ++i) {
+        if (a.QualityInterpolation[i] != b.QualityInterpolation[i]) {
+            return true;
+        }
+    }
+    return a.SampleCount != b.SampleCount || a.LaserQuality != b.LaserQuality ||
+           a.TextureSize != b.TextureSize || a.VelocitySmoothing != b.VelocitySmoothing ||
+           a.EdgeFade != b.EdgeFade || a.VectorizedEdgeFade != b.VectorizedEdgeFade ||
+           a.AdaptiveSampling != b.AdaptiveSampling || a.AdaptivePixelSpacing != b.AdaptivePixelSpacing ||
+           a.AdaptiveMinSamples != b.AdaptiveMinSamples || a.AdaptiveMaxSamples != b.AdaptiveMaxSamples ||
+           a.CullBlankSegments != b.CullBlankSegments || a.SimplifyPixelTolerance != b.SimplifyPixelTolerance ||
+           a.LodPixelTolerance != b.LodPixelTolerance || a.LodViewScale != b.LodViewScale ||
+           a.QuantizedVertexUpload != b.QuantizedVertexUpload || a.ScannerResponse != b.ScannerResponse ||
+           a.GalvoNaturalFrequency != b.GalvoNaturalFrequency || a.GalvoDamping != b.GalvoDamping ||
+           a.ScanRateKpps != b.ScanRateKpps || a.ParallelScannerSimulation != b.ParallelScannerSimulation ||
+           a.ParallelScanMinSamples != b.ParallelScanMinSamples || a.ParallelScanSeeding != b.ParallelScanSeeding ||
+           a.BeamRepeatThreshold != b.BeamRepeatThreshold || a.BeamIntensityCount != b.BeamIntensityCount;
+}
+
+} // namespace
+
 //==========================================================================
 // 构造函数：LaserSource
 // 描述：初始化激光源，预分配内存
@@ -24,15 +70,45 @@ namespace Core {
 LaserSource::LaserSource(int deviceID, const LaserSettings& settings)
     : m_DeviceID(deviceID)
     , m_Settings(settings)
+    , m_OutputInterest(0)
+    , m_BeamPointsValid(true)
+    , m_HotBeamsValid(true)
+    , m_HotBeamPointsExpanded(true)
+    , m_InputGeneration(0)
+    , m_SettingsVersion(1)
+    , m_ProcessedInputGeneration(0)
+    , m_ProcessedSettingsVersion(0)
+    , m_ProcessedScannerSim(false)
+    , m_FrameGeneration(0)
+    , m_InputPointCount(0)
+    , m_PointBudget(0)
+    , m_ProcessedPointBudget(0)
+    , m_PointDemand(0)
+    , m_Pipeline(nullptr)
+    , m_PipelineSettingsVersion(0)
+    , m_WorkerPool(nullptr)
+    , m_FrameCacheEnabled(settings.EnableFrameCache)
+    , m_RawFrameHash(0)
+    , m_OutputKey(0)
     , m_LineWidth(settings.LineWidth)
     , m_MaxBeamBrush(settings.MaxBeamBrush)
     , m_EnableBeamBrush(settings.EnableBeamBrush)
 {
     // 预分配内存
-    m_RawPoints.reserve(InitialCapacity);
-    m_ProcessedPoints.reserve(InitialCapacity);
-    m_BeamPoints.reserve(InitialCapacity);
-    m_HotBeamPoints.reserve(1000);
+    AcquireWritableFrame(m_RawFrame).Reserve(InitialCapacity);
+    AcquireWritableFrame(m_InboundFrame).Reserve(InitialCapacity);
+    AcquireWritableFrame(m_ProcessedFrame).Reserve(InitialCapacity);
+    AcquireWritableFrame(m_BeamFrame).Reserve(InitialCapacity);
+    
+    // 初始快照：空主点列表，代数 0
+    auto snapshot = std::make_shared<FrameSnapshot>();
+    snapshot->Processed = m_ProcessedFrame;
+    m_Snapshot = std::move(snapshot);
+    m_HotBeams.reserve(64);
+    
+    if (settings.EnableFrameCache) {
+        m_FrameCache = std::make_unique<FrameCache>(static_cast<size_t>((std::max)(1, settings.FrameCacheCapacity)));
+    }
 }
 
 //==========================================================================
@@ -44,324 +120,502 @@ LaserSource::~LaserSource() {
 
 //==========================================================================
 // 函数：SetPointList
-// 描述：设置原始激光点数据（拷贝版本）
+// 描述：设置原始激光点数据（拷贝版本，拆分为 SoA 通道）
+//       原始帧仍被输出列表共享时写入新缓冲
 // 参数：
 //   points - 激光点列表
 //==========================================================================
 void LaserSource::SetPointList(const std::vector<LaserPoint>& points) {
     std::lock_guard<std::mutex> lock(m_Mutex);
-    m_RawPoints = points;
+    LaserFrame& raw = AcquireWritableFrame(m_RawFrame);
+    raw.Assign(points.data(), points.size());
+    m_RawFrameHash = HashRawPoints(raw);
+    m_InputPointCount.store(raw.Size(), std::memory_order_relaxed);
+    m_InputGeneration++;
 }
 
 //==========================================================================
 // 函数：SetPointList
 // 描述：设置原始激光点数据（移动版本）
+//       内部为 SoA 布局，AoS 输入总需拆分复制，与拷贝版本相同
 // 参数：
 //   points - 激光点列表（右值引用）
 //==========================================================================
 void LaserSource::SetPointList(std::vector<LaserPoint>&& points) {
+    SetPointList(static_cast<const std::vector<LaserPoint>&>(points));
+}
+
+//==========================================================================
+// 函数：IsCurrentFrame
+// 描述：判断帧哈希是否与当前原始帧相同，相同则记录一次解码跳过
+//       帧缓存可能被主线程的 SetSettings 同时停用，判断与记录在同一次加锁内完成
+// 参数：
+//   frameHash - 帧内容哈希
+// 返回值：
+//   true - 与当前原始帧相同
+//   false - 不同或帧缓存未启用
+//==========================================================================
+bool LaserSource::IsCurrentFrame(uint64_t frameHash) {
+    if (frameHash == 0) {
+        return false;
+    }
+    
     std::lock_guard<std::mutex> lock(m_Mutex);
-    m_RawPoints = std::move(points);
+    if (!m_FrameCache || m_RawFrameHash != frameHash) {
+        return false;
+    }
+    m_FrameCache->RecordDecodeSkip();
+    return true;
+}
+
+//==========================================================================
+// 函数：BeginInboundFrame
+// 描述：准备接收缓冲供解码器直接写入（只由接收线程调用）
+//       接收缓冲是上一个原始帧，仍被输出列表共享时（透传模式下主点列表尚未更新）改用新缓冲
+// 参数：
+//   pointCount - 本帧点数量
+// 返回值：
+//   MutableFrameView - 接收缓冲的可写视图
+//==========================================================================
+MutableFrameView LaserSource::BeginInboundFrame(size_t pointCount) {
+    LaserFrame& inbound = AcquireWritableFrame(m_InboundFrame);
+    inbound.Resize(pointCount);
+    return inbound.MutableView();
+}
+
+//==========================================================================
+// 函数：CommitInboundFrame
+// 描述：将接收缓冲发布为原始点列表（交换缓冲，无点数据拷贝）
+// 参数：
+//   frameHash - 帧内容哈希（0 表示未知）
+//==========================================================================
+void LaserSource::CommitInboundFrame(uint64_t frameHash) {
+    if (frameHash == 0) {
+        frameHash = HashRawPoints(*m_InboundFrame);
+    }
+    
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_RawFrame.swap(m_InboundFrame);
+    m_RawFrameHash = frameHash;
+    m_InputPointCount.store(m_RawFrame->Size(), std::memory_order_relaxed);
+    m_InputGeneration++;
+}
+
+//==========================================================================
+// 函数：SetSettings
+// 描述：更新配置参数，帧缓存按新设置启用/停用
+//       只有影响处理结果的字段变化时才递增设置版本（设置版本参与缓存键，旧设置下的缓存条目不会被命中），
+//       其他字段变化时当前输出和缓存条目仍然有效
+// 参数：
+//   settings - 新的配置参数
+//==========================================================================
+void LaserSource::SetSettings(const LaserSettings& settings) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    const bool processingChanged = HasProcessingChanges(m_Settings, settings);
+    m_Settings = settings;
+    if (processingChanged) {
+        m_SettingsVersion++;
+        m_OutputKey = 0;
+    }
+    
+    if (settings.EnableFrameCache && !m_FrameCache) {
+        m_FrameCache = std::make_unique<FrameCache>(static_cast<size_t>((std::max)(1, settings.FrameCacheCapacity)));
+    } else if (!settings.EnableFrameCache && m_FrameCache) {
+        m_FrameCache.reset();
+        m_RawFrameHash = 0;
+    }
+    m_FrameCacheEnabled.store(settings.EnableFrameCache, std::memory_order_relaxed);
+}
+
+//==========================================================================
+// 函数：SetPointBudget
+// 描述：设置主点列表的点数预算，预算参与缓存键，不同预算下的处理结果不会互相命中
+// 参数：
+//   budget - 点数预算（0 表示不限制）
+//==========================================================================
+void LaserSource::SetPointBudget(size_t budget) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_PointBudget = budget;
+}
+
+//==========================================================================
+// 函数：RegisterOutputInterest
+// 描述：登记输出列表需求，从下次处理起随主点列表一起计算
+// 参数：
+//   outputs - OutputList 标志组合
+//==========================================================================
+void LaserSource::RegisterOutputInterest(uint32_t outputs) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_OutputInterest |= outputs & (OutputBeam | OutputHotBeam);
+}
+
+//==========================================================================
+// 函数：UnregisterOutputInterest
+// 描述：取消输出列表需求，之后只在获取函数调用时按需计算
+// 参数：
+//   outputs - OutputList 标志组合
+//==========================================================================
+void LaserSource::UnregisterOutputInterest(uint32_t outputs) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_OutputInterest &= ~outputs;
 }
 
 //==========================================================================
 // 函数：UpdatePointList
 // 描述：更新处理后的点数据，应用扫描仪模拟、插值、降采样、光束检测
+//       光束点列表和高强度光束游程只在登记了需求时计算，否则留给获取函数按需计算
 // 参数：
 //   enableScannerSim - 是否启用扫描仪模拟
 //==========================================================================
 void LaserSource::UpdatePointList(bool enableScannerSim) {
     std::lock_guard<std::mutex> lock(m_Mutex);
     
-    if (m_RawPoints.empty()) {
-        m_ProcessedPoints.clear();
-        m_BeamPoints.clear();
-        m_HotBeamPoints.clear();
+    // 输入帧和处理参数都未变化，当前输出仍然有效
+    if (m_InputGeneration == m_ProcessedInputGeneration &&
+        m_SettingsVersion == m_ProcessedSettingsVersion &&
+        enableScannerSim == m_ProcessedScannerSim &&
+        m_PointBudget == m_ProcessedPointBudget) {
         return;
     }
+    m_ProcessedInputGeneration = m_InputGeneration;
+    m_ProcessedSettingsVersion = m_SettingsVersion;
+    m_ProcessedScannerSim = enableScannerSim;
+    m_ProcessedPointBudget = m_PointBudget;
     
-    // 生成高强度光束点
-    GenerateHotBeams(m_RawPoints);
+    const bool wantBeam = (m_OutputInterest & OutputBeam) != 0;
+    const bool wantHotBeams = (m_OutputInterest & OutputHotBeam) != 0;
+    m_HotBeamPointsExpanded = false;
     
-    // 应用扫描仪模拟
-    if (enableScannerSim && m_RawPoints.size() > 1) {
-        std::vector<LaserPoint> interpolated = ApplyScannerSimulation(m_RawPoints);
-        
-        // 根据质量设置降采样
-        int downsampleFactor = 1;
-        int downsampleFactorBeams = 1;
-        
-        switch (m_Settings.LaserQuality) {
-            case LaserSettings::QualityLevel::Low:
-                downsampleFactor = 8;
-                downsampleFactorBeams = 8;
-                break;
-            case LaserSettings::QualityLevel::Medium:
-                downsampleFactor = 4;
-                downsampleFactorBeams = 8;
-                break;
-            case LaserSettings::QualityLevel::High:
-                downsampleFactor = 2;
-                downsampleFactorBeams = 2;
-                break;
-            case LaserSettings::QualityLevel::Ultra:
-                downsampleFactor = 1;
-                downsampleFactorBeams = 1;
-                break;
+    if (m_RawFrame->Empty()) {
+        bool hadOutput = !m_ProcessedFrame->Empty() || !m_BeamFrame->Empty() || !m_HotBeams.empty();
+        m_PointDemand.store(0, std::memory_order_relaxed);
+        ReleaseOutputAliases();
+        AcquireWritableFrame(m_ProcessedFrame).Clear();
+        m_BeamFrame = m_ProcessedFrame;
+        m_HotBeams.clear();
+        m_BeamPointsValid = true;
+        m_HotBeamsValid = true;
+        m_OutputKey = 0;
+        if (hadOutput) {
+            PublishSnapshot(false);
+        }
+        return;
+    }
+    
+    // 处理参数或光束输出需求变化时重新选择特化实例
+    // 光束点与原始帧或主点列表相同时共享缓冲，处理实例只在内容不同时输出光束点
+    if (m_Pipeline == nullptr || m_PipelineSettingsVersion != m_SettingsVersion ||
+        m_PipelineParams.ScannerSimulation != enableScannerSim ||
+        m_PipelineParams.BeamOutput != (wantBeam && enableScannerSim && !m_PipelineParams.IsBeamSameAsProcessed())) {
+        m_PipelineParams = ScannerPipelineParams::FromSettings(m_Settings, enableScannerSim, m_EnableBeamBrush);
+        m_PipelineParams.Pool = m_Settings.ParallelScannerSimulation ? m_WorkerPool : nullptr;
+        m_PipelineParams.Arena = &m_Arena;
+        m_PipelineParams.Stats = &m_PipelineStats;
+        m_PipelineParams.BeamOutput = wantBeam && enableScannerSim && !m_PipelineParams.IsBeamSameAsProcessed();
+        m_Pipeline = ScannerPipeline::Select(m_PipelineParams);
+        m_PipelineSettingsVersion = m_SettingsVersion;
+    }
+    
+    // 未登记需求的列表由获取函数按需计算
+    m_BeamPointsValid = wantBeam;
+    m_HotBeamsValid = wantHotBeams;
+    
+    // 帧缓存：键由原始帧哈希、影响处理结果的参数、输出需求和点预算组成
+    uint64_t cacheKey = 0;
+    if (m_FrameCache && m_RawFrameHash != 0) {
+        uint64_t salt = (m_SettingsVersion << 4) | (static_cast<uint64_t>(m_OutputInterest & 0x3u) << 2) |
+                        (enableScannerSim ? 1u : 0u) | (m_EnableBeamBrush ? 2u : 0u);
+        cacheKey = FrameCache::CombineKey(m_RawFrameHash, salt);
+        if (m_PointBudget > 0) {
+            cacheKey = FrameCache::CombineKey(cacheKey, m_PointBudget);
         }
         
-        m_ProcessedPoints = DownsamplePoints(interpolated, downsampleFactor);
-        m_BeamPoints = DownsamplePoints(interpolated, downsampleFactorBeams);
-        
-        // 如果启用BeamBrush，移除重复点
-        if (m_EnableBeamBrush) {
-            m_ProcessedPoints = RemoveDuplicatePoints(m_ProcessedPoints);
+        // 当前输出已是该帧（静态画面），无需任何处理，输出代数不变
+        // 设置 m_OutputKey 的路径同时设置了该帧的点需求，需求仍然有效
+        if (cacheKey == m_OutputKey) {
+            m_FrameCache->RecordHit();
+            return;
         }
-    } else {
-        // 不使用扫描仪模拟，直接使用原始点
-        m_ProcessedPoints = m_RawPoints;
-        m_BeamPoints = m_RawPoints;
         
-        if (m_EnableBeamBrush) {
-            m_ProcessedPoints = RemoveDuplicatePoints(m_ProcessedPoints);
+        // 循环动画：从缓存取回处理结果（共享帧，不拷贝）和抽取前的点需求
+        size_t pointDemand = 0;
+        if (m_FrameCache->Restore(cacheKey, m_ProcessedFrame, m_BeamFrame, m_HotBeams, pointDemand)) {
+            m_PointDemand.store(pointDemand, std::memory_order_relaxed);
+            m_OutputKey = cacheKey;
+            PublishSnapshot(wantBeam);
+            return;
         }
     }
+    m_OutputKey = 0;
+    
+    // 中间结果从帧内存池分配，上一次处理的分配整体回收
+    m_Arena.Reset();
+    
+    // 检测静止光束
+    if (wantHotBeams) {
+        GenerateHotBeams(*m_RawFrame);
+    } else {
+        m_HotBeams.clear();
+    }
+    
+    // 扫描仪模拟：插值、模拟、降采样和光束画刷去重在一次遍历中完成
+    // 不模拟且不去重时主点列表就是原始帧，直接共享（超出点预算时拷贝后抽取）
+    // 上一帧的输出仍被已发布的快照引用，与再上一帧的缓冲轮换写入
+    ReleaseOutputAliases();
+    m_ProcessedFrame.swap(m_SpareProcessedFrame);
+    m_BeamFrame.swap(m_SpareBeamFrame);
+    const bool overBudget = m_PointBudget > 0 && m_RawFrame->Size() > m_PointBudget;
+    if (!enableScannerSim && !m_EnableBeamBrush && !overBudget) {
+        m_ProcessedFrame = m_RawFrame;
+    } else if (!enableScannerSim && !m_EnableBeamBrush) {
+        AcquireWritableFrame(m_ProcessedFrame).AssignFrom(*m_RawFrame);
+    } else {
+        LaserFrame& processed = AcquireWritableFrame(m_ProcessedFrame);
+        LaserFrame& beam = m_PipelineParams.BeamOutput ? AcquireWritableFrame(m_BeamFrame) : m_BeamScratch;
+        m_Pipeline(m_RawFrame->View(), m_PipelineParams, processed, beam);
+    }
+    
+    // 点预算：记录抽取前的点数作为下一帧分配的需求，超出预算时原地抽取主点列表
+    // 光束点列表与主点列表相同时随后共享抽取结果，共享原始帧或单独输出的光束点列表不抽取
+    m_PointDemand.store(m_ProcessedFrame->Size(), std::memory_order_relaxed);
+    if (m_PointBudget > 0 && m_ProcessedFrame->Size() > m_PointBudget) {
+        const size_t dropped = ScannerPipeline::DecimateToBudget(AcquireWritableFrame(m_ProcessedFrame),
+                                                                 m_PointBudget, &m_Arena);
+        m_PipelineStats.BudgetDroppedPoints += dropped;
+    }
+    if (wantBeam) {
+        ShareBeamPoints();
+    }
+    if (!m_BeamFrame) {
+        m_BeamFrame = m_ProcessedFrame;
+    }
+    
+    if (cacheKey != 0) {
+        m_FrameCache->Store(cacheKey, m_ProcessedFrame, wantBeam ? m_BeamFrame : SharedFrame(), m_HotBeams,
+                            m_PointDemand.load(std::memory_order_relaxed));
+        m_OutputKey = cacheKey;
+    }
+    PublishSnapshot(wantBeam);
 }
 
 //==========================================================================
-// 函数：ApplyScannerSimulation
-// 描述：应用扫描仪模拟效果（插值、速度平滑、边缘淡化）
+// 函数：SetWorkerPool
+// 描述：设置分块并行扫描使用的线程池，下次处理时重新选择处理实例
 // 参数：
-//   points - 原始激光点列表
+//   pool - 线程池（nullptr 表示单线程处理）
+//==========================================================================
+void LaserSource::SetWorkerPool(WorkerPool* pool) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_WorkerPool != pool) {
+        m_WorkerPool = pool;
+        m_SettingsVersion++;
+    }
+}
+
+//==========================================================================
+// 函数：GetFrameCacheStats
+// 描述：获取帧缓存统计信息
 // 返回值：
-//   vector<LaserPoint> - 模拟后的点列表
+//   FrameCacheStats - 统计信息（未启用帧缓存时为空）
+//==========================================================================
+FrameCacheStats LaserSource::GetFrameCacheStats() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_FrameCache ? m_FrameCache->GetStats() : FrameCacheStats();
+}
+
 //==========================================================================
-std::vector<LaserPoint> LaserSource::ApplyScannerSimulation(const std::vector<LaserPoint>& points) {
-    if (points.size() < 2) {
-        return points;
+// 函数：GetArenaPeakBytes
+// 描述：获取帧内存池单帧峰值用量
+// 返回值：
+//   size_t - 峰值字节数
+//==========================================================================
+size_t LaserSource::GetArenaPeakBytes() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Arena.GetPeakBytes();
+}
+
+//==========================================================================
+// 函数：GetPipelineStats
+// 描述：获取扫描仪模拟处理统计
+// 返回值：
+//   ScannerPipelineStats - 累计统计
+//==========================================================================
+ScannerPipelineStats LaserSource::GetPipelineStats() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_PipelineStats;
+}
+
+//==========================================================================
+// 函数：EvaluateBeamPoints
+// 描述：按当前帧和当前输出的处理参数计算光束点列表
+//       不启用扫描仪模拟时共享原始帧；降采样倍数相同且不去重时共享主点列表
+//==========================================================================
+void LaserSource::EvaluateBeamPoints() {
+    if (m_BeamPointsValid) {
+        return;
     }
+    m_BeamPointsValid = true;
     
-    // 插值增加点密度
-    std::vector<LaserPoint> interpolated = InterpolatePoints(points, m_Settings.SampleCount);
-    
-    // 应用速度平滑和边缘淡化
-    const float smoothing = m_Settings.VelocitySmoothing;
-    const float edgeFade = (std::max)(0.1f, m_Settings.EdgeFade);
-    
-    std::vector<LaserPoint> smoothed;
-    smoothed.reserve(interpolated.size());
-    
-    float currentVelX = 0.0f;
-    float currentVelY = 0.0f;
-    float currentPosX = interpolated[0].X;
-    float currentPosY = interpolated[0].Y;
-    
-    for (size_t i = 0; i < interpolated.size(); ++i) {
-        const auto& point = interpolated[i];
-        
-        // 计算到目标点的向量
-        float targetVelX = point.X - currentPosX;
-        float targetVelY = point.Y - currentPosY;
-        float distance = std::sqrt(targetVelX * targetVelX + targetVelY * targetVelY);
-        
-        float intensity = 1.0f;
-        
-        if (distance > 0.0f) {
-            // 平滑速度向量
-            SmoothVector(currentVelX, currentVelY, targetVelX, targetVelY, smoothing);
-            
-            // 更新位置
-            float stepSize = 100.0f / m_Settings.SampleCount * 0.01f;
-            currentPosX += currentVelX * stepSize;
-            currentPosY += currentVelY * stepSize;
-            
-            // 计算边缘淡化强度
-            float velLength = std::sqrt(currentVelX * currentVelX + currentVelY * currentVelY);
-            intensity = (std::min)(4.0f, 1.0f / velLength * 0.2f * edgeFade * 2.0f);
-            intensity = (std::min)(4.0f, intensity) / (std::max)(1.0, edgeFade * 2.0 * 4.0);
-            
-            // 插值淡化效果
-            float fadePercent = (std::max)(0.0, edgeFade - 0.5) * 2.0;
-            intensity = intensity * (1.0f - fadePercent) + fadePercent;
-        }
-        
-        // 如果是光束点（Z > 0），不应用淡化
-        if (point.Z > 0.0f) {
-            intensity = 1.0f;
-        }
-        
-        LaserPoint smoothedPoint = point;
-        smoothedPoint.X = currentPosX;
-        smoothedPoint.Y = currentPosY;
-        
-        if (point.Z == 0.0f) {
-            smoothedPoint.R *= intensity;
-            smoothedPoint.G *= intensity;
-            smoothedPoint.B *= intensity;
-        }
-        
-        smoothed.push_back(smoothedPoint);
+    if (m_Pipeline != nullptr && !m_RawFrame->Empty() && ShareBeamPoints()) {
+        return;
+    }
+    if (m_BeamFrame == m_ProcessedFrame || m_BeamFrame == m_RawFrame) {
+        m_BeamFrame.reset();
+    }
+    LaserFrame& beam = AcquireWritableFrame(m_BeamFrame);
+    if (m_Pipeline == nullptr || m_RawFrame->Empty()) {
+        beam.Clear();
+        return;
     }
     
-    return smoothed;
+    ScannerPipelineParams beamParams = m_PipelineParams;
+    beamParams.BeamOutput = true;
+    beamParams.Stats = nullptr;
+    ScannerPipeline::Select(beamParams)(m_RawFrame->View(), beamParams, m_BeamScratch, beam);
 }
 
 //==========================================================================
-// 函数：InterpolatePoints
-// 描述：在相邻点之间进行线性插值，增加点密度
-// 参数：
-//   points - 原始点列表
-//   sampleCount - 每对相邻点之间插值的点数
+// 函数：ShareBeamPoints
+// 描述：光束点与原始帧（不模拟）或主点列表（降采样倍数相同且不去重）相同时共享其缓冲
 // 返回值：
-//   vector<LaserPoint> - 插值后的点列表
+//   true - 已共享
+//   false - 内容不同，需要单独计算
 //==========================================================================
-std::vector<LaserPoint> LaserSource::InterpolatePoints(const std::vector<LaserPoint>& points, int sampleCount) {
-    if (points.size() < 2 || sampleCount <= 1) {
-        return points;
+bool LaserSource::ShareBeamPoints() {
+    if (!m_PipelineParams.ScannerSimulation) {
+        m_BeamFrame = m_RawFrame;
+        return true;
     }
-    
-    std::vector<LaserPoint> result;
-    result.reserve((points.size() - 1) * sampleCount);
-    
-    for (size_t i = 0; i < points.size() - 1; ++i) {
-        const auto& p0 = points[i];
-        const auto& p1 = points[i + 1];
-        
-        for (int s = 0; s < sampleCount; ++s) {
-            float t = static_cast<float>(s) / static_cast<float>(sampleCount - 1);
-            
-            LaserPoint interpolated;
-            interpolated.X = p0.X + (p1.X - p0.X) * t;
-            interpolated.Y = p0.Y + (p1.Y - p0.Y) * t;
-            interpolated.R = p0.R + (p1.R - p0.R) * t;
-            interpolated.G = p0.G + (p1.G - p0.G) * t;
-            interpolated.B = p0.B + (p1.B - p0.B) * t;
-            interpolated.Z = (p0.Z > 0.0f) ? (p0.Z + (p1.Z - p0.Z) * t) : 0.0f;
-            interpolated.Focus = p0.Focus + (p1.Focus - p0.Focus) * t;
-            
-            result.push_back(interpolated);
-        }
+    if (m_PipelineParams.IsBeamSameAsProcessed()) {
+        m_BeamFrame = m_ProcessedFrame;
+        return true;
     }
-    
-    return result;
+    return false;
 }
 
 //==========================================================================
-// 函数：DownsamplePoints
-// 描述：降采样点数据，每隔factor个点取一个
+// 函数：PublishSnapshot
+// 描述：先发布快照再递增输出代数，读到新代数的读取方一定能取得对应的快照
 // 参数：
-//   points - 原始点列表
-//   factor - 降采样因子
-// 返回值：
-//   vector<LaserPoint> - 降采样后的点列表
+//   includeBeam - 快照是否包含光束点列表
 //==========================================================================
-std::vector<LaserPoint> LaserSource::DownsamplePoints(const std::vector<LaserPoint>& points, int factor) {
-    if (factor <= 1 || points.empty()) {
-        return points;
+void LaserSource::PublishSnapshot(bool includeBeam) {
+    auto snapshot = std::make_shared<FrameSnapshot>();
+    snapshot->Generation = m_FrameGeneration.load(std::memory_order_relaxed) + 1;
+    snapshot->Processed = m_ProcessedFrame;
+    if (includeBeam) {
+        snapshot->Beam = m_BeamFrame;
     }
     
-    size_t newSize = (points.size() + factor - 1) / factor;
-    std::vector<LaserPoint> result;
-    result.reserve(newSize);
-    
-    for (size_t i = 0; i < points.size(); i += factor) {
-        if (i < points.size()) {
-            result.push_back(points[i]);
-        }
+    const uint64_t generation = snapshot->Generation;
+    std::atomic_store_explicit(&m_Snapshot, SharedSnapshot(std::move(snapshot)), std::memory_order_release);
+    m_FrameGeneration.store(generation, std::memory_order_release);
+}
+
+//==========================================================================
+// 函数：ReleaseOutputAliases
+// 描述：解除输出列表之间及与原始帧的共享，独占的缓冲随后可原地复用
+//==========================================================================
+void LaserSource::ReleaseOutputAliases() {
+    if (m_BeamFrame == m_ProcessedFrame || m_BeamFrame == m_RawFrame) {
+        m_BeamFrame.reset();
+    }
+    if (m_ProcessedFrame == m_RawFrame) {
+        m_ProcessedFrame.reset();
     }
-    
-    return result;
+}
+
+//==========================================================================
+// 函数：EvaluateHotBeams
+// 描述：按当前帧检测静止光束
+//==========================================================================
+void LaserSource::EvaluateHotBeams() {
+    if (m_HotBeamsValid) {
+        return;
+    }
+    m_HotBeamsValid = true;
+    GenerateHotBeams(*m_RawFrame);
+}
+
+//==========================================================================
+// 函数：GetHotBeamPoints
+// 描述：按需将高强度光束游程展开为逐点帧，游程变化前重复调用不再展开
+// 返回值：
+//   高强度光束点帧的常量引用
+//==========================================================================
+const LaserFrame& LaserSource::GetHotBeamPoints() {
+    EvaluateHotBeams();
+    if (!m_HotBeamPointsExpanded) {
+        ExpandHotBeams(m_HotBeams, m_HotBeamPoints);
+        m_HotBeamPointsExpanded = true;
+    }
+    return m_HotBeamPoints;
 }
 
 //==========================================================================
 // 函数：GenerateHotBeams
-// 描述：检测静止光束点（连续重复位置），生成高强度光束点
+// 描述：检测静止光束点（连续重复位置），每条光束生成一条高强度光束游程
+//       位置比较只访问 X/Y 通道，空白判断只访问颜色通道
+//       游程结束于索引 i 时，光束点取倒数第二个重复点（索引 i - 2）
 // 参数：
-//   points - 激光点列表
+//   points - 激光点帧
 //==========================================================================
-void LaserSource::GenerateHotBeams(const std::vector<LaserPoint>& points) {
-    m_HotBeamPoints.clear();
+void LaserSource::GenerateHotBeams(const LaserFrame& points) {
+    m_HotBeams.clear();
+    m_HotBeamPointsExpanded = false;
     
-    if (points.size() < 2) {
+    if (points.Size() < 2) {
         return;
     }
     
-    std::vector<size_t> beamIndices;
+    FrameView in = points.View();
     int consecutiveCount = 0;
     
-    for (size_t i = 1; i < points.size(); ++i) {
-        const auto& curr = points[i];
-        const auto& prev = points[i - 1];
-        
-        if (curr.IsSamePosition(prev) && 
-            !curr.IsBlankPoint() && 
-            !prev.IsBlankPoint() &&
-            i < points.size() - 1) {
+    for (size_t i = 1; i < in.Count; ++i) {
+        if (IsSamePosition(in.X[i], in.Y[i], in.X[i - 1], in.Y[i - 1]) && 
+            !IsBlank(in.R[i], in.G[i], in.B[i]) && 
+            !IsBlank(in.R[i - 1], in.G[i - 1], in.B[i - 1]) &&
+            i < in.Count - 1) {
             
             consecutiveCount++;
-            beamIndices.push_back(i - 1);
-            
-            if (i == points.size() - 1) {
-                beamIndices.push_back(i);
-            }
         } else {
-            if (consecutiveCount > m_Settings.BeamRepeatThreshold) {
-                // 生成高强度光束点
-                const auto& beamPoint = points[beamIndices.back()];
-                for (int j = 0; j < m_Settings.BeamIntensityCount; ++j) {
-                    LaserPoint hotPoint = beamPoint;
-                    hotPoint.Z = (std::max)(0.0001f, 
-                        static_cast<float>(j) / static_cast<float>(m_Settings.BeamIntensityCount - 1));
-                    m_HotBeamPoints.push_back(hotPoint);
-                }
+            if (consecutiveCount > 0 && consecutiveCount > m_Settings.BeamRepeatThreshold &&
+                m_Settings.BeamIntensityCount > 0) {
+                HotBeamRun run;
+                run.Point = in.GetPoint(i - 2);
+                run.RepeatCount = m_Settings.BeamIntensityCount;
+                m_HotBeams.push_back(run);
             }
-            beamIndices.clear();
             consecutiveCount = 0;
         }
     }
 }
 
 //==========================================================================
-// 函数：RemoveDuplicatePoints
-// 描述：移除连续重复位置的点
+// 函数：HashRawPoints
+// 描述：计算原始点列表的内容哈希
+//       接收线程在加锁前调用，只读取启用标志；停用后提交的哈希不会被使用（缓存为空）
 // 参数：
 //   points - 原始点列表
 // 返回值：
-//   vector<LaserPoint> - 去重后的点列表
+//   uint64_t - 帧内容哈希，帧缓存未启用或列表为空时为 0
 //==========================================================================
-std::vector<LaserPoint> LaserSource::RemoveDuplicatePoints(const std::vector<LaserPoint>& points) {
-    if (points.empty()) {
-        return points;
+uint64_t LaserSource::HashRawPoints(const LaserFrame& points) const {
+    if (!IsFrameCacheEnabled() || points.Empty()) {
+        return 0;
     }
     
-    std::vector<LaserPoint> result;
-    result.reserve(points.size());
-    result.push_back(points[0]);
-    
-    for (size_t i = 1; i < points.size(); ++i) {
-        if (!points[i].IsSamePosition(result.back())) {
-            result.push_back(points[i]);
-        }
-    }
-    
-    return result;
-}
-
-//==========================================================================
-// 函数：SmoothVector
-// 描述：对速度向量进行平滑处理（指数移动平均）
-// 参数：
-//   currentX - [输入/输出] 当前X方向速度
-//   currentY - [输入/输出] 当前Y方向速度
-//   targetX - 目标X方向速度
-//   targetY - 目标Y方向速度
-//   smoothing - 平滑系数 (0-1)
-//==========================================================================
-void LaserSource::SmoothVector(float& currentX, float& currentY, 
-                               float targetX, float targetY, 
-                               float smoothing) {
-    currentX += (targetX - currentX) * (1.0f - smoothing);
-    currentY += (targetY - currentY) * (1.0f - smoothing);
+    // 逐通道链式哈希（前一通道的哈希作为下一通道的种子）
+    const size_t bytes = points.Size() * sizeof(float);
+    uint64_t hash = RawPointHashSeed;
+    hash = FrameCache::HashBytes(points.X(), bytes, hash);
+    hash = FrameCache::HashBytes(points.Y(), bytes, hash);
+    hash = FrameCache::HashBytes(points.R(), bytes, hash);
+    hash = FrameCache::HashBytes(points.G(), bytes, hash);
+    hash = FrameCache::HashBytes(points.B(), bytes, hash);
+    hash = FrameCache::HashBytes(points.Z(), bytes, hash);
+    hash = FrameCache::HashBytes(points.Focus(), bytes, hash);
+    return hash;
 }
 
 } // namespace Core
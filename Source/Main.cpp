@@ -159,6 +159,8 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
     auto lastStatsTime = std::chrono::steady_clock::now();
     int frameCount = 0;
     int currentDevice = 0;  // 当前显示的设备索引（0-8，对应显示设备1-9）
+    const float viewedDevicePriority = 4.0f;  // 点数预算分配中当前显示设备的优先级（其余设备为 1.0）
+    system.SetDevicePriority(currentDevice, viewedDevicePriority);
     
     std::cout << "=== Device Control ===" << std::endl;
     std::cout << "  Press 1-9 to switch between laser devices" << std::endl;
@@ -194,7 +196,9 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
                 keyPressed[deviceIndex] = true;
                 
                 if (deviceIndex != currentDevice) {
+                    system.SetDevicePriority(currentDevice, 1.0f);
                     currentDevice = deviceIndex;
+                    system.SetDevicePriority(currentDevice, viewedDevicePriority);
                     // 输出切换提示（显示设备编号1-9，包含对应的多播地址）
                     std::cout << "\n>>> Switched to Device " << (currentDevice + 1) << " (Multicast: 239.255." 
                               << currentDevice << ".x) <<<\n" << std::endl;
@@ -241,13 +245,64 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
             std::cout << "Network: " << stats.PacketsReceived << " packets | " 
                      << stats.BytesReceived << " bytes | FPS: " << (frameCount / elapsed) << std::endl;
             
+            // ----- 接收延迟（到达到分发） -----
+            auto latency = system.GetLatencyStats();
+            if (latency.Samples > 0) {
+                std::cout << "Receive latency (" << (latency.BusyPollMode ? "busy-poll" : "blocking") << "): p50 <= " 
+                         << latency.GetPercentile(0.5) << " us | p99 <= " << latency.GetPercentile(0.99) 
+                         << " us | max " << latency.MaxMicroseconds << " us";
+                if (latency.UnstampedReceives > 0) {
+                    std::cout << " | " << latency.UnstampedReceives << " without kernel timestamp";
+                }
+                std::cout << std::endl;
+            }
+            
+            // ----- 处理内存（帧内存池峰值） -----
+            std::cout << "Frame arena peak: " << (system.GetArenaPeakBytes() / 1024) << " KB" << std::endl;
+            
+            // ----- 消隐段剔除 -----
+            if (system.GetSettings().CullBlankSegments) {
+                auto pipeline = system.GetPipelineStats();
+                std::cout << "Blank culling: " << static_cast<int>(pipeline.GetCulledRatio() * 100.0) << "% of samples culled ("
+                         << pipeline.CulledSamples << "/" << pipeline.Samples << ")" << std::endl;
+            }
+            
+            // ----- 输入简化 -----
+            if (system.GetSettings().SimplifyPixelTolerance > 0.0f) {
+                auto pipeline = system.GetPipelineStats();
+                std::cout << "Input simplification: " << static_cast<int>(pipeline.GetSimplifiedRatio() * 100.0)
+                         << "% of raw points removed (" << pipeline.SimplifiedPoints << "/" << pipeline.InputPoints << ")" << std::endl;
+            }
+            
+            // ----- 细节层次合并 -----
+            if (system.GetSettings().LodPixelTolerance > 0.0f) {
+                auto pipeline = system.GetPipelineStats();
+                std::cout << "LOD: " << pipeline.MergedSamples << " samples merged into shared pixels" << std::endl;
+            }
+            
+            // ----- 帧点数预算 -----
+            if (system.GetSettings().FramePointBudget > 0) {
+                auto pipeline = system.GetPipelineStats();
+                std::cout << "Point budget: " << pipeline.BudgetDroppedPoints << " points dropped (budget "
+                         << system.GetSettings().FramePointBudget << " points/frame)" << std::endl;
+            }
+            
+            // ----- 帧缓存 -----
+            if (system.GetSettings().EnableFrameCache) {
+                auto cache = system.GetFrameCacheStats();
+                std::cout << "Frame cache: " << static_cast<int>(cache.GetHitRate() * 100.0) << "% hits (" 
+                         << cache.Hits << "/" << (cache.Hits + cache.Misses) << ") | " 
+                         << cache.DecodeSkips << " decodes skipped | " << cache.Entries << " frames, " 
+                         << (cache.MemoryBytes / 1024) << " KB" << std::endl;
+            }
+            
             // ----- 显示所有设备的状态 -----
             // 格式：[OK] 有数据   [--] 无数据   >>> 当前查看的设备
             // 显示设备编号1-9（内部索引0-8）
             std::cout << "\nAll Devices Status:" << std::endl;
             for (int dev = 0; dev < 9; ++dev) {
-                auto source = system.GetLaserSource(dev);
-                size_t points = source ? source->GetPointCount() : 0;
+                size_t points = system.GetDevicePointCount(dev);
+                int zones = system.GetActiveZoneCount(dev);
                 
                 // 视觉指示器：>>> 表示正在查看此设备
                 std::string indicator = (dev == currentDevice) ? ">>> " : "    ";
@@ -256,6 +311,9 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
                 // 显示设备编号为1-9（dev+1），多播地址使用内部索引（dev）
                 std::cout << indicator << "Device " << (dev + 1) << " (239.255." << dev << ".x): " 
                          << status << " " << points << " points";
+                if (zones > 0) {
+                    std::cout << " (" << zones << " zones)";
+                }
                 
                 if (dev == currentDevice) {
                     std::cout << " <- VIEWING";  // 标记当前正在查看的设备
@@ -270,8 +328,7 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
                 std::cout << "  Check Beyond network output settings." << std::endl;
             } else {
                 // 接收到数据，但当前设备没有点数据
-                auto currentSource = system.GetLaserSource(currentDevice);
-                if (!currentSource || currentSource->GetPointCount() == 0) {
+                if (system.GetDevicePointCount(currentDevice) == 0) {
                     std::cout << "\n[!] WARNING: Device " << (currentDevice + 1) << " has no data!" << std::endl;
                     std::cout << "  Beyond may not be sending to 239.255." << currentDevice << ".x" << std::endl;
                     std::cout << "  Check Beyond Zone/Device configuration (Fixture " << (currentDevice + 1) << ")." << std::endl;
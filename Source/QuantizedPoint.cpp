@@ -0,0 +1,358 @@
+﻿//==============================================================================
+// BeyondLink - Beyond激光可视化系统
+// 文件：QuantizedPoint.cpp
+// 作者：Yunsio
+// 日期：2025-10-06
+// 描述：量化激光点打包/解包实现
+//       SSE2 路径每次处理 4 个点，标量路径处理尾部，两者结果逐位一致
+//==============================================================================
+
+#include "QuantizedPoint.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define BEYONDLINK_QUANTIZE_SSE2 1
+#endif
+
+namespace BeyondLink {
+namespace Core {
+
+namespace {
+
+constexpr float SnormScale = 32767.0f;          // SNORM16 满量程
+constexpr float UnormScale = 255.0f;            // UNORM8 满量程
+constexpr float MaxGain = 4.0f;                 // 最大颜色增益（边缘淡化强度上限）
+constexpr float GainSteps = 85.0f;              // 增益量化步数：(MaxGain - 1) × GainSteps = 255
+
+//==========================================================================
+// 函数：Clamp
+// 描述：截断到 [low, high]（与 SSE2 的 max/min 顺序一致）
+//==========================================================================
+inline float Clamp(float value, float low, float high) {
+    return (std::min)(high, (std::max)(low, value));
+}
+
+//==========================================================================
+// 函数：RoundToInt
+// 描述：就近取偶舍入（与 cvtps2dq 的默认舍入模式一致）
+//==========================================================================
+inline int RoundToInt(float value) {
+    return static_cast<int>(std::lrint(value));
+}
+
+//==========================================================================
+// 函数：DecodeGain
+// 描述：由量化值还原颜色增益
+//==========================================================================
+inline float DecodeGain(int quantized) {
+    return 1.0f + static_cast<float>(quantized) / GainSteps;
+}
+
+//==========================================================================
+// 结构体：PackedLanes
+// 描述：一组（最多 4 个）点的量化字段
+//==========================================================================
+struct PackedLanes {
+    int X[4];
+    int Y[4];
+    int R[4];
+    int G[4];
+    int B[4];
+    int Focus[4];
+    int Extra[4];
+    int Flags[4];
+};
+
+//==========================================================================
+// 函数：QuantizeLane
+// 描述：标量量化单个点到 PackedLanes 的指定通道
+//==========================================================================
+void QuantizeLane(const FrameView& frame, size_t index, PackedLanes& lanes, int lane) {
+    const float r = frame.R[index];
+    const float g = frame.G[index];
+    const float b = frame.B[index];
+    const float z = frame.Z[index];
+    
+    lanes.X[lane] = RoundToInt(Clamp(frame.X[index], -1.0f, 1.0f) * SnormScale);
+    lanes.Y[lane] = RoundToInt(Clamp(frame.Y[index], -1.0f, 1.0f) * SnormScale);
+    lanes.Focus[lane] = RoundToInt(Clamp(frame.Focus[index], 0.0f, 1.0f) * UnormScale);
+    
+    int flags = (r <= 0.0001f && g <= 0.0001f && b <= 0.0001f) ? QuantizedBlank : 0;
+    float inverseGain = 1.0f;
+    
+    if (z > 0.0f) {
+        flags |= QuantizedBeam;
+        lanes.Extra[lane] = (std::max)(1, RoundToInt(Clamp(z, 0.0f, 1.0f) * UnormScale));
+    } else {
+        float peak = Clamp((std::max)(r, (std::max)(g, b)), 1.0f, MaxGain);
+        int gain = static_cast<int>(std::ceil((peak - 1.0f) * GainSteps));
+        if (gain > 0) {
+            flags |= QuantizedOverdrive;
+        }
+        lanes.Extra[lane] = gain;
+        inverseGain = 1.0f / DecodeGain(gain);
+    }
+    
+    lanes.R[lane] = RoundToInt(Clamp(r * inverseGain, 0.0f, 1.0f) * UnormScale);
+    lanes.G[lane] = RoundToInt(Clamp(g * inverseGain, 0.0f, 1.0f) * UnormScale);
+    lanes.B[lane] = RoundToInt(Clamp(b * inverseGain, 0.0f, 1.0f) * UnormScale);
+    lanes.Flags[lane] = flags;
+}
+
+#if BEYONDLINK_QUANTIZE_SSE2
+//==========================================================================
+// 函数：ClampPs / RoundPs
+// 描述：SSE2 截断与就近取偶舍入
+//==========================================================================
+inline __m128 ClampPs(__m128 value, __m128 low, __m128 high) {
+    return _mm_min_ps(high, _mm_max_ps(low, value));
+}
+
+inline __m128i RoundPs(__m128 value) {
+    return _mm_cvtps_epi32(value);
+}
+
+//==========================================================================
+// 函数：QuantizeLanes4
+// 描述：SSE2 量化 4 个连续点（与 QuantizeLane 逐位一致）
+//==========================================================================
+void QuantizeLanes4(const FrameView& frame, size_t index, PackedLanes& lanes) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 minusOne = _mm_set1_ps(-1.0f);
+    const __m128 snorm = _mm_set1_ps(SnormScale);
+    const __m128 unorm = _mm_set1_ps(UnormScale);
+    const __m128 blankLevel = _mm_set1_ps(0.0001f);
+    
+    __m128 x = _mm_loadu_ps(frame.X + index);
+    __m128 y = _mm_loadu_ps(frame.Y + index);
+    __m128 r = _mm_loadu_ps(frame.R + index);
+    __m128 g = _mm_loadu_ps(frame.G + index);
+    __m128 b = _mm_loadu_ps(frame.B + index);
+    __m128 z = _mm_loadu_ps(frame.Z + index);
+    __m128 focus = _mm_loadu_ps(frame.Focus + index);
+    
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes.X), RoundPs(_mm_mul_ps(ClampPs(x, minusOne, one), snorm)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes.Y), RoundPs(_mm_mul_ps(ClampPs(y, minusOne, one), snorm)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes.Focus), RoundPs(_mm_mul_ps(ClampPs(focus, zero, one), unorm)));
+    
+    // 光束点掩码与空白掩码
+    __m128 beamMask = _mm_cmpgt_ps(z, zero);
+    __m128 blankMask = _mm_and_ps(_mm_cmple_ps(r, blankLevel), 
+                                  _mm_and_ps(_mm_cmple_ps(g, blankLevel), _mm_cmple_ps(b, blankLevel)));
+    
+    // 非光束点：增益 = ceil((clamp(peak, 1, 4) - 1) × 85)
+    __m128 peak = ClampPs(_mm_max_ps(r, _mm_max_ps(g, b)), one, _mm_set1_ps(MaxGain));
+    __m128 gainScaled = _mm_mul_ps(_mm_sub_ps(peak, one), _mm_set1_ps(GainSteps));
+    __m128i gain = _mm_cvttps_epi32(gainScaled);
+    __m128 roundedDown = _mm_cmplt_ps(_mm_cvtepi32_ps(gain), gainScaled);
+    gain = _mm_sub_epi32(gain, _mm_castps_si128(roundedDown));
+    gain = _mm_andnot_si128(_mm_castps_si128(beamMask), gain);
+    
+    __m128 decodedGain = _mm_add_ps(one, _mm_div_ps(_mm_cvtepi32_ps(gain), _mm_set1_ps(GainSteps)));
+    __m128 inverseGain = _mm_div_ps(one, decodedGain);
+    
+    // 光束点：Extra = max(1, round(clamp(z) × 255))
+    __m128i zQuantized = RoundPs(_mm_mul_ps(ClampPs(z, zero, one), unorm));
+    __m128i oneI = _mm_set1_epi32(1);
+    __m128i zBelowOne = _mm_cmplt_epi32(zQuantized, oneI);
+    zQuantized = _mm_or_si128(_mm_and_si128(zBelowOne, oneI), _mm_andnot_si128(zBelowOne, zQuantized));
+    
+    __m128i beamI = _mm_castps_si128(beamMask);
+    __m128i extra = _mm_or_si128(_mm_and_si128(beamI, zQuantized), _mm_andnot_si128(beamI, gain));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes.Extra), extra);
+    
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes.R), RoundPs(_mm_mul_ps(ClampPs(_mm_mul_ps(r, inverseGain), zero, one), unorm)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes.G), RoundPs(_mm_mul_ps(ClampPs(_mm_mul_ps(g, inverseGain), zero, one), unorm)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes.B), RoundPs(_mm_mul_ps(ClampPs(_mm_mul_ps(b, inverseGain), zero, one), unorm)));
+    
+    // 标志位
+    __m128i flags = _mm_and_si128(beamI, _mm_set1_epi32(QuantizedBeam));
+    flags = _mm_or_si128(flags, _mm_and_si128(_mm_castps_si128(blankMask), _mm_set1_epi32(QuantizedBlank)));
+    flags = _mm_or_si128(flags, _mm_and_si128(_mm_cmpgt_epi32(gain, _mm_setzero_si128()), _mm_set1_epi32(QuantizedOverdrive)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes.Flags), flags);
+}
+#endif
+
+//==========================================================================
+// 函数：WriteLane
+// 描述：将 PackedLanes 的一个通道写入量化点
+//==========================================================================
+inline void WriteLane(const PackedLanes& lanes, int lane, QuantizedPoint& point) {
+    point.X = static_cast<int16_t>(lanes.X[lane]);
+    point.Y = static_cast<int16_t>(lanes.Y[lane]);
+    point.R = static_cast<uint8_t>(lanes.R[lane]);
+    point.G = static_cast<uint8_t>(lanes.G[lane]);
+    point.B = static_cast<uint8_t>(lanes.B[lane]);
+    point.Focus = static_cast<uint8_t>(lanes.Focus[lane]);
+    point.Extra = static_cast<uint8_t>(lanes.Extra[lane]);
+    point.Flags = static_cast<uint8_t>(lanes.Flags[lane]);
+}
+
+inline QuantizedPoint& RecordPoint(QuantizedPoint& record) { return record; }
+inline QuantizedPoint& RecordPoint(QuantizedVertex& record) { record.Padding = 0; return record.Point; }
+
+//==========================================================================
+// 函数：PackRecords
+// 描述：量化整帧到记录数组（QuantizedPoint 或 QuantizedVertex）
+//==========================================================================
+template <typename Record>
+void PackRecords(const FrameView& frame, Record* records) {
+    PackedLanes lanes;
+    size_t i = 0;
+    
+#if BEYONDLINK_QUANTIZE_SSE2
+    for (; i + 4 <= frame.Count; i += 4) {
+        QuantizeLanes4(frame, i, lanes);
+        for (int lane = 0; lane < 4; ++lane) {
+            WriteLane(lanes, lane, RecordPoint(records[i + lane]));
+        }
+    }
+#endif
+    
+    for (; i < frame.Count; ++i) {
+        QuantizeLane(frame, i, lanes, 0);
+        WriteLane(lanes, 0, RecordPoint(records[i]));
+    }
+}
+
+} // namespace
+
+//==========================================================================
+// 函数：QuantizePoint
+// 描述：标量量化单个点
+// 参数：
+//   point - 浮点激光点
+// 返回值：
+//   QuantizedPoint - 量化点
+//==========================================================================
+QuantizedPoint QuantizePoint(const LaserPoint& point) {
+    FrameView view;
+    view.X = &point.X;
+    view.Y = &point.Y;
+    view.R = &point.R;
+    view.G = &point.G;
+    view.B = &point.B;
+    view.Z = &point.Z;
+    view.Focus = &point.Focus;
+    view.Count = 1;
+    
+    PackedLanes lanes;
+    QuantizeLane(view, 0, lanes, 0);
+    
+    QuantizedPoint result;
+    WriteLane(lanes, 0, result);
+    return result;
+}
+
+//==========================================================================
+// 函数：DequantizePoint
+// 描述：标量反量化单个点
+// 参数：
+//   point - 量化点
+// 返回值：
+//   LaserPoint - 浮点激光点
+//==========================================================================
+LaserPoint DequantizePoint(const QuantizedPoint& point) {
+    const bool beam = (point.Flags & QuantizedBeam) != 0;
+    const float gain = beam ? 1.0f : DecodeGain(point.Extra);
+    
+    LaserPoint result;
+    result.X = (std::max)(-1.0f, static_cast<float>(point.X) / SnormScale);
+    result.Y = (std::max)(-1.0f, static_cast<float>(point.Y) / SnormScale);
+    result.R = static_cast<float>(point.R) / UnormScale * gain;
+    result.G = static_cast<float>(point.G) / UnormScale * gain;
+    result.B = static_cast<float>(point.B) / UnormScale * gain;
+    result.Z = beam ? static_cast<float>(point.Extra) / UnormScale : 0.0f;
+    result.Focus = static_cast<float>(point.Focus) / UnormScale;
+    return result;
+}
+
+//==========================================================================
+// 函数：PackQuantizedPoints
+// 描述：量化整帧为 10 字节记录
+// 参数：
+//   frame - 输入帧视图
+//   points - [输出] 量化点数组
+//==========================================================================
+void PackQuantizedPoints(const FrameView& frame, QuantizedPoint* points) {
+    PackRecords(frame, points);
+}
+
+//==========================================================================
+// 函数：PackQuantizedVertices
+// 描述：量化整帧为 12 字节 GPU 顶点
+// 参数：
+//   frame - 输入帧视图
+//   vertices - [输出] 顶点数组
+//==========================================================================
+void PackQuantizedVertices(const FrameView& frame, QuantizedVertex* vertices) {
+    PackRecords(frame, vertices);
+}
+
+//==========================================================================
+// 函数：UnpackQuantizedPoints
+// 描述：反量化到帧的各通道
+//       SSE2 路径先将 4 个记录的字段展开为 int32，再统一转换和缩放
+// 参数：
+//   points - 量化点数组
+//   count - 点数量
+//   frame - [输出] 帧
+//==========================================================================
+void UnpackQuantizedPoints(const QuantizedPoint* points, size_t count, LaserFrame& frame) {
+    frame.Resize(count);
+    MutableFrameView out = frame.MutableView();
+    size_t i = 0;
+    
+#if BEYONDLINK_QUANTIZE_SSE2
+    const __m128 snorm = _mm_set1_ps(SnormScale);
+    const __m128 unorm = _mm_set1_ps(UnormScale);
+    const __m128 minusOne = _mm_set1_ps(-1.0f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    
+    for (; i + 4 <= count; i += 4) {
+        alignas(16) int x[4], y[4], r[4], g[4], b[4], focus[4], extra[4], beam[4];
+        for (int lane = 0; lane < 4; ++lane) {
+            const QuantizedPoint& point = points[i + lane];
+            x[lane] = point.X;
+            y[lane] = point.Y;
+            r[lane] = point.R;
+            g[lane] = point.G;
+            b[lane] = point.B;
+            focus[lane] = point.Focus;
+            extra[lane] = point.Extra;
+            beam[lane] = (point.Flags & QuantizedBeam) ? -1 : 0;
+        }
+        
+        __m128 beamMask = _mm_castsi128_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(beam)));
+        __m128 extraF = _mm_cvtepi32_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(extra)));
+        __m128 gain = _mm_add_ps(one, _mm_div_ps(extraF, _mm_set1_ps(GainSteps)));
+        gain = _mm_or_ps(_mm_and_ps(beamMask, one), _mm_andnot_ps(beamMask, gain));
+        __m128 z = _mm_and_ps(beamMask, _mm_div_ps(extraF, unorm));
+        
+        auto decodeUnorm = [&](const int* values) {
+            return _mm_div_ps(_mm_cvtepi32_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(values))), unorm);
+        };
+        auto decodeSnorm = [&](const int* values) {
+            return _mm_max_ps(minusOne, _mm_div_ps(_mm_cvtepi32_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(values))), snorm));
+        };
+        
+        _mm_storeu_ps(out.X + i, decodeSnorm(x));
+        _mm_storeu_ps(out.Y + i, decodeSnorm(y));
+        _mm_storeu_ps(out.R + i, _mm_mul_ps(decodeUnorm(r), gain));
+        _mm_storeu_ps(out.G + i, _mm_mul_ps(decodeUnorm(g), gain));
+        _mm_storeu_ps(out.B + i, _mm_mul_ps(decodeUnorm(b), gain));
+        _mm_storeu_ps(out.Z + i, z);
+        _mm_storeu_ps(out.Focus + i, decodeUnorm(focus));
+    }
+#endif
+    
+    for (; i < count; ++i) {
+        out.SetPoint(i, DequantizePoint(points[i]));
+    }
+}
+
+} // namespace Core
+} // namespace BeyondLink
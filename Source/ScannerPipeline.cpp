@@ -0,0 +1,2390 @@
+﻿//==============================================================================
+// BeyondLink - Beyond激光可视化系统
+// 文件：ScannerPipeline.cpp
+// 作者：Yunsio
+// 日期：2025-10-06
+// 描述：扫描仪模拟流式处理实现
+//       运算顺序与逐步物化的参考路径（Tests/ReferencePipeline）保持一致，保证逐位相同
+//       各参数组合编译为独立的模板实例，由 Select 在设置变化时选择
+//==============================================================================
+
+#include "ScannerPipeline.h"
+#include "WorkerPool.h"
+#include "FrameArena.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define BEYONDLINK_SCAN_SSE2 1
+#endif
+
+// AVX 着色路径：运行时检测 CPU 支持，不要求整个工程以 /arch:AVX 编译
+#if defined(BEYONDLINK_SCAN_SSE2) && (defined(_M_X64) || defined(__x86_64__))
+#include <immintrin.h>
+#define BEYONDLINK_SCAN_AVX 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define BEYONDLINK_TARGET_AVX
+#else
+#define BEYONDLINK_TARGET_AVX __attribute__((target("avx")))
+#endif
+#endif
+
+namespace BeyondLink {
+namespace Core {
+
+namespace {
+
+// 样本数类别（模板参数）：大于 1 的值表示编译期固定的样本数
+constexpr int SampleClassGeneric = 0;            // 运行时样本数（> 1）
+constexpr int SampleClassNone = 1;               // 不插值（SampleCount <= 1）
+constexpr int SampleClassAdaptive = -1;          // 按段长自适应样本数
+
+// 光束降采样倍数：不输出光束点列表
+constexpr int NoBeamOutput = -1;
+
+// 并行扫描的最小块长度（样本数），块过短时同步开销大于收益
+constexpr size_t MinScanBlockSamples = 4096;
+
+// 分块预热窗口：初始误差衰减目标和最短窗口（样本数）
+constexpr double WarmUpTolerance = 1e-9;
+constexpr size_t MinWarmUpSamples = 64;
+
+// 延迟着色的速度平方下限（避免 rsqrt(0)，对应强度已被钳制到 4）
+constexpr float MinShadingSpeedSq = 1e-30f;
+
+// 振镜模型：脉冲响应截断处的衰减包络、最大系数数，以及 FIR 卷积分块并行的块长度
+constexpr double GalvoTailTolerance = 1e-6;
+constexpr size_t MaxGalvoTaps = 1024;
+constexpr size_t GalvoBlockSamples = 16384;
+
+// 曲线插值：相邻段方向夹角的余弦下限（转角超过 60° 视为拐角，保持折线）
+constexpr float CurveCornerCosine = 0.5f;
+
+// 点预算抽取：方向累计转角的余弦下限（cos 30°）与颜色变化阈值（RGB 绝对差之和）
+constexpr float BudgetTurnCosine = 0.8660254f;
+constexpr float BudgetColorStep = 0.25f;
+
+// 点预算抽取的点分类
+enum BudgetClass : uint8_t {
+    BudgetOptional = 0,                          // 可抽取的可见点
+    BudgetBlank = 1,                             // 可移除的空白点
+    BudgetKeep = 2                               // 必须保留
+};
+
+//==========================================================================
+// 函数：IsSamePosition
+// 描述：判断两个位置是否相同（与 LaserPoint::IsSamePosition 的默认误差一致）
+//==========================================================================
+inline bool IsSamePosition(float x0, float y0, float x1, float y1) {
+    return std::abs(x0 - x1) < 0.0001f && std::abs(y0 - y1) < 0.0001f;
+}
+
+//==========================================================================
+// 函数：IsBlank
+// 描述：判断颜色是否为空白（与 LaserPoint::IsBlankPoint 一致）
+//==========================================================================
+inline bool IsBlank(float r, float g, float b) {
+    return r <= 0.0001f && g <= 0.0001f && b <= 0.0001f;
+}
+
+//==========================================================================
+// 函数：IsSimplifyLink
+// 描述：输入简化：相邻点 i 与 i + 1 是否可并入同一折线（属性相同且不是驻留的重复位置）
+//       两侧都可并入的非光束点才允许移除
+//==========================================================================
+inline bool IsSimplifyLink(const FrameView& raw, size_t i) {
+    const size_t j = i + 1;
+    return raw.R[j] == raw.R[i] && raw.G[j] == raw.G[i] && raw.B[j] == raw.B[i] &&
+           raw.Z[j] == raw.Z[i] && raw.Focus[j] == raw.Focus[i] &&
+           !IsSamePosition(raw.X[i], raw.Y[i], raw.X[j], raw.Y[j]);
+}
+
+//==========================================================================
+// 函数：FindFarthestPoint
+// 描述：在 (first, last) 内查找到线段 first-last 距离平方最大且超过 limitSq 的点
+// 返回值：
+//   点序号，没有超过 limitSq 的点时返回 0
+//==========================================================================
+inline size_t FindFarthestPoint(const FrameView& raw, size_t first, size_t last, float limitSq) {
+    const float x0 = raw.X[first];
+    const float y0 = raw.Y[first];
+    const float dx = raw.X[last] - x0;
+    const float dy = raw.Y[last] - y0;
+    const float lengthSq = dx * dx + dy * dy;
+    const float inverseLengthSq = lengthSq > 0.0f ? 1.0f / lengthSq : 0.0f;
+    size_t farthest = 0;
+    for (size_t i = first + 1; i < last; ++i) {
+        const float px = raw.X[i] - x0;
+        const float py = raw.Y[i] - y0;
+        const float t = (std::min)(1.0f, (std::max)(0.0f, (px * dx + py * dy) * inverseLengthSq));
+        const float ex = px - dx * t;
+        const float ey = py - dy * t;
+        const float distanceSq = ex * ex + ey * ey;
+        if (distanceSq > limitSq) {
+            limitSq = distanceSq;
+            farthest = i;
+        }
+    }
+    return farthest;
+}
+
+//==========================================================================
+// 结构体：HermiteBasis
+// 描述：三次 Hermite 基函数（p(t) = p0 + d × H01 + m0 × H10 + m1 × H11，d 为弦向量）
+//==========================================================================
+struct HermiteBasis {
+    float H01;                                   // 3t² - 2t³
+    float H10;                                   // t³ - 2t² + t
+    float H11;                                   // t³ - t²
+};
+
+//==========================================================================
+// 函数：GetHermiteBasis
+// 描述：计算参数 t 处的 Hermite 基函数
+//==========================================================================
+inline HermiteBasis GetHermiteBasis(float t) {
+    const float t2 = t * t;
+    HermiteBasis basis;
+    basis.H11 = t2 * t - t2;
+    basis.H10 = basis.H11 - t2 + t;
+    basis.H01 = t2 * (3.0f - 2.0f * t);
+    return basis;
+}
+
+//==========================================================================
+// 函数：EvaluateHermite
+// 描述：单轴三次 Hermite 插值（起点 p0，弦 d，两端切线 m0 / m1）
+//==========================================================================
+inline float EvaluateHermite(float p0, float d, float m0, float m1, const HermiteBasis& basis) {
+    return p0 + d * basis.H01 + m0 * basis.H10 + m1 * basis.H11;
+}
+
+//==========================================================================
+// 结构体：CurveTangents
+// 描述：原始段两端的切线
+//==========================================================================
+struct CurveTangents {
+    float StartX;
+    float StartY;
+    float EndX;
+    float EndY;
+};
+
+//==========================================================================
+// 函数：GetSegmentKind
+// 描述：原始段 i 的类型（0 = 普通，1 = 消隐，2 = 光束），类型不同的相邻段之间不平滑
+//==========================================================================
+inline float GetSegmentKind(const FrameView& raw, size_t i) {
+    if (IsBlank(raw.R[i], raw.G[i], raw.B[i]) && IsBlank(raw.R[i + 1], raw.G[i + 1], raw.B[i + 1])) {
+        return 1.0f;
+    }
+    return raw.Z[i] > 0.0f ? 2.0f : 0.0f;
+}
+
+//==========================================================================
+// 函数：GetCurveTangents
+// 描述：原始段 i 两端的切线（规则见 ScannerPipeline::GetSamplePosition）
+//       运算顺序与 BuildCurveTangents 的 SSE 路径相同，结果逐位一致
+//==========================================================================
+inline CurveTangents GetCurveTangents(const FrameView& raw, size_t i, LaserSettings::InterpolationMode mode) {
+    const bool hermite = mode == LaserSettings::InterpolationMode::Hermite;
+    const float kind = GetSegmentKind(raw, i);
+    const float d1x = raw.X[i + 1] - raw.X[i];
+    const float d1y = raw.Y[i + 1] - raw.Y[i];
+    const float l1 = std::sqrt(d1x * d1x + d1y * d1y);
+    CurveTangents tangents{ d1x, d1y, d1x, d1y };
+    
+    // 零长度的相邻段使点积为 0，不满足转角条件
+    if (i > 0 && GetSegmentKind(raw, i - 1) == kind) {
+        const float d0x = raw.X[i] - raw.X[i - 1];
+        const float d0y = raw.Y[i] - raw.Y[i - 1];
+        const float l0 = std::sqrt(d0x * d0x + d0y * d0y);
+        if (d0x * d1x + d0y * d1y > CurveCornerCosine * l0 * l1) {
+            const float scale = hermite ? l1 / (l0 + l1) : 0.5f;
+            tangents.StartX = (d0x + d1x) * scale;
+            tangents.StartY = (d0y + d1y) * scale;
+        }
+    }
+    if (i + 2 < raw.Count && GetSegmentKind(raw, i + 1) == kind) {
+        const float d2x = raw.X[i + 2] - raw.X[i + 1];
+        const float d2y = raw.Y[i + 2] - raw.Y[i + 1];
+        const float l2 = std::sqrt(d2x * d2x + d2y * d2y);
+        if (d1x * d2x + d1y * d2y > CurveCornerCosine * l1 * l2) {
+            const float scale = hermite ? l1 / (l1 + l2) : 0.5f;
+            tangents.EndX = (d1x + d2x) * scale;
+            tangents.EndY = (d1y + d2y) * scale;
+        }
+    }
+    return tangents;
+}
+
+//==========================================================================
+// 函数：BuildCurveTangents
+// 描述：批量计算全部原始段的切线，写入 [起点 X | 起点 Y | 终点 X | 终点 Y] 四个数组
+//       先计算各段类型，内部段每次 4 段用 SSE 计算（无分支，拐角等条件用掩码选择），
+//       帧首尾的段逐段计算
+// 参数：
+//   raw - 原始点（至少 2 个点）
+//   mode - 插值方式（三次）
+//   kinds - 暂存：各段类型（段数个）
+//   tangents - [输出] 切线数组（4 × 段数个）
+//==========================================================================
+void BuildCurveTangents(const FrameView& raw, LaserSettings::InterpolationMode mode, float* kinds, float* tangents) {
+    const size_t segmentCount = raw.Count - 1;
+    float* startX = tangents;
+    float* startY = tangents + segmentCount;
+    float* endX = tangents + 2 * segmentCount;
+    float* endY = tangents + 3 * segmentCount;
+    auto storeScalar = [&](size_t i) {
+        const CurveTangents t = GetCurveTangents(raw, i, mode);
+        startX[i] = t.StartX;
+        startY[i] = t.StartY;
+        endX[i] = t.EndX;
+        endY[i] = t.EndY;
+    };
+    
+    size_t i = 0;
+#if BEYONDLINK_SCAN_SSE2
+    for (size_t s = 0; s < segmentCount; ++s) {
+        kinds[s] = GetSegmentKind(raw, s);
+    }
+    
+    // 段 i 读取点 i-1 到 i+2：4 段一组要求 i + 4 < 段数
+    const bool hermite = mode == LaserSettings::InterpolationMode::Hermite;
+    const __m128 cornerCosine = _mm_set1_ps(CurveCornerCosine);
+    const __m128 half = _mm_set1_ps(0.5f);
+    auto select = [](__m128 mask, __m128 a, __m128 b) {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    };
+    storeScalar(0);
+    for (i = 1; i + 4 < segmentCount; i += 4) {
+        const __m128 xPrev = _mm_loadu_ps(raw.X + i - 1);
+        const __m128 yPrev = _mm_loadu_ps(raw.Y + i - 1);
+        const __m128 x0 = _mm_loadu_ps(raw.X + i);
+        const __m128 y0 = _mm_loadu_ps(raw.Y + i);
+        const __m128 x1 = _mm_loadu_ps(raw.X + i + 1);
+        const __m128 y1 = _mm_loadu_ps(raw.Y + i + 1);
+        const __m128 x2 = _mm_loadu_ps(raw.X + i + 2);
+        const __m128 y2 = _mm_loadu_ps(raw.Y + i + 2);
+        const __m128 kind = _mm_loadu_ps(kinds + i);
+        
+        const __m128 d0x = _mm_sub_ps(x0, xPrev);
+        const __m128 d0y = _mm_sub_ps(y0, yPrev);
+        const __m128 d1x = _mm_sub_ps(x1, x0);
+        const __m128 d1y = _mm_sub_ps(y1, y0);
+        const __m128 d2x = _mm_sub_ps(x2, x1);
+        const __m128 d2y = _mm_sub_ps(y2, y1);
+        const __m128 l0 = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(d0x, d0x), _mm_mul_ps(d0y, d0y)));
+        const __m128 l1 = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(d1x, d1x), _mm_mul_ps(d1y, d1y)));
+        const __m128 l2 = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(d2x, d2x), _mm_mul_ps(d2y, d2y)));
+        
+        const __m128 startSmooth = _mm_and_ps(
+            _mm_cmpeq_ps(_mm_loadu_ps(kinds + i - 1), kind),
+            _mm_cmpgt_ps(_mm_add_ps(_mm_mul_ps(d0x, d1x), _mm_mul_ps(d0y, d1y)),
+                         _mm_mul_ps(_mm_mul_ps(cornerCosine, l0), l1)));
+        const __m128 endSmooth = _mm_and_ps(
+            _mm_cmpeq_ps(_mm_loadu_ps(kinds + i + 1), kind),
+            _mm_cmpgt_ps(_mm_add_ps(_mm_mul_ps(d1x, d2x), _mm_mul_ps(d1y, d2y)),
+                         _mm_mul_ps(_mm_mul_ps(cornerCosine, l1), l2)));
+        const __m128 startScale = hermite ? _mm_div_ps(l1, _mm_add_ps(l0, l1)) : half;
+        const __m128 endScale = hermite ? _mm_div_ps(l1, _mm_add_ps(l1, l2)) : half;
+        
+        _mm_storeu_ps(startX + i, select(startSmooth, _mm_mul_ps(_mm_add_ps(d0x, d1x), startScale), d1x));
+        _mm_storeu_ps(startY + i, select(startSmooth, _mm_mul_ps(_mm_add_ps(d0y, d1y), startScale), d1y));
+        _mm_storeu_ps(endX + i, select(endSmooth, _mm_mul_ps(_mm_add_ps(d1x, d2x), endScale), d1x));
+        _mm_storeu_ps(endY + i, select(endSmooth, _mm_mul_ps(_mm_add_ps(d1y, d2y), endScale), d1y));
+    }
+#else
+    (void)kinds;
+#endif
+    for (; i < segmentCount; ++i) {
+        storeScalar(i);
+    }
+}
+
+//==========================================================================
+// 函数：RunPassthrough
+// 描述：不启用扫描仪模拟时的实例：原始点直接作为主点和光束点输出
+//       不输出光束点时原始点直接复制到主点列表
+//==========================================================================
+template <bool BeamBrush>
+void RunPassthrough(const FrameView& raw, const ScannerPipelineParams& params,
+                    LaserFrame& processed, LaserFrame& beam) {
+    if (params.BeamOutput || !BeamBrush) {
+        const size_t bytes = raw.Count * sizeof(float);
+        const float* channels[LaserFrame::ChannelCount] = { raw.X, raw.Y, raw.R, raw.G, raw.B, raw.Z, raw.Focus };
+        
+        LaserFrame& copy = params.BeamOutput ? beam : processed;
+        copy.Resize(raw.Count);
+        MutableFrameView copyOut = copy.MutableView();
+        float* copyChannels[LaserFrame::ChannelCount] = {
+            copyOut.X, copyOut.Y, copyOut.R, copyOut.G, copyOut.B, copyOut.Z, copyOut.Focus };
+        for (size_t c = 0; c < LaserFrame::ChannelCount && bytes > 0; ++c) {
+            std::memcpy(copyChannels[c], channels[c], bytes);
+        }
+    }
+    if (!params.BeamOutput) {
+        beam.Clear();
+    }
+    
+    if (!BeamBrush) {
+        if (params.BeamOutput) {
+            processed.AssignFrom(beam);
+        }
+        return;
+    }
+    
+    // 光束画刷：只保留与上一个保留点位置不同的点
+    processed.Resize(raw.Count);
+    MutableFrameView out = processed.MutableView();
+    size_t kept = 0;
+    for (size_t i = 0; i < raw.Count; ++i) {
+        if (kept > 0 && IsSamePosition(raw.X[i], raw.Y[i], out.X[kept - 1], out.Y[kept - 1])) {
+            continue;
+        }
+        out.SetPoint(kept++, raw.GetPoint(i));
+    }
+    processed.Resize(kept);
+}
+
+//==========================================================================
+// 函数：GetCellIndex
+// 描述：坐标所在的 LOD 网格单元（向下取整）
+//       左/下方视口外的坐标（及 NaN）归入单元 -1，不会与视口内的点合并
+//==========================================================================
+inline int32_t GetCellIndex(float coordinate, float cellsPerUnit) {
+    const float cell = (std::min)((std::max)(-1.0f, (coordinate + 1.0f) * cellsPerUnit), 1e9f);
+    return static_cast<int32_t>(cell + 1.0f) - 1;
+}
+
+//==========================================================================
+// 函数：CompactDuplicatePositions
+// 描述：原地移除与上一个保留点位置相同的点（并行扫描输出的光束画刷去重）
+//==========================================================================
+void CompactDuplicatePositions(LaserFrame& points) {
+    if (points.Empty()) {
+        return;
+    }
+    
+    MutableFrameView view = points.MutableView();
+    size_t kept = 1;
+    for (size_t i = 1; i < view.Count; ++i) {
+        if (!IsSamePosition(view.X[i], view.Y[i], view.X[kept - 1], view.Y[kept - 1])) {
+            if (kept != i) {
+                view.SetPoint(kept, view.GetPoint(i));
+            }
+            kept++;
+        }
+    }
+    points.Resize(kept);
+}
+
+//==========================================================================
+// 函数：CompactBlocks
+// 描述：分块输出拼接：各块保留的样本 [firsts[b], ends[b]) 依次前移，使块之间连续
+// 返回值：
+//   拼接后的样本数
+//==========================================================================
+size_t CompactBlocks(const MutableFrameView& view, const std::vector<size_t>& firsts,
+                     const std::vector<size_t>& ends) {
+    float* channels[LaserFrame::ChannelCount] = { view.X, view.Y, view.R, view.G, view.B, view.Z, view.Focus };
+    size_t kept = 0;
+    for (size_t block = 0; block < firsts.size(); ++block) {
+        const size_t count = ends[block] - firsts[block];
+        if (kept != firsts[block] && count > 0) {
+            for (size_t c = 0; c < LaserFrame::ChannelCount; ++c) {
+                std::memmove(channels[c] + kept, channels[c] + firsts[block], count * sizeof(float));
+            }
+        }
+        kept += count;
+    }
+    return kept;
+}
+
+//==========================================================================
+// 结构体：RecurrenceState
+// 描述：扫描仪速度/位置递推状态
+//==========================================================================
+struct RecurrenceState {
+    float VelX = 0.0f;
+    float VelY = 0.0f;
+    float PosX = 0.0f;
+    float PosY = 0.0f;
+};
+
+//==========================================================================
+// 结构体：SegmentRate
+// 描述：单个原始段的插值与递推参数（自适应插值时按段的样本数查表）
+//==========================================================================
+struct SegmentRate {
+    const float* T;                              // 插值参数表
+    float Alpha;                                 // 速度平滑系数（1 - 平滑因子）
+    float Step;                                  // 位置步长
+    float Weight;                                // 淡化样本的颜色权重
+};
+
+//==========================================================================
+// 结构体：KernelOutput
+// 描述：内核输出位置
+//       保留的样本写入 Processed[ProcessedKept++] / Beam[BeamKept++]；
+//       延迟着色时颜色不缩放，速度平方写入 *Speed（不淡化的样本写入 -1）
+//       CulledSamples 累计消隐段中未输出的样本数
+//==========================================================================
+struct KernelOutput {
+    MutableFrameView Processed;
+    MutableFrameView Beam;
+    size_t ProcessedKept = 0;
+    size_t BeamKept = 0;
+    size_t CulledSamples = 0;
+    float* ProcessedSpeed = nullptr;
+    float* BeamSpeed = nullptr;
+};
+
+//==========================================================================
+// 结构体：ShadingConstants
+// 描述：延迟着色常量：intensity = min(4, Gain / |v|) × Scale + Offset
+//==========================================================================
+struct ShadingConstants {
+    float Gain;
+    float Scale;
+    float Offset;
+};
+
+//==========================================================================
+// 函数：GetShadingConstants
+// 描述：由边缘淡化因子计算延迟着色常量（float 运算，与逐样本路径的 double 除法相差舍入误差）
+//==========================================================================
+inline ShadingConstants GetShadingConstants(float edgeFade) {
+    const float fade = (std::max)(0.1f, edgeFade);
+    const double divisor = (std::max)(1.0, fade * 2.0 * 4.0);
+    const float fadePercent = static_cast<float>((std::max)(0.0, fade - 0.5) * 2.0);
+    ShadingConstants shading;
+    shading.Gain = 0.2f * fade * 2.0f;
+    shading.Scale = (1.0f - fadePercent) / static_cast<float>(divisor);
+    shading.Offset = fadePercent;
+    return shading;
+}
+
+//==========================================================================
+// 函数：ShadeSamplesScalar
+// 描述：延迟着色的标量实现（无 SIMD 时及 SIMD 循环尾部使用）
+//==========================================================================
+inline void ShadeSamplesScalar(const MutableFrameView& out, const float* speedSq,
+                               size_t first, size_t last, const ShadingConstants& shading) {
+    for (size_t i = first; i < last; ++i) {
+        if (speedSq[i] < 0.0f) {
+            continue;
+        }
+        const float inverseLength = 1.0f / std::sqrt((std::max)(speedSq[i], MinShadingSpeedSq));
+        const float intensity = (std::min)(4.0f, shading.Gain * inverseLength) * shading.Scale + shading.Offset;
+        out.R[i] *= intensity;
+        out.G[i] *= intensity;
+        out.B[i] *= intensity;
+    }
+}
+
+#if BEYONDLINK_SCAN_SSE2
+//==========================================================================
+// 函数：ShadeSamplesSSE
+// 描述：延迟着色的 SSE 实现（4 通道，rsqrt + 一次牛顿迭代）
+//==========================================================================
+inline void ShadeSamplesSSE(const MutableFrameView& out, const float* speedSq,
+                            size_t first, size_t last, const ShadingConstants& shading) {
+    const __m128 gain = _mm_set1_ps(shading.Gain);
+    const __m128 scale = _mm_set1_ps(shading.Scale);
+    const __m128 offset = _mm_set1_ps(shading.Offset);
+    const __m128 maxIntensity = _mm_set1_ps(4.0f);
+    const __m128 minSpeed = _mm_set1_ps(MinShadingSpeedSq);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 threeHalves = _mm_set1_ps(1.5f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 zero = _mm_setzero_ps();
+    
+    size_t i = first;
+    for (; i + 4 <= last; i += 4) {
+        const __m128 speed = _mm_loadu_ps(speedSq + i);
+        const __m128 fade = _mm_cmpge_ps(speed, zero);
+        const __m128 clamped = _mm_max_ps(speed, minSpeed);
+        __m128 inverse = _mm_rsqrt_ps(clamped);
+        inverse = _mm_mul_ps(inverse, _mm_sub_ps(threeHalves, _mm_mul_ps(_mm_mul_ps(half, clamped), _mm_mul_ps(inverse, inverse))));
+        __m128 intensity = _mm_min_ps(maxIntensity, _mm_mul_ps(gain, inverse));
+        intensity = _mm_add_ps(_mm_mul_ps(intensity, scale), offset);
+        intensity = _mm_or_ps(_mm_and_ps(fade, intensity), _mm_andnot_ps(fade, one));
+        _mm_storeu_ps(out.R + i, _mm_mul_ps(_mm_loadu_ps(out.R + i), intensity));
+        _mm_storeu_ps(out.G + i, _mm_mul_ps(_mm_loadu_ps(out.G + i), intensity));
+        _mm_storeu_ps(out.B + i, _mm_mul_ps(_mm_loadu_ps(out.B + i), intensity));
+    }
+    ShadeSamplesScalar(out, speedSq, i, last, shading);
+}
+#endif
+
+#if BEYONDLINK_SCAN_AVX
+//==========================================================================
+// 函数：ShadeSamplesAVX
+// 描述：延迟着色的 AVX 实现（8 通道，运行时检测 CPU 支持后使用）
+//==========================================================================
+BEYONDLINK_TARGET_AVX void ShadeSamplesAVX(const MutableFrameView& out, const float* speedSq,
+                                           size_t first, size_t last, const ShadingConstants& shading) {
+    const __m256 gain = _mm256_set1_ps(shading.Gain);
+    const __m256 scale = _mm256_set1_ps(shading.Scale);
+    const __m256 offset = _mm256_set1_ps(shading.Offset);
+    const __m256 maxIntensity = _mm256_set1_ps(4.0f);
+    const __m256 minSpeed = _mm256_set1_ps(MinShadingSpeedSq);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 threeHalves = _mm256_set1_ps(1.5f);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 zero = _mm256_setzero_ps();
+    
+    size_t i = first;
+    for (; i + 8 <= last; i += 8) {
+        const __m256 speed = _mm256_loadu_ps(speedSq + i);
+        const __m256 fade = _mm256_cmp_ps(speed, zero, _CMP_GE_OQ);
+        const __m256 clamped = _mm256_max_ps(speed, minSpeed);
+        __m256 inverse = _mm256_rsqrt_ps(clamped);
+        inverse = _mm256_mul_ps(inverse, _mm256_sub_ps(threeHalves, _mm256_mul_ps(_mm256_mul_ps(half, clamped), _mm256_mul_ps(inverse, inverse))));
+        __m256 intensity = _mm256_min_ps(maxIntensity, _mm256_mul_ps(gain, inverse));
+        intensity = _mm256_add_ps(_mm256_mul_ps(intensity, scale), offset);
+        intensity = _mm256_blendv_ps(one, intensity, fade);
+        _mm256_storeu_ps(out.R + i, _mm256_mul_ps(_mm256_loadu_ps(out.R + i), intensity));
+        _mm256_storeu_ps(out.G + i, _mm256_mul_ps(_mm256_loadu_ps(out.G + i), intensity));
+        _mm256_storeu_ps(out.B + i, _mm256_mul_ps(_mm256_loadu_ps(out.B + i), intensity));
+    }
+    ShadeSamplesSSE(out, speedSq, i, last, shading);
+}
+
+//==========================================================================
+// 函数：HasAvx
+// 描述：检测 CPU 和操作系统是否支持 AVX（结果缓存）
+//==========================================================================
+bool HasAvx() {
+    static const bool supported = []() {
+#if defined(_MSC_VER)
+        int info[4] = {};
+        __cpuid(info, 1);
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+        return osxsave && avx && (_xgetbv(0) & 0x6) == 0x6;
+#else
+        return __builtin_cpu_supports("avx") != 0;
+#endif
+    }();
+    return supported;
+}
+#endif
+
+//==========================================================================
+// 函数：ShadeSamples
+// 描述：延迟着色：按记录的速度计算边缘淡化强度并缩放颜色（纯 float 运算）
+//==========================================================================
+inline void ShadeSamples(const MutableFrameView& out, const float* speedSq,
+                         size_t first, size_t last, const ShadingConstants& shading) {
+#if BEYONDLINK_SCAN_AVX
+    if (HasAvx()) {
+        ShadeSamplesAVX(out, speedSq, first, last, shading);
+        return;
+    }
+#endif
+#if BEYONDLINK_SCAN_SSE2
+    ShadeSamplesSSE(out, speedSq, first, last, shading);
+#else
+    ShadeSamplesScalar(out, speedSq, first, last, shading);
+#endif
+}
+
+//==========================================================================
+// 函数：ConvolveTapsScalar
+// 描述：FIR 卷积的标量实现：output[n] = Σ taps[i] × input[n + i]，n ∈ [first, last)
+//       taps 按窗口顺序存放（反转的脉冲响应）；SIMD 实现各通道的累加顺序与此相同，结果逐位一致
+//==========================================================================
+inline void ConvolveTapsScalar(const float* input, const float* taps, size_t tapCount,
+                               size_t first, size_t last, float* output) {
+    for (size_t n = first; n < last; ++n) {
+        float sum = 0.0f;
+        for (size_t i = 0; i < tapCount; ++i) {
+            sum += taps[i] * input[n + i];
+        }
+        output[n] = sum;
+    }
+}
+
+#if BEYONDLINK_SCAN_SSE2
+//==========================================================================
+// 函数：ConvolveTapsSSE
+// 描述：FIR 卷积的 SSE 实现：每次 16 个相邻输出（4 个累加器共用一次系数广播，隐藏加法延迟），
+//       随后逐组 4 个，尾部标量
+//==========================================================================
+inline void ConvolveTapsSSE(const float* input, const float* taps, size_t tapCount,
+                            size_t first, size_t last, float* output) {
+    size_t n = first;
+    for (; n + 16 <= last; n += 16) {
+        const float* window = input + n;
+        __m128 sum0 = _mm_setzero_ps();
+        __m128 sum1 = _mm_setzero_ps();
+        __m128 sum2 = _mm_setzero_ps();
+        __m128 sum3 = _mm_setzero_ps();
+        for (size_t i = 0; i < tapCount; ++i) {
+            const __m128 tap = _mm_set1_ps(taps[i]);
+            sum0 = _mm_add_ps(sum0, _mm_mul_ps(tap, _mm_loadu_ps(window + i)));
+            sum1 = _mm_add_ps(sum1, _mm_mul_ps(tap, _mm_loadu_ps(window + i + 4)));
+            sum2 = _mm_add_ps(sum2, _mm_mul_ps(tap, _mm_loadu_ps(window + i + 8)));
+            sum3 = _mm_add_ps(sum3, _mm_mul_ps(tap, _mm_loadu_ps(window + i + 12)));
+        }
+        _mm_storeu_ps(output + n, sum0);
+        _mm_storeu_ps(output + n + 4, sum1);
+        _mm_storeu_ps(output + n + 8, sum2);
+        _mm_storeu_ps(output + n + 12, sum3);
+    }
+    for (; n + 4 <= last; n += 4) {
+        __m128 sum = _mm_setzero_ps();
+        for (size_t i = 0; i < tapCount; ++i) {
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(taps[i]), _mm_loadu_ps(input + n + i)));
+        }
+        _mm_storeu_ps(output + n, sum);
+    }
+    ConvolveTapsScalar(input, taps, tapCount, n, last, output);
+}
+#endif
+
+#if BEYONDLINK_SCAN_AVX
+//==========================================================================
+// 函数：ConvolveTapsAVX
+// 描述：FIR 卷积的 AVX 实现：每次 32 个相邻输出，剩余部分交给 SSE 实现（不使用 FMA，与标量逐位一致）
+//==========================================================================
+BEYONDLINK_TARGET_AVX void ConvolveTapsAVX(const float* input, const float* taps, size_t tapCount,
+                                           size_t first, size_t last, float* output) {
+    size_t n = first;
+    for (; n + 32 <= last; n += 32) {
+        const float* window = input + n;
+        __m256 sum0 = _mm256_setzero_ps();
+        __m256 sum1 = _mm256_setzero_ps();
+        __m256 sum2 = _mm256_setzero_ps();
+        __m256 sum3 = _mm256_setzero_ps();
+        for (size_t i = 0; i < tapCount; ++i) {
+            const __m256 tap = _mm256_set1_ps(taps[i]);
+            sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(tap, _mm256_loadu_ps(window + i)));
+            sum1 = _mm256_add_ps(sum1, _mm256_mul_ps(tap, _mm256_loadu_ps(window + i + 8)));
+            sum2 = _mm256_add_ps(sum2, _mm256_mul_ps(tap, _mm256_loadu_ps(window + i + 16)));
+            sum3 = _mm256_add_ps(sum3, _mm256_mul_ps(tap, _mm256_loadu_ps(window + i + 24)));
+        }
+        _mm256_storeu_ps(output + n, sum0);
+        _mm256_storeu_ps(output + n + 8, sum1);
+        _mm256_storeu_ps(output + n + 16, sum2);
+        _mm256_storeu_ps(output + n + 24, sum3);
+    }
+    ConvolveTapsSSE(input, taps, tapCount, n, last, output);
+}
+#endif
+
+//==========================================================================
+// 函数：ConvolveTaps
+// 描述：FIR 卷积（按 CPU 支持选择 AVX / SSE / 标量实现）
+//==========================================================================
+inline void ConvolveTaps(const float* input, const float* taps, size_t tapCount,
+                         size_t first, size_t last, float* output) {
+#if BEYONDLINK_SCAN_AVX
+    if (HasAvx()) {
+        ConvolveTapsAVX(input, taps, tapCount, first, last, output);
+        return;
+    }
+#endif
+#if BEYONDLINK_SCAN_SSE2
+    ConvolveTapsSSE(input, taps, tapCount, first, last, output);
+#else
+    ConvolveTapsScalar(input, taps, tapCount, first, last, output);
+#endif
+}
+
+//==========================================================================
+// 类：SimulationKernel
+// 描述：扫描仪模拟内核
+//       ProcessedFactor / BeamFactor - 降采样倍数（0 = 运行时参数，BeamFactor 为 NoBeamOutput 时不输出光束点）
+//       SampleClass - 样本数类别（SampleClassGeneric / SampleClassNone / SampleClassAdaptive / 固定样本数）
+//       Simulate 从给定状态处理一段连续的原始段，串行和分块并行扫描共用
+//       自适应插值时各段样本数不同，段的起始样本序号由前缀和表给出；
+//       输入简化时合并段按代表的原始段数 k 取 k 倍的样本数和时长
+//       三次插值时各段切线在构造时批量计算，非光束段的样本位置取 Hermite 曲线
+//       振镜模型时位置轨迹在构造时由 FIR 卷积得到，Simulate 只读取轨迹并着色
+//==========================================================================
+template <int ProcessedFactor, int BeamFactor, int SampleClass>
+class SimulationKernel {
+public:
+    static constexpr bool Interpolate = SampleClass != SampleClassNone;
+    static constexpr bool EmitBeam = BeamFactor != NoBeamOutput;
+    static constexpr bool Adaptive = SampleClass == SampleClassAdaptive;
+    
+    SimulationKernel(const FrameView& raw, const ScannerPipelineParams& params, const size_t* spans = nullptr)
+        : m_Raw(raw)
+    {
+        const bool runtimeCount = SampleClass == SampleClassGeneric || Adaptive;
+        const int sampleCount = runtimeCount ? params.SampleCount : SampleClass;
+        m_ProcessedFactor = ProcessedFactor > 0 ? static_cast<size_t>(ProcessedFactor)
+                            : static_cast<size_t>((std::max)(1, params.ProcessedFactor));
+        m_BeamFactor = BeamFactor > 0 ? static_cast<size_t>(BeamFactor)
+                       : static_cast<size_t>((std::max)(1, params.BeamFactor));
+        m_SamplesPerSegment = Interpolate ? static_cast<size_t>(sampleCount) : 1;
+        m_SegmentCount = Interpolate ? raw.Count - 1 : raw.Count;
+        m_CullBlank = params.CullBlankSegments;
+        m_Curved = Interpolate && params.Interpolation != LaserSettings::InterpolationMode::Linear;
+        if (m_Curved) {
+            BuildTangentTables(params);
+        }
+        
+        // 循环不变量（与逐步路径的表达式相同，步长使用配置中的原始样本数）
+        m_Smoothing = params.VelocitySmoothing;
+        m_EdgeFade = (std::max)(0.1f, params.EdgeFade);
+        m_StepSize = 100.0f / params.SampleCount * 0.01f;
+        m_IntensityDivisor = (std::max)(1.0, m_EdgeFade * 2.0 * 4.0);
+        m_FadePercent = (std::max)(0.0, m_EdgeFade - 0.5) * 2.0;
+        m_InverseStep = 1.0f / m_StepSize;
+        
+        // 插值参数表 t = s / (S - 1)
+        m_TTable = m_FixedTable;
+        if (Adaptive) {
+            BuildAdaptiveTables(params, spans);
+        } else {
+            if (SampleClass == SampleClassGeneric) {
+                m_DynamicTable.resize(m_SamplesPerSegment);
+                m_TTable = m_DynamicTable.data();
+            }
+            for (size_t s = 0; Interpolate && s < m_SamplesPerSegment; ++s) {
+                m_TTable[s] = static_cast<float>(s) / static_cast<float>(sampleCount - 1);
+            }
+        }
+        
+        m_Filtered = !params.Galvo.Taps.empty();
+        if (m_Filtered) {
+            BuildGalvoPath(params);
+        }
+    }
+    
+    SimulationKernel(const SimulationKernel&) = delete;
+    SimulationKernel& operator=(const SimulationKernel&) = delete;
+    
+    size_t GetSegmentCount() const { return m_SegmentCount; }
+    size_t GetSamplesPerSegment() const { return m_SamplesPerSegment; }
+    size_t GetTotalSamples() const { return GetSegmentFirstSample(m_SegmentCount); }
+    size_t GetSegmentFirstSample(size_t i) const { return Adaptive ? m_FirstSample[i] : i * m_SamplesPerSegment; }
+    size_t GetProcessedFactor() const { return m_ProcessedFactor; }
+    size_t GetBeamFactor() const { return m_BeamFactor; }
+    float GetSmoothing() const { return m_Smoothing; }
+    float GetStepSize() const { return m_StepSize; }
+    bool CullsBlankSegments() const { return m_CullBlank; }
+    bool IsFiltered() const { return m_Filtered; }
+    
+    //==========================================================================
+    // 函数：GetInitialState
+    // 描述：递推初始状态（静止于第一个原始点）
+    //==========================================================================
+    RecurrenceState GetInitialState() const {
+        RecurrenceState state;
+        state.PosX = m_Raw.X[0];
+        state.PosY = m_Raw.Y[0];
+        return state;
+    }
+    
+    //==========================================================================
+    // 函数：GetShadingConstants
+    // 描述：延迟着色常量
+    //==========================================================================
+    ShadingConstants GetShadingConstants() const {
+        return Core::GetShadingConstants(m_EdgeFade);
+    }
+    
+    //==========================================================================
+    // 函数：Simulate
+    // 描述：从 state 开始处理原始段 [firstSegment, lastSegment)，保留的样本写入 output
+    //       DeferShading 为 true 时只做递推并记录速度，颜色由 ShadeSamples 统一缩放
+    //       每段根据起点 Z 选择普通段或光束段循环，普通段不做 Z 判断
+    //       剔除消隐段时两端点均为空白的段只推进递推
+    //==========================================================================
+    template <bool BeamBrush, bool DeferShading>
+    void Simulate(size_t firstSegment, size_t lastSegment, RecurrenceState& state, KernelOutput& output) const {
+        size_t k = GetSegmentFirstSample(firstSegment);
+        for (size_t i = firstSegment; i < lastSegment; ++i) {
+            if (m_CullBlank && IsBlankSegment(i)) {
+                const size_t samples = GetSegmentSamples(i);
+                Advance(i, i + 1, state);
+                k += samples;
+                output.CulledSamples += samples;
+                continue;
+            }
+            
+            // 插值时起点 Z > 0 的段为光束段；不插值时 Z 非零即不淡化
+            const float z0 = m_Raw.Z[i];
+            const bool beamSegment = Interpolate ? (z0 > 0.0f) : !(z0 == 0.0f);
+            if (m_Filtered) {
+                // 振镜模型：位置来自卷积轨迹，曲线已在生成输入样本时计入
+                if (beamSegment) {
+                    SimulateSegment<BeamBrush, DeferShading, true, false, true>(i, k, state, output);
+                } else {
+                    SimulateSegment<BeamBrush, DeferShading, false, false, true>(i, k, state, output);
+                }
+            } else if (beamSegment) {
+                SimulateSegment<BeamBrush, DeferShading, true, false, false>(i, k, state, output);
+            } else if (m_Curved) {
+                SimulateSegment<BeamBrush, DeferShading, false, true, false>(i, k, state, output);
+            } else {
+                SimulateSegment<BeamBrush, DeferShading, false, false, false>(i, k, state, output);
+            }
+        }
+    }
+    
+    //==========================================================================
+    // 函数：Advance
+    // 描述：只推进递推（不输出），与 Simulate 的递推运算完全相同
+    //       振镜模型时直接移动到最后一段末样本的轨迹位置
+    //==========================================================================
+    void Advance(size_t firstSegment, size_t lastSegment, RecurrenceState& state) const {
+        if (m_Filtered) {
+            if (lastSegment > firstSegment) {
+                const size_t last = GetSegmentFirstSample(lastSegment) - 1;
+                state.PosX = m_PathX[last];
+                state.PosY = m_PathY[last];
+            }
+            return;
+        }
+        for (size_t i = firstSegment; i < lastSegment; ++i) {
+            const SegmentRate rate = GetSegmentRate(i);
+            const size_t samples = GetSegmentSamples(i);
+            const size_t next = Interpolate ? i + 1 : i;
+            const float x0 = m_Raw.X[i];
+            const float y0 = m_Raw.Y[i];
+            const float dx = m_Raw.X[next] - x0;
+            const float dy = m_Raw.Y[next] - y0;
+            const bool curved = IsCurvedSegment(i);
+            const CurveTangents tangents = curved ? GetTangents(i) : CurveTangents{};
+            for (size_t s = 0; s < samples; ++s) {
+                const float t = Interpolate ? rate.T[s] : 0.0f;
+                float sampleX = Interpolate ? x0 + dx * t : x0;
+                float sampleY = Interpolate ? y0 + dy * t : y0;
+                if (curved) {
+                    const HermiteBasis basis = GetHermiteBasis(t);
+                    sampleX = EvaluateHermite(x0, dx, tangents.StartX, tangents.EndX, basis);
+                    sampleY = EvaluateHermite(y0, dy, tangents.StartY, tangents.EndY, basis);
+                }
+                const float targetVelX = sampleX - state.PosX;
+                const float targetVelY = sampleY - state.PosY;
+                if ((targetVelX * targetVelX + targetVelY * targetVelY) > 0.0f) {
+                    state.VelX += (targetVelX - state.VelX) * rate.Alpha;
+                    state.VelY += (targetVelY - state.VelY) * rate.Alpha;
+                    state.PosX += state.VelX * rate.Step;
+                    state.PosY += state.VelY * rate.Step;
+                }
+            }
+        }
+    }
+    
+    //==========================================================================
+    // 函数：WarmUp
+    // 描述：估算 firstSegment 起点的递推状态：从前方约 warmUpSamples 个样本处
+    //       以静止状态起步推进递推（窗口覆盖帧起点时从真实初始状态推进）
+    //==========================================================================
+    RecurrenceState WarmUp(size_t firstSegment, size_t warmUpSamples) const {
+        const size_t warmUpSegments = (warmUpSamples + m_SamplesPerSegment - 1) / m_SamplesPerSegment;
+        RecurrenceState state = GetInitialState();
+        size_t start = 0;
+        if (warmUpSegments < firstSegment) {
+            start = firstSegment - warmUpSegments;
+            state.PosX = m_Raw.X[start];
+            state.PosY = m_Raw.Y[start];
+        }
+        Advance(start, firstSegment, state);
+        return state;
+    }
+    
+    //==========================================================================
+    // 函数：AccumulateOffset
+    // 描述：从零状态对原始段 [firstSegment, lastSegment) 的样本应用仿射递推，
+    //       得到该块仿射映射的平移部分 {VelX, VelY, PosX, PosY}
+    //       不做零距离判断（零状态下无意义），两个轴占用 SIMD 的两个通道
+    //       只用于固定样本数（自适应插值各段的仿射映射不同，使用预热窗口）
+    //==========================================================================
+    RecurrenceState AccumulateOffset(size_t firstSegment, size_t lastSegment) const {
+        const float alpha = 1.0f - m_Smoothing;
+#if BEYONDLINK_SCAN_SSE2
+        const __m128 alphaV = _mm_set1_ps(alpha);
+        const __m128 stepV = _mm_set1_ps(m_StepSize);
+        __m128 vel = _mm_setzero_ps();
+        __m128 pos = _mm_setzero_ps();
+        for (size_t i = firstSegment; i < lastSegment; ++i) {
+            const size_t next = Interpolate ? i + 1 : i;
+            const __m128 origin = _mm_setr_ps(m_Raw.X[i], m_Raw.Y[i], 0.0f, 0.0f);
+            const __m128 delta = _mm_sub_ps(_mm_setr_ps(m_Raw.X[next], m_Raw.Y[next], 0.0f, 0.0f), origin);
+            const bool curved = IsCurvedSegment(i);
+            const CurveTangents tangents = curved ? GetTangents(i) : CurveTangents{};
+            const __m128 startTangent = _mm_setr_ps(tangents.StartX, tangents.StartY, 0.0f, 0.0f);
+            const __m128 endTangent = _mm_setr_ps(tangents.EndX, tangents.EndY, 0.0f, 0.0f);
+            for (size_t s = 0; s < m_SamplesPerSegment; ++s) {
+                __m128 sample = Interpolate ? _mm_add_ps(origin, _mm_mul_ps(delta, _mm_set1_ps(m_TTable[s]))) : origin;
+                if (curved) {
+                    const HermiteBasis basis = GetHermiteBasis(m_TTable[s]);
+                    sample = _mm_add_ps(_mm_add_ps(_mm_add_ps(origin, _mm_mul_ps(delta, _mm_set1_ps(basis.H01))),
+                                                   _mm_mul_ps(startTangent, _mm_set1_ps(basis.H10))),
+                                        _mm_mul_ps(endTangent, _mm_set1_ps(basis.H11)));
+                }
+                const __m128 target = _mm_sub_ps(sample, pos);
+                vel = _mm_add_ps(vel, _mm_mul_ps(_mm_sub_ps(target, vel), alphaV));
+                pos = _mm_add_ps(pos, _mm_mul_ps(vel, stepV));
+            }
+        }
+        alignas(16) float velOut[4];
+        alignas(16) float posOut[4];
+        _mm_store_ps(velOut, vel);
+        _mm_store_ps(posOut, pos);
+        RecurrenceState offset;
+        offset.VelX = velOut[0];
+        offset.VelY = velOut[1];
+        offset.PosX = posOut[0];
+        offset.PosY = posOut[1];
+        return offset;
+#else
+        RecurrenceState offset;
+        for (size_t i = firstSegment; i < lastSegment; ++i) {
+            const size_t next = Interpolate ? i + 1 : i;
+            const float x0 = m_Raw.X[i];
+            const float y0 = m_Raw.Y[i];
+            const float dx = m_Raw.X[next] - x0;
+            const float dy = m_Raw.Y[next] - y0;
+            const bool curved = IsCurvedSegment(i);
+            const CurveTangents tangents = curved ? GetTangents(i) : CurveTangents{};
+            for (size_t s = 0; s < m_SamplesPerSegment; ++s) {
+                const float t = Interpolate ? m_TTable[s] : 0.0f;
+                float sampleX = Interpolate ? x0 + dx * t : x0;
+                float sampleY = Interpolate ? y0 + dy * t : y0;
+                if (curved) {
+                    const HermiteBasis basis = GetHermiteBasis(t);
+                    sampleX = EvaluateHermite(x0, dx, tangents.StartX, tangents.EndX, basis);
+                    sampleY = EvaluateHermite(y0, dy, tangents.StartY, tangents.EndY, basis);
+                }
+                const float targetX = sampleX - offset.PosX;
+                const float targetY = sampleY - offset.PosY;
+                offset.VelX += (targetX - offset.VelX) * alpha;
+                offset.VelY += (targetY - offset.VelY) * alpha;
+                offset.PosX += offset.VelX * m_StepSize;
+                offset.PosY += offset.VelY * m_StepSize;
+            }
+        }
+        return offset;
+#endif
+    }
+
+private:
+    //==========================================================================
+    // 函数：GetSegmentSamples
+    // 描述：原始段 i 的样本数
+    //==========================================================================
+    size_t GetSegmentSamples(size_t i) const {
+        return Adaptive ? m_FirstSample[i + 1] - m_FirstSample[i] : m_SamplesPerSegment;
+    }
+    
+    //==========================================================================
+    // 函数：IsBlankSegment
+    // 描述：原始段 i 的所有样本是否为空白（插值时两端点均为空白）
+    //==========================================================================
+    bool IsBlankSegment(size_t i) const {
+        const size_t next = Interpolate ? i + 1 : i;
+        return IsBlank(m_Raw.R[i], m_Raw.G[i], m_Raw.B[i]) && IsBlank(m_Raw.R[next], m_Raw.G[next], m_Raw.B[next]);
+    }
+    
+    //==========================================================================
+    // 函数：IsCurvedSegment
+    // 描述：原始段 i 的样本位置是否取三次曲线（光束段总是线性）
+    //==========================================================================
+    bool IsCurvedSegment(size_t i) const {
+        return m_Curved && !(m_Raw.Z[i] > 0.0f);
+    }
+    
+    //==========================================================================
+    // 函数：GetTangents
+    // 描述：原始段 i 两端的切线（BuildTangentTables 的结果）
+    //==========================================================================
+    CurveTangents GetTangents(size_t i) const {
+        const size_t n = m_SegmentCount;
+        return CurveTangents{ m_Tangents[i], m_Tangents[n + i], m_Tangents[2 * n + i], m_Tangents[3 * n + i] };
+    }
+    
+    //==========================================================================
+    // 函数：BuildTangentTables
+    // 描述：三次插值：批量计算各段切线（从帧内存池分配，未提供时使用成员缓冲）
+    //==========================================================================
+    void BuildTangentTables(const ScannerPipelineParams& params) {
+        const size_t count = 5 * m_SegmentCount;
+        float* storage = nullptr;
+        if (params.Arena) {
+            storage = params.Arena->AllocateArray<float>(count);
+        } else {
+            m_TangentStorage.resize(count);
+            storage = m_TangentStorage.data();
+        }
+        m_Tangents = storage;
+        BuildCurveTangents(m_Raw, params.Interpolation, storage + 4 * m_SegmentCount, storage);
+    }
+    
+    //==========================================================================
+    // 函数：GetSegmentRate
+    // 描述：原始段 i 的插值与递推参数（自适应插值时按段的等分数查表，帧末段多一个终点样本；
+    //       有合并段时取逐段的参数）
+    //==========================================================================
+    SegmentRate GetSegmentRate(size_t i) const {
+        if (Adaptive) {
+            if (m_SpanRates) {
+                return m_SpanRates[i];
+            }
+            const size_t divisions = GetSegmentSamples(i) - (i + 1 == m_SegmentCount ? 1 : 0);
+            return m_Rates[divisions];
+        }
+        return SegmentRate{ m_TTable, 1.0f - m_Smoothing, m_StepSize, 1.0f };
+    }
+    
+    //==========================================================================
+    // 函数：BuildSegmentRate
+    // 描述：d 等分、时长为 nominal 个固定模式样本的段：填写插值参数表 t = s / d（含 s = d）
+    //       并按时长换算递推参数（d = nominal 时与固定模式相同）
+    //==========================================================================
+    SegmentRate BuildSegmentRate(float* t, size_t d, size_t nominal) const {
+        for (size_t s = 0; s <= d; ++s) {
+            t[s] = static_cast<float>(s) / static_cast<float>(d);
+        }
+        
+        const double timeScale = static_cast<double>(nominal) / static_cast<double>(d);
+        SegmentRate rate;
+        rate.T = t;
+        rate.Alpha = 1.0f - m_Smoothing;
+        rate.Step = m_StepSize;
+        rate.Weight = static_cast<float>(timeScale);
+        if (d != nominal && m_Smoothing >= 0.0f) {
+            rate.Alpha = static_cast<float>(1.0 - std::pow(static_cast<double>(m_Smoothing), timeScale));
+            rate.Step = static_cast<float>(m_StepSize * timeScale);
+        }
+        return rate;
+    }
+    
+    //==========================================================================
+    // 函数：BuildAdaptiveTables
+    // 描述：自适应插值：按段长确定各段等分数 d，建立起始样本序号前缀和，
+    //       以及每个 d 的插值参数表 t = s / d 和按段时长换算的递推参数
+    //       spans 非空时第 i 段代表 spans[i] 个原始段：等分数的上下限和段时长都乘以 k，
+    //       k > 1 的段单独建表；未开启自适应插值时（输入简化）每段取 S × k 个样本
+    //==========================================================================
+    void BuildAdaptiveTables(const ScannerPipelineParams& params, const size_t* spans) {
+        const size_t nominal = static_cast<size_t>(params.SampleCount);
+        size_t maxSamples = nominal;
+        size_t minSamples = nominal;
+        double spacing = 0.0;
+        if (params.AdaptiveSampling) {
+            maxSamples = static_cast<size_t>((std::max)(1, params.AdaptiveMaxSamples));
+            minSamples = (std::min)(static_cast<size_t>((std::max)(1, params.AdaptiveMinSamples)), maxSamples);
+            spacing = params.AdaptiveSpacing;
+        }
+        
+        // 每个等分数 d 的参数：d = S 时与固定模式的递推参数相同
+        m_DynamicTable.resize((maxSamples + 1) * (maxSamples + 2) / 2);
+        m_Rates.resize(maxSamples + 1);
+        size_t offset = 0;
+        for (size_t d = 1; d <= maxSamples; ++d) {
+            m_Rates[d] = BuildSegmentRate(m_DynamicTable.data() + offset, d, nominal);
+            offset += d + 1;
+        }
+        
+        // 各段起始样本序号（帧末段包含终点）
+        if (params.Arena) {
+            m_FirstSample = params.Arena->AllocateArray<size_t>(m_SegmentCount + 1);
+        } else {
+            m_FirstSampleStorage.resize(m_SegmentCount + 1);
+            m_FirstSample = m_FirstSampleStorage.data();
+        }
+        size_t first = 0;
+        size_t spanTableSize = 0;
+        for (size_t i = 0; i < m_SegmentCount; ++i) {
+            const size_t span = spans ? spans[i] : 1;
+            size_t divisions = maxSamples * span;
+            if (spacing > 0.0) {
+                const double dx = static_cast<double>(m_Raw.X[i + 1]) - m_Raw.X[i];
+                const double dy = static_cast<double>(m_Raw.Y[i + 1]) - m_Raw.Y[i];
+                const double ratio = std::ceil(std::sqrt(dx * dx + dy * dy) / spacing);
+                if (ratio < static_cast<double>(divisions)) {
+                    divisions = (std::max)(minSamples * span, static_cast<size_t>(ratio));
+                }
+            }
+            m_FirstSample[i] = first;
+            first += divisions;
+            if (span > 1) {
+                spanTableSize += divisions + 1;
+            }
+        }
+        m_FirstSample[m_SegmentCount] = first + 1;
+        if (spanTableSize == 0) {
+            return;
+        }
+        
+        // 合并段：逐段参数（k = 1 的段引用共享表）
+        float* spanTable = nullptr;
+        if (params.Arena) {
+            m_SpanRates = params.Arena->AllocateArray<SegmentRate>(m_SegmentCount);
+            spanTable = params.Arena->AllocateArray<float>(spanTableSize);
+        } else {
+            m_SpanRateStorage.resize(m_SegmentCount);
+            m_SpanTableStorage.resize(spanTableSize);
+            m_SpanRates = m_SpanRateStorage.data();
+            spanTable = m_SpanTableStorage.data();
+        }
+        for (size_t i = 0; i < m_SegmentCount; ++i) {
+            const size_t divisions = m_FirstSample[i + 1] - m_FirstSample[i] - (i + 1 == m_SegmentCount ? 1 : 0);
+            if (spans[i] > 1) {
+                m_SpanRates[i] = BuildSegmentRate(spanTable, divisions, nominal * spans[i]);
+                spanTable += divisions + 1;
+            } else {
+                m_SpanRates[i] = m_Rates[divisions];
+            }
+        }
+    }
+    
+    //==========================================================================
+    // 函数：BuildGalvoPath
+    // 描述：振镜模型：物化全部插值样本作为输入（前方补 L 个静止于第一个原始点的样本，与递推初始状态相同），
+    //       与反转的脉冲响应做 FIR 卷积得到各样本的位置轨迹；输出之间无依赖，大帧按块在线程池上并行
+    //==========================================================================
+    void BuildGalvoPath(const ScannerPipelineParams& params) {
+        const std::vector<float>& response = params.Galvo.Taps;
+        const size_t tapCount = response.size();
+        const size_t total = GetTotalSamples();
+        const size_t inputCount = tapCount + total;
+        const size_t count = tapCount + 2 * inputCount + 2 * total;
+        float* storage = nullptr;
+        if (params.Arena) {
+            storage = params.Arena->AllocateArray<float>(count);
+        } else {
+            m_PathStorage.resize(count);
+            storage = m_PathStorage.data();
+        }
+        float* taps = storage;
+        float* inputX = taps + tapCount;
+        float* inputY = inputX + inputCount;
+        float* pathX = inputY + inputCount;
+        float* pathY = pathX + total;
+        
+        // 样本 n 的位置 = Σ h[j] × 样本 n - 1 - j，即窗口 [n, n + L) 与反转系数的内积
+        for (size_t i = 0; i < tapCount; ++i) {
+            taps[i] = response[tapCount - 1 - i];
+        }
+        std::fill(inputX, inputX + tapCount, m_Raw.X[0]);
+        std::fill(inputY, inputY + tapCount, m_Raw.Y[0]);
+        size_t k = tapCount;
+        for (size_t i = 0; i < m_SegmentCount; ++i) {
+            const SegmentRate rate = GetSegmentRate(i);
+            const size_t samples = GetSegmentSamples(i);
+            const size_t next = Interpolate ? i + 1 : i;
+            const float x0 = m_Raw.X[i];
+            const float y0 = m_Raw.Y[i];
+            const float dx = m_Raw.X[next] - x0;
+            const float dy = m_Raw.Y[next] - y0;
+            const bool curved = IsCurvedSegment(i);
+            const CurveTangents tangents = curved ? GetTangents(i) : CurveTangents{};
+            for (size_t s = 0; s < samples; ++s, ++k) {
+                const float t = Interpolate ? rate.T[s] : 0.0f;
+                float sampleX = Interpolate ? x0 + dx * t : x0;
+                float sampleY = Interpolate ? y0 + dy * t : y0;
+                if (curved) {
+                    const HermiteBasis basis = GetHermiteBasis(t);
+                    sampleX = EvaluateHermite(x0, dx, tangents.StartX, tangents.EndX, basis);
+                    sampleY = EvaluateHermite(y0, dy, tangents.StartY, tangents.EndY, basis);
+                }
+                inputX[k] = sampleX;
+                inputY[k] = sampleY;
+            }
+        }
+        
+        // 每个输出只读取自己的窗口，分块结果与单线程逐位一致
+        const size_t blockCount = (total + GalvoBlockSamples - 1) / GalvoBlockSamples;
+        auto convolveBlock = [=](size_t block) {
+            const size_t first = block * GalvoBlockSamples;
+            const size_t last = (std::min)(total, first + GalvoBlockSamples);
+            ConvolveTaps(inputX, taps, tapCount, first, last, pathX);
+            ConvolveTaps(inputY, taps, tapCount, first, last, pathY);
+        };
+        if (params.Pool && params.Pool->GetConcurrency() > 1 && blockCount > 1 && total >= params.ParallelMinSamples) {
+            params.Pool->ParallelFor(blockCount, convolveBlock);
+        } else {
+            for (size_t block = 0; block < blockCount; ++block) {
+                convolveBlock(block);
+            }
+        }
+        m_PathX = pathX;
+        m_PathY = pathY;
+    }
+    
+    //==========================================================================
+    // 函数：SimulateSegment
+    // 描述：处理单个原始段的全部样本
+    //       BeamSegment 为 false 时该段所有样本 Z = 0，必然应用淡化
+    //       Curved 为 true 时样本位置取三次 Hermite 曲线
+    //       Filtered 为 true 时位置取振镜模型的卷积轨迹，速度为相邻样本位移 / 步长
+    //==========================================================================
+    template <bool BeamBrush, bool DeferShading, bool BeamSegment, bool Curved, bool Filtered>
+    void SimulateSegment(size_t i, size_t& k, RecurrenceState& state, KernelOutput& output) const {
+        const FrameView& raw = m_Raw;
+        const MutableFrameView& processedOut = output.Processed;
+        const MutableFrameView& beamOut = output.Beam;
+        size_t processedKept = output.ProcessedKept;
+        size_t beamKept = output.BeamKept;
+        const SegmentRate rate = GetSegmentRate(i);
+        const size_t samples = GetSegmentSamples(i);
+        const size_t next = Interpolate ? i + 1 : i;
+        const float x0 = raw.X[i];
+        const float y0 = raw.Y[i];
+        const float dx = raw.X[next] - x0;
+        const float dy = raw.Y[next] - y0;
+        const CurveTangents tangents = Curved ? GetTangents(i) : CurveTangents{};
+        
+        float currentVelX = state.VelX;
+        float currentVelY = state.VelY;
+        float currentPosX = state.PosX;
+        float currentPosY = state.PosY;
+        
+        for (size_t s = 0; s < samples; ++s, ++k) {
+            const float t = Interpolate ? rate.T[s] : 0.0f;
+            float sampleX = Interpolate ? x0 + dx * t : x0;
+            float sampleY = Interpolate ? y0 + dy * t : y0;
+            if (Curved) {
+                const HermiteBasis basis = GetHermiteBasis(t);
+                sampleX = EvaluateHermite(x0, dx, tangents.StartX, tangents.EndX, basis);
+                sampleY = EvaluateHermite(y0, dy, tangents.StartY, tangents.EndY, basis);
+            }
+            
+            // 速度/位置递推（每个样本都推进）
+            bool moving = true;
+            if (Filtered) {
+                const float pathX = m_PathX[k];
+                const float pathY = m_PathY[k];
+                currentVelX = (pathX - currentPosX) * m_InverseStep;
+                currentVelY = (pathY - currentPosY) * m_InverseStep;
+                currentPosX = pathX;
+                currentPosY = pathY;
+            } else {
+                float targetVelX = sampleX - currentPosX;
+                float targetVelY = sampleY - currentPosY;
+                moving = (targetVelX * targetVelX + targetVelY * targetVelY) > 0.0f;
+                
+                if (moving) {
+                    currentVelX += (targetVelX - currentVelX) * rate.Alpha;
+                    currentVelY += (targetVelY - currentVelY) * rate.Alpha;
+                    currentPosX += currentVelX * rate.Step;
+                    currentPosY += currentVelY * rate.Step;
+                }
+            }
+            
+            const bool keepProcessed = (k % m_ProcessedFactor) == 0;
+            const bool keepBeam = EmitBeam && (k % m_BeamFactor) == 0;
+            if (!keepProcessed && !keepBeam) {
+                continue;
+            }
+            
+            // 保留的样本：计算颜色、Z 和边缘淡化强度
+            float r = raw.R[i];
+            float g = raw.G[i];
+            float b = raw.B[i];
+            float z = BeamSegment ? raw.Z[i] : (Interpolate ? 0.0f : raw.Z[i]);
+            float focus = raw.Focus[i];
+            if (Interpolate) {
+                r += (raw.R[next] - raw.R[i]) * t;
+                g += (raw.G[next] - raw.G[i]) * t;
+                b += (raw.B[next] - raw.B[i]) * t;
+                focus += (raw.Focus[next] - raw.Focus[i]) * t;
+                if (BeamSegment) {
+                    z += (raw.Z[next] - raw.Z[i]) * t;
+                }
+            }
+            
+            // 自适应插值：淡化样本代表 S/d 个固定模式样本
+            if (Adaptive && (!BeamSegment || z == 0.0f)) {
+                r *= rate.Weight;
+                g *= rate.Weight;
+                b *= rate.Weight;
+            }
+            
+            // 延迟着色：记录速度平方，不淡化的样本记为 -1
+            float speedSq = -1.0f;
+            if (DeferShading) {
+                if (moving && (!BeamSegment || z == 0.0f)) {
+                    speedSq = currentVelX * currentVelX + currentVelY * currentVelY;
+                }
+            } else if (!BeamSegment || z == 0.0f) {
+                float intensity = 1.0f;
+                if (moving) {
+                    // 振镜静止时速度为 0，按速度下限取强度上限
+                    const float velSq = currentVelX * currentVelX + currentVelY * currentVelY;
+                    float velLength = std::sqrt(Filtered ? (std::max)(velSq, MinShadingSpeedSq) : velSq);
+                    intensity = (std::min)(4.0f, 1.0f / velLength * 0.2f * m_EdgeFade * 2.0f);
+                    intensity = (std::min)(4.0f, intensity) / m_IntensityDivisor;
+                    intensity = intensity * (1.0f - m_FadePercent) + m_FadePercent;
+                }
+                r *= intensity;
+                g *= intensity;
+                b *= intensity;
+            }
+            
+            if (keepProcessed &&
+                !(BeamBrush && processedKept > 0 &&
+                  IsSamePosition(currentPosX, currentPosY,
+                                 processedOut.X[processedKept - 1], processedOut.Y[processedKept - 1]))) {
+                processedOut.X[processedKept] = currentPosX;
+                processedOut.Y[processedKept] = currentPosY;
+                processedOut.R[processedKept] = r;
+                processedOut.G[processedKept] = g;
+                processedOut.B[processedKept] = b;
+                processedOut.Z[processedKept] = z;
+                processedOut.Focus[processedKept] = focus;
+                if (DeferShading) {
+                    output.ProcessedSpeed[processedKept] = speedSq;
+                }
+                ++processedKept;
+            }
+            if (keepBeam) {
+                beamOut.X[beamKept] = currentPosX;
+                beamOut.Y[beamKept] = currentPosY;
+                beamOut.R[beamKept] = r;
+                beamOut.G[beamKept] = g;
+                beamOut.B[beamKept] = b;
+                beamOut.Z[beamKept] = z;
+                beamOut.Focus[beamKept] = focus;
+                if (DeferShading) {
+                    output.BeamSpeed[beamKept] = speedSq;
+                }
+                ++beamKept;
+            }
+        }
+        
+        output.ProcessedKept = processedKept;
+        output.BeamKept = beamKept;
+        
+        state.VelX = currentVelX;
+        state.VelY = currentVelY;
+        state.PosX = currentPosX;
+        state.PosY = currentPosY;
+    }
+
+private:
+    FrameView m_Raw;
+    size_t m_ProcessedFactor;
+    size_t m_BeamFactor;
+    size_t m_SamplesPerSegment;
+    size_t m_SegmentCount;
+    bool m_CullBlank;
+    bool m_Curved;
+    float m_Smoothing;
+    float m_EdgeFade;
+    float m_StepSize;
+    double m_IntensityDivisor;
+    float m_FadePercent;
+    float m_InverseStep;
+    bool m_Filtered;
+    float m_FixedTable[SampleClass > 1 ? SampleClass : 1] = {};
+    std::vector<float> m_DynamicTable;
+    float* m_TTable;
+    std::vector<SegmentRate> m_Rates;
+    std::vector<size_t> m_FirstSampleStorage;
+    size_t* m_FirstSample = nullptr;
+    std::vector<SegmentRate> m_SpanRateStorage;
+    std::vector<float> m_SpanTableStorage;
+    SegmentRate* m_SpanRates = nullptr;
+    std::vector<float> m_TangentStorage;
+    const float* m_Tangents = nullptr;
+    std::vector<float> m_PathStorage;
+    const float* m_PathX = nullptr;
+    const float* m_PathY = nullptr;
+};
+
+//==========================================================================
+// 函数：GetRecurrenceContraction
+// 描述：计算递推矩阵 M 的谱半径（块起点误差每个样本的衰减率）
+//==========================================================================
+inline double GetRecurrenceContraction(float smoothing, float stepSize) {
+    const double a = static_cast<double>(1.0f - smoothing);
+    const double h = stepSize;
+    const double trace = (1.0 - a) + (1.0 - h * a);
+    const double determinant = 1.0 - a;
+    const double discriminant = trace * trace - 4.0 * determinant;
+    if (discriminant < 0.0) {
+        return std::sqrt(determinant);
+    }
+    const double root = std::sqrt(discriminant);
+    return (std::max)(std::abs(trace + root), std::abs(trace - root)) * 0.5;
+}
+
+//==========================================================================
+// 函数：CanUseParallelScan
+// 描述：判断递推是否适合分块扫描：参数有限且仿射映射收缩（块起点误差随样本衰减）
+//==========================================================================
+template <typename Kernel>
+bool CanUseParallelScan(const Kernel& kernel, const ScannerPipelineParams& params) {
+    if (params.Pool == nullptr || params.Pool->GetConcurrency() < 2 || kernel.IsFiltered()) {
+        return false;
+    }
+    if (kernel.GetTotalSamples() < (std::max)(params.ParallelMinSamples, 2 * MinScanBlockSamples)) {
+        return false;
+    }
+    const float smoothing = kernel.GetSmoothing();
+    const float stepSize = kernel.GetStepSize();
+    return smoothing >= 0.0f && smoothing < 1.0f && std::isfinite(stepSize) &&
+           stepSize > 0.0f && stepSize <= 1.0f &&
+           (!Kernel::Adaptive || GetRecurrenceContraction(smoothing, stepSize) < 1.0);
+}
+
+//==========================================================================
+// 函数：GetWarmUpSamples
+// 描述：确定分块起始状态的预热窗口长度（0 表示使用精确进位）
+//       窗口长度取初始误差衰减到 WarmUpTolerance 所需样本数的两倍（留出非正规矩阵的瞬态余量）；
+//       Auto 模式下窗口超过块长度的 1/4 时改用精确进位；自适应插值总是使用预热窗口
+//==========================================================================
+template <typename Kernel>
+size_t GetWarmUpSamples(const Kernel& kernel, LaserSettings::ChunkSeeding seeding, size_t blockSamples) {
+    if (Kernel::Adaptive) {
+        seeding = LaserSettings::ChunkSeeding::WarmUp;
+    }
+    if (seeding == LaserSettings::ChunkSeeding::ExactCarry) {
+        return 0;
+    }
+    const double contraction = GetRecurrenceContraction(kernel.GetSmoothing(), kernel.GetStepSize());
+    if (!(contraction < 1.0)) {
+        return 0;
+    }
+    
+    size_t warmUpSamples = MinWarmUpSamples;
+    if (contraction > 0.0) {
+        const double decaySamples = std::log(WarmUpTolerance) / std::log(contraction);
+        warmUpSamples = (std::max)(warmUpSamples, static_cast<size_t>(std::ceil(2.0 * decaySamples)));
+    }
+    if (seeding == LaserSettings::ChunkSeeding::Auto && warmUpSamples * 4 > blockSamples) {
+        return 0;
+    }
+    return warmUpSamples;
+}
+
+//==========================================================================
+// 函数：ComputeCarryStarts
+// 描述：精确进位：用仿射映射的结合律计算每块的起始状态
+//       每个样本的递推是作用于每轴 [速度, 位置] 的仿射映射 x' = M·x + c·sample，
+//       M = [[1-α, -α], [h(1-α), 1-hα]]（α = 1 - 平滑因子，h = 步长）：
+//       1. 各块从零状态并行累加，得到块映射的平移部分
+//       2. 串行组合块映射（M 的 L 次幂以双精度预先计算），得到每块的起始状态
+//       零距离样本在串行递推中不更新状态，步骤 1 将其视为普通仿射步，
+//       由此和浮点舍入带来的块起点误差在 M 的收缩下逐样本衰减
+//==========================================================================
+template <typename Kernel>
+void ComputeCarryStarts(const Kernel& kernel, WorkerPool& pool, size_t segmentsPerBlock,
+                        std::vector<RecurrenceState>& starts) {
+    const size_t segmentCount = kernel.GetSegmentCount();
+    const size_t samplesPerSegment = kernel.GetSamplesPerSegment();
+    const size_t blockCount = starts.size();
+    
+    // 1. 各块平移部分（最后一块的结果不被后续使用）
+    std::vector<RecurrenceState> offsets(blockCount);
+    pool.ParallelFor(blockCount - 1, [&](size_t block) {
+        const size_t first = block * segmentsPerBlock;
+        offsets[block] = kernel.AccumulateOffset(first, (std::min)(first + segmentsPerBlock, segmentCount));
+    });
+    
+    // 2. 块映射组合：除最后一块外所有块长度相同，只需 M^L
+    const double a = static_cast<double>(1.0f - kernel.GetSmoothing());
+    const double h = kernel.GetStepSize();
+    double power[2][2] = { { 1.0, 0.0 }, { 0.0, 1.0 } };
+    double base[2][2] = { { 1.0 - a, -a }, { h * (1.0 - a), 1.0 - h * a } };
+    for (size_t exponent = segmentsPerBlock * samplesPerSegment; exponent > 0; exponent >>= 1) {
+        if (exponent & 1) {
+            double result[2][2];
+            for (int r = 0; r < 2; ++r) {
+                for (int c = 0; c < 2; ++c) {
+                    result[r][c] = power[r][0] * base[0][c] + power[r][1] * base[1][c];
+                }
+            }
+            std::memcpy(power, result, sizeof(power));
+        }
+        double squared[2][2];
+        for (int r = 0; r < 2; ++r) {
+            for (int c = 0; c < 2; ++c) {
+                squared[r][c] = base[r][0] * base[0][c] + base[r][1] * base[1][c];
+            }
+        }
+        std::memcpy(base, squared, sizeof(base));
+    }
+    
+    double velX = starts[0].VelX;
+    double velY = starts[0].VelY;
+    double posX = starts[0].PosX;
+    double posY = starts[0].PosY;
+    for (size_t block = 1; block < blockCount; ++block) {
+        const RecurrenceState& offset = offsets[block - 1];
+        const double nextVelX = power[0][0] * velX + power[0][1] * posX + offset.VelX;
+        const double nextPosX = power[1][0] * velX + power[1][1] * posX + offset.PosX;
+        const double nextVelY = power[0][0] * velY + power[0][1] * posY + offset.VelY;
+        const double nextPosY = power[1][0] * velY + power[1][1] * posY + offset.PosY;
+        velX = nextVelX;
+        posX = nextPosX;
+        velY = nextVelY;
+        posY = nextPosY;
+        starts[block].VelX = static_cast<float>(velX);
+        starts[block].VelY = static_cast<float>(velY);
+        starts[block].PosX = static_cast<float>(posX);
+        starts[block].PosY = static_cast<float>(posY);
+    }
+}
+
+//==========================================================================
+// 函数：RunParallelScan
+// 描述：帧内分块并行处理：帧按原始段切分为块，各块在线程池上运行精确的串行内核，
+//       输出位置由块的起始样本序号确定，拼接后没有接缝。块起始状态有两种来源：
+//       - 预热窗口：从块前方一段窗口以静止状态起步推进递推，
+//         窗口长度使初始误差衰减到浮点精度以下，不需要额外的整帧遍历
+//       - 精确进位：仿射映射分块前缀扫描（见 ComputeCarryStarts）
+//       延迟着色时各块对自己的输出区间着色；剔除消隐段时块尾留有空位，完成后前移拼接
+//       target 的保留样本数和剔除样本数更新为全部块的合计
+//==========================================================================
+template <bool DeferShading, typename Kernel>
+void RunParallelScan(const Kernel& kernel, const ScannerPipelineParams& params, KernelOutput& target) {
+    WorkerPool& pool = *params.Pool;
+    const size_t segmentCount = kernel.GetSegmentCount();
+    const size_t samplesPerSegment = kernel.GetSamplesPerSegment();
+    const size_t totalSamples = kernel.GetTotalSamples();
+    
+    size_t blockCount = (std::min)(pool.GetConcurrency() * 2, totalSamples / MinScanBlockSamples);
+    blockCount = (std::max)(static_cast<size_t>(1), (std::min)(blockCount, segmentCount));
+    const size_t segmentsPerBlock = (segmentCount + blockCount - 1) / blockCount;
+    blockCount = (segmentCount + segmentsPerBlock - 1) / segmentsPerBlock;
+    
+    const size_t warmUpSamples = GetWarmUpSamples(kernel, params.Seeding, segmentsPerBlock * samplesPerSegment);
+    
+    std::vector<RecurrenceState> starts(blockCount);
+    starts[0] = kernel.GetInitialState();
+    if (warmUpSamples == 0 && blockCount > 1) {
+        ComputeCarryStarts(kernel, pool, segmentsPerBlock, starts);
+    }
+    
+    // 各块精确递推并写出（输出位置由块的起始样本序号确定）
+    const size_t processedFactor = kernel.GetProcessedFactor();
+    const size_t beamFactor = kernel.GetBeamFactor();
+    const ShadingConstants shading = kernel.GetShadingConstants();
+    std::vector<size_t> processedFirsts(blockCount);
+    std::vector<size_t> processedEnds(blockCount);
+    std::vector<size_t> beamFirsts(blockCount);
+    std::vector<size_t> beamEnds(blockCount);
+    std::vector<size_t> culled(blockCount);
+    pool.ParallelFor(blockCount, [&](size_t block) {
+        const size_t first = block * segmentsPerBlock;
+        const size_t last = (std::min)(first + segmentsPerBlock, segmentCount);
+        const size_t firstSample = kernel.GetSegmentFirstSample(first);
+        
+        KernelOutput output = target;
+        output.CulledSamples = 0;
+        output.ProcessedKept = (firstSample + processedFactor - 1) / processedFactor;
+        output.BeamKept = Kernel::EmitBeam ? (firstSample + beamFactor - 1) / beamFactor : 0;
+        const size_t firstProcessed = output.ProcessedKept;
+        const size_t firstBeam = output.BeamKept;
+        
+        RecurrenceState state = (warmUpSamples > 0 && block > 0) ? kernel.WarmUp(first, warmUpSamples) : starts[block];
+        kernel.template Simulate<false, DeferShading>(first, last, state, output);
+        
+        if (DeferShading) {
+            ShadeSamples(output.Processed, output.ProcessedSpeed, firstProcessed, output.ProcessedKept, shading);
+            ShadeSamples(output.Beam, output.BeamSpeed, firstBeam, output.BeamKept, shading);
+        }
+        processedFirsts[block] = firstProcessed;
+        processedEnds[block] = output.ProcessedKept;
+        beamFirsts[block] = firstBeam;
+        beamEnds[block] = output.BeamKept;
+        culled[block] = output.CulledSamples;
+    });
+    
+    target.ProcessedKept = processedEnds.back();
+    target.BeamKept = beamEnds.back();
+    if (kernel.CullsBlankSegments()) {
+        target.ProcessedKept = CompactBlocks(target.Processed, processedFirsts, processedEnds);
+        target.BeamKept = CompactBlocks(target.Beam, beamFirsts, beamEnds);
+        for (size_t count : culled) {
+            target.CulledSamples += count;
+        }
+    }
+}
+
+//==========================================================================
+// 函数：RunSimulated
+// 描述：扫描仪模拟实例
+//       BeamBrush - 主点列表是否移除连续重复位置
+//       样本数足够多且配置了线程池时使用分块并行扫描，否则单线程融合处理
+//       原始点先经过输入简化，最后对主点列表做 LOD 合并；各阶段的计数累加到 params.Stats
+//==========================================================================
+template <int ProcessedFactor, int BeamFactor, int SampleClass, bool BeamBrush>
+void RunSimulated(const FrameView& input, const ScannerPipelineParams& params,
+                  LaserFrame& processed, LaserFrame& beam) {
+    if (input.Count < 2) {
+        RunPassthrough<BeamBrush>(input, params, processed, beam);
+        return;
+    }
+    
+    // 输入简化：内核处理简化后的原始点，合并段按代表的原始段数取样（从帧内存池分配，未提供时使用临时帧）
+    // 只在自适应样本数实例中进行（SelectSampleClass 在简化时选择该实例）
+    FrameView raw = input;
+    LaserFrame simplifiedStorage;
+    std::vector<size_t> spanStorage;
+    size_t* spans = nullptr;
+    if (SampleClass == SampleClassAdaptive && params.SimplifyTolerance > 0.0f && input.Count > 2) {
+        MutableFrameView simplified;
+        if (params.Arena) {
+            simplified = params.Arena->AllocateFrame(input.Count);
+            spans = params.Arena->AllocateArray<size_t>(input.Count);
+        } else {
+            simplifiedStorage.Resize(input.Count);
+            simplified = simplifiedStorage.MutableView();
+            spanStorage.resize(input.Count);
+            spans = spanStorage.data();
+        }
+        simplified.Count = ScannerPipeline::SimplifyPoints(input, params.SimplifyTolerance, simplified, params.Arena, spans);
+        raw = ToConstView(simplified);
+    }
+    
+    const SimulationKernel<ProcessedFactor, BeamFactor, SampleClass> kernel(raw, params, spans);
+    const size_t totalSamples = kernel.GetTotalSamples();
+    const size_t processedFactor = kernel.GetProcessedFactor();
+    const size_t beamFactor = kernel.GetBeamFactor();
+    
+    const size_t processedCount = (totalSamples + processedFactor - 1) / processedFactor;
+    const size_t beamCount = kernel.EmitBeam ? (totalSamples + beamFactor - 1) / beamFactor : 0;
+    processed.Resize(processedCount);
+    beam.Resize(beamCount);
+    
+    KernelOutput output;
+    output.Processed = processed.MutableView();
+    output.Beam = beam.MutableView();
+    
+    // 延迟着色：速度暂存从帧内存池分配（未提供内存池时使用临时缓冲）
+    const bool deferShading = params.VectorizedShading;
+    std::vector<float> speedScratch;
+    if (deferShading) {
+        if (params.Arena) {
+            output.ProcessedSpeed = params.Arena->AllocateArray<float>(processedCount);
+            output.BeamSpeed = params.Arena->AllocateArray<float>(beamCount);
+        } else {
+            speedScratch.resize(processedCount + beamCount);
+            output.ProcessedSpeed = speedScratch.data();
+            output.BeamSpeed = speedScratch.data() + processedCount;
+        }
+    }
+    
+    const bool parallelScan = CanUseParallelScan(kernel, params);
+    if (parallelScan) {
+        if (deferShading) {
+            RunParallelScan<true>(kernel, params, output);
+        } else {
+            RunParallelScan<false>(kernel, params, output);
+        }
+    } else {
+        RecurrenceState state = kernel.GetInitialState();
+        if (deferShading) {
+            // 串行递推只记录速度，随后对全部输出做向量化着色
+            kernel.template Simulate<BeamBrush, true>(0, kernel.GetSegmentCount(), state, output);
+            const ShadingConstants shading = kernel.GetShadingConstants();
+            ShadeSamples(output.Processed, output.ProcessedSpeed, 0, output.ProcessedKept, shading);
+            ShadeSamples(output.Beam, output.BeamSpeed, 0, output.BeamKept, shading);
+        } else {
+            kernel.template Simulate<BeamBrush, false>(0, kernel.GetSegmentCount(), state, output);
+        }
+    }
+    
+    // 去重和剔除后输出短于预留长度（并行扫描不去重，拼接后统一去重）
+    if (BeamBrush || kernel.CullsBlankSegments()) {
+        processed.Resize(output.ProcessedKept);
+        beam.Resize(output.BeamKept);
+    }
+    if (BeamBrush && parallelScan) {
+        CompactDuplicatePositions(processed);
+    }
+    
+    size_t merged = 0;
+    if (params.LodCellsPerUnit > 0.0f) {
+        merged = ScannerPipeline::MergePixelRuns(processed, params.LodCellsPerUnit, params.LodMaxColor);
+    }
+    
+    if (params.Stats) {
+        params.Stats->Samples += totalSamples;
+        params.Stats->CulledSamples += output.CulledSamples;
+        params.Stats->MergedSamples += merged;
+        params.Stats->InputPoints += input.Count;
+        params.Stats->SimplifiedPoints += input.Count - raw.Count;
+    }
+}
+
+//==========================================================================
+// 函数：SelectSampleClass
+// 描述：按样本数类别选择实例（输入简化的合并段样本数不同，使用自适应样本数实例）
+//==========================================================================
+template <int ProcessedFactor, int BeamFactor, bool BeamBrush>
+ScannerPipelineFunc SelectSampleClass(const ScannerPipelineParams& params) {
+    const int sampleCount = params.SampleCount;
+    if (sampleCount <= 1) {
+        return &RunSimulated<ProcessedFactor, BeamFactor, SampleClassNone, BeamBrush>;
+    }
+    if (params.AdaptiveSampling || params.SimplifyTolerance > 0.0f) {
+        return &RunSimulated<ProcessedFactor, BeamFactor, SampleClassAdaptive, BeamBrush>;
+    }
+    if (sampleCount == 8) {
+        return &RunSimulated<ProcessedFactor, BeamFactor, 8, BeamBrush>;
+    }
+    return &RunSimulated<ProcessedFactor, BeamFactor, SampleClassGeneric, BeamBrush>;
+}
+
+//==========================================================================
+// 函数：SelectFactors
+// 描述：按降采样倍数组合（对应质量等级）选择实例
+//       不输出光束点时只按主点降采样倍数特化
+//==========================================================================
+template <bool BeamBrush>
+ScannerPipelineFunc SelectFactors(const ScannerPipelineParams& params) {
+    const int p = params.ProcessedFactor;
+    const int b = params.BeamFactor;
+    if (!params.BeamOutput) {
+        if (p == 8) return SelectSampleClass<8, NoBeamOutput, BeamBrush>(params);
+        if (p == 4) return SelectSampleClass<4, NoBeamOutput, BeamBrush>(params);
+        if (p == 2) return SelectSampleClass<2, NoBeamOutput, BeamBrush>(params);
+        if (p == 1) return SelectSampleClass<1, NoBeamOutput, BeamBrush>(params);
+        return SelectSampleClass<0, NoBeamOutput, BeamBrush>(params);
+    }
+    if (p == 8 && b == 8) return SelectSampleClass<8, 8, BeamBrush>(params);
+    if (p == 4 && b == 8) return SelectSampleClass<4, 8, BeamBrush>(params);
+    if (p == 2 && b == 2) return SelectSampleClass<2, 2, BeamBrush>(params);
+    if (p == 1 && b == 1) return SelectSampleClass<1, 1, BeamBrush>(params);
+    return SelectSampleClass<0, 0, BeamBrush>(params);
+}
+
+} // namespace
+
+//==========================================================================
+// 函数：FromSettings
+// 描述：由系统配置生成处理参数
+// 参数：
+//   settings - 系统配置
+//   scannerSimulation - 是否启用扫描仪模拟
+//   beamBrush - 是否启用光束画刷
+// 返回值：
+//   ScannerPipelineParams - 处理参数
+//==========================================================================
+ScannerPipelineParams ScannerPipelineParams::FromSettings(const LaserSettings& settings,
+                                                          bool scannerSimulation, bool beamBrush) {
+    ScannerPipelineParams params;
+    params.SampleCount = settings.SampleCount;
+    params.AdaptiveSampling = settings.AdaptiveSampling;
+    params.AdaptiveSpacing = settings.AdaptivePixelSpacing * 2.0f / static_cast<float>((std::max)(1, settings.TextureSize));
+    params.AdaptiveMaxSamples = settings.AdaptiveMaxSamples > 0 ? settings.AdaptiveMaxSamples : settings.SampleCount;
+    params.AdaptiveMinSamples = (std::min)(settings.AdaptiveMinSamples, params.AdaptiveMaxSamples);
+    params.VelocitySmoothing = settings.VelocitySmoothing;
+    params.EdgeFade = settings.EdgeFade;
+    params.ScannerSimulation = scannerSimulation;
+    params.BeamBrush = beamBrush;
+    params.ParallelMinSamples = static_cast<size_t>((std::max)(0, settings.ParallelScanMinSamples));
+    params.VectorizedShading = settings.VectorizedEdgeFade;
+    params.CullBlankSegments = settings.CullBlankSegments;
+    if (settings.LodPixelTolerance > 0.0f && settings.LodViewScale > 0.0f) {
+        // 网格单元 = 容差 × 显示像素，[-1, 1] 对应 TextureSize × 显示缩放个像素
+        params.LodCellsPerUnit = static_cast<float>((std::max)(1, settings.TextureSize)) * settings.LodViewScale /
+                                 (2.0f * settings.LodPixelTolerance);
+        params.LodMaxColor = settings.QuantizedVertexUpload ? 4.0f : std::numeric_limits<float>::max();
+    }
+    params.Seeding = settings.ParallelScanSeeding;
+    params.Interpolation = settings.QualityInterpolation[static_cast<int>(settings.LaserQuality)];
+    if (settings.SimplifyPixelTolerance > 0.0f) {
+        params.SimplifyTolerance = settings.SimplifyPixelTolerance * 2.0f / static_cast<float>((std::max)(1, settings.TextureSize));
+    }
+    if (scannerSimulation && settings.ScannerResponse == LaserSettings::ScannerModel::Galvo) {
+        // 样本时长 = 原始点时长 / 每段样本数；卷积要求样本时长均匀，振镜模型不使用自适应插值
+        const double pointRate = static_cast<double>(settings.ScanRateKpps) * 1000.0;
+        const double samplesPerPoint = static_cast<double>((std::max)(1, settings.SampleCount));
+        params.Galvo = ScannerPipeline::BuildGalvoResponse(settings.GalvoNaturalFrequency, settings.GalvoDamping,
+                                                           1.0 / (pointRate * samplesPerPoint));
+        if (!params.Galvo.Taps.empty()) {
+            params.AdaptiveSampling = false;
+        }
+    }
+    
+    switch (settings.LaserQuality) {
+        case LaserSettings::QualityLevel::Low:
+            params.ProcessedFactor = 8;
+            params.BeamFactor = 8;
+            break;
+        case LaserSettings::QualityLevel::Medium:
+            params.ProcessedFactor = 4;
+            params.BeamFactor = 8;
+            break;
+        case LaserSettings::QualityLevel::High:
+            params.ProcessedFactor = 2;
+            params.BeamFactor = 2;
+            break;
+        case LaserSettings::QualityLevel::Ultra:
+            params.ProcessedFactor = 1;
+            params.BeamFactor = 1;
+            break;
+    }
+    return params;
+}
+
+//==========================================================================
+// 函数：GetSampleCount
+// 描述：计算插值后的样本总数（不插值时等于原始点数）
+// 参数：
+//   pointCount - 原始点数量
+//   sampleCount - 每段插值样本数
+// 返回值：
+//   size_t - 样本总数
+//==========================================================================
+size_t ScannerPipeline::GetSampleCount(size_t pointCount, int sampleCount) {
+    if (pointCount < 2 || sampleCount <= 1) {
+        return pointCount;
+    }
+    return (pointCount - 1) * static_cast<size_t>(sampleCount);
+}
+
+//==========================================================================
+// 函数：Select
+// 描述：选择与参数匹配的特化处理函数
+// 参数：
+//   params - 处理参数
+// 返回值：
+//   ScannerPipelineFunc - 特化的处理函数
+//==========================================================================
+ScannerPipelineFunc ScannerPipeline::Select(const ScannerPipelineParams& params) {
+    if (!params.ScannerSimulation) {
+        return params.BeamBrush ? &RunPassthrough<true> : &RunPassthrough<false>;
+    }
+    return params.BeamBrush ? SelectFactors<true>(params) : SelectFactors<false>(params);
+}
+
+//==========================================================================
+// 函数：GetVariantName
+// 描述：获取参数对应的特化实例名称
+// 参数：
+//   params - 处理参数
+// 返回值：
+//   std::string - 实例名称
+//==========================================================================
+std::string ScannerPipeline::GetVariantName(const ScannerPipelineParams& params) {
+    std::string name;
+    if (!params.ScannerSimulation) {
+        name = "passthrough";
+    } else {
+        const int p = params.ProcessedFactor;
+        const int b = params.BeamFactor;
+        const bool specialised = params.BeamOutput
+            ? (p == 8 && b == 8) || (p == 4 && b == 8) || (p == 2 && b == 2) || (p == 1 && b == 1)
+            : (p == 8 || p == 4 || p == 2 || p == 1);
+        name = "sim/";
+        if (!specialised) {
+            name += "generic";
+        } else {
+            name += "p" + std::to_string(p);
+            name += params.BeamOutput ? "b" + std::to_string(b) : "";
+        }
+        if (params.SampleCount <= 1) {
+            name += "/s1";
+        } else if (params.AdaptiveSampling || params.SimplifyTolerance > 0.0f) {
+            name += "/sA";
+        } else if (params.SampleCount == 8) {
+            name += "/s8";
+        } else {
+            name += "/sN";
+        }
+        if (params.SampleCount > 1 && params.Interpolation == LaserSettings::InterpolationMode::CatmullRom) {
+            name += "/cr";
+        } else if (params.SampleCount > 1 && params.Interpolation == LaserSettings::InterpolationMode::Hermite) {
+            name += "/hermite";
+        }
+        if (!params.Galvo.Taps.empty()) {
+            name += "/galvo";
+        }
+    }
+    if (!params.BeamOutput) {
+        name += "/nobeam";
+    }
+    if (params.BeamBrush) {
+        name += "/brush";
+    }
+    return name;
+}
+
+//==========================================================================
+// 函数：GetSamplePosition
+// 描述：原始段上的插值位置（逐段计算切线，运算与处理实例相同）
+// 参数：
+//   raw - 原始点
+//   segment - 原始段序号
+//   mode - 插值方式
+//   t - 段内参数
+//   x, y - [输出] 插值位置
+//==========================================================================
+void ScannerPipeline::GetSamplePosition(const FrameView& raw, size_t segment, LaserSettings::InterpolationMode mode,
+                                        float t, float& x, float& y) {
+    const float x0 = raw.X[segment];
+    const float y0 = raw.Y[segment];
+    const float dx = raw.X[segment + 1] - x0;
+    const float dy = raw.Y[segment + 1] - y0;
+    if (mode == LaserSettings::InterpolationMode::Linear || raw.Z[segment] > 0.0f) {
+        x = x0 + dx * t;
+        y = y0 + dy * t;
+        return;
+    }
+    const CurveTangents tangents = GetCurveTangents(raw, segment, mode);
+    const HermiteBasis basis = GetHermiteBasis(t);
+    x = EvaluateHermite(x0, dx, tangents.StartX, tangents.EndX, basis);
+    y = EvaluateHermite(y0, dy, tangents.StartY, tangents.EndY, basis);
+}
+
+//==========================================================================
+// 函数：MergePixelRuns
+// 描述：LOD 合并：连续且落在同一网格单元的非光束点合并，颜色累加（原地压缩）
+// 参数：
+//   points - [输入/输出] 点列表
+//   cellsPerUnit - 每单位坐标的网格单元数
+//   maxColor - 合并后颜色通道的上限
+// 返回值：
+//   size_t - 合并掉的点数
+//==========================================================================
+size_t ScannerPipeline::MergePixelRuns(LaserFrame& points, float cellsPerUnit, float maxColor) {
+    if (points.Size() < 2 || !(cellsPerUnit > 0.0f)) {
+        return 0;
+    }
+    
+    MutableFrameView view = points.MutableView();
+    size_t kept = 0;
+    int32_t cellX = 0;
+    int32_t cellY = 0;
+    for (size_t i = 0; i < view.Count; ++i) {
+        const int32_t x = GetCellIndex(view.X[i], cellsPerUnit);
+        const int32_t y = GetCellIndex(view.Y[i], cellsPerUnit);
+        if (kept > 0 && x == cellX && y == cellY && view.Z[i] == 0.0f && view.Z[kept - 1] == 0.0f) {
+            const float r = view.R[kept - 1] + view.R[i];
+            const float g = view.G[kept - 1] + view.G[i];
+            const float b = view.B[kept - 1] + view.B[i];
+            if (r <= maxColor && g <= maxColor && b <= maxColor) {
+                view.R[kept - 1] = r;
+                view.G[kept - 1] = g;
+                view.B[kept - 1] = b;
+                continue;
+            }
+        }
+        if (kept != i) {
+            view.SetPoint(kept, view.GetPoint(i));
+        }
+        cellX = x;
+        cellY = y;
+        kept++;
+    }
+    
+    const size_t merged = view.Count - kept;
+    points.Resize(kept);
+    return merged;
+}
+
+//==========================================================================
+// 函数：SimplifyPoints
+// 描述：输入简化：以必须保留的点（见 IsSimplifyLink）分段，段内按 Douglas-Peucker 保留偏离超过容差的点
+//       用右端点栈代替递归，按顺序输出，栈深度不超过段内点数
+// 参数：
+//   raw - 原始点
+//   tolerance - 容差
+//   out - [输出] 保留的点
+//   arena - 暂存使用的帧内存池
+//   spans - [输出] 各保留段代表的原始段数（可为空）
+// 返回值：
+//   size_t - 保留的点数
+//==========================================================================
+size_t ScannerPipeline::SimplifyPoints(const FrameView& raw, float tolerance, const MutableFrameView& out,
+                                       FrameArena* arena, size_t* spans) {
+    if (raw.Count <= 2 || !(tolerance > 0.0f)) {
+        for (size_t i = 0; i < raw.Count; ++i) {
+            out.SetPoint(i, raw.GetPoint(i));
+            if (spans) {
+                spans[i] = 1;
+            }
+        }
+        return raw.Count;
+    }
+    
+    std::vector<size_t> stackStorage;
+    size_t* ends = nullptr;
+    if (arena) {
+        ends = arena->AllocateArray<size_t>(raw.Count);
+    } else {
+        stackStorage.resize(raw.Count);
+        ends = stackStorage.data();
+    }
+    
+    const float toleranceSq = tolerance * tolerance;
+    size_t kept = 0;
+    out.SetPoint(kept++, raw.GetPoint(0));
+    size_t anchor = 0;
+    size_t previous = 0;
+    bool linkedToPrevious = IsSimplifyLink(raw, 0);
+    for (size_t next = 1; next < raw.Count; ++next) {
+        const bool linkedToNext = next + 1 < raw.Count && IsSimplifyLink(raw, next);
+        const bool removable = linkedToPrevious && linkedToNext && raw.Z[next] == 0.0f;
+        linkedToPrevious = linkedToNext;
+        if (removable) {
+            continue;
+        }
+        
+        // 在 (anchor, next) 内细分：先处理左半部分，区间内没有超出容差的点时输出右端点
+        size_t depth = 0;
+        ends[depth++] = next;
+        size_t first = anchor;
+        while (depth > 0) {
+            const size_t last = ends[depth - 1];
+            const size_t split = FindFarthestPoint(raw, first, last, toleranceSq);
+            if (split != 0) {
+                ends[depth++] = split;
+                continue;
+            }
+            if (spans) {
+                spans[kept - 1] = last - previous;
+            }
+            previous = last;
+            out.SetPoint(kept++, raw.GetPoint(last));
+            first = last;
+            --depth;
+        }
+        anchor = next;
+    }
+    return kept;
+}
+
+//==========================================================================
+// 函数：DecimateToBudget
+// 描述：点预算抽取：第一遍标记必须保留的点，第二遍按误差扩散抽取可见点并原地压缩
+// 参数：
+//   points - [输入/输出] 点列表
+//   budget - 点数预算
+//   arena - 暂存使用的帧内存池
+// 返回值：
+//   size_t - 抽取掉的点数
+//==========================================================================
+size_t ScannerPipeline::DecimateToBudget(LaserFrame& points, size_t budget, FrameArena* arena) {
+    const size_t count = points.Size();
+    if (budget == 0 || count <= budget || count <= 2) {
+        return 0;
+    }
+    
+    std::vector<uint8_t> classStorage;
+    uint8_t* classes = nullptr;
+    if (arena) {
+        classes = arena->AllocateArray<uint8_t>(count);
+    } else {
+        classStorage.resize(count);
+        classes = classStorage.data();
+    }
+    
+    MutableFrameView view = points.MutableView();
+    size_t keepCount = 0;
+    size_t optionalCount = 0;
+    size_t colorRef = 0;
+    float refX = 0.0f;
+    float refY = 0.0f;
+    bool hasDirection = false;
+    bool previousBlank = false;
+    for (size_t i = 0; i < count; ++i) {
+        const bool blank = IsBlank(view.R[i], view.G[i], view.B[i]);
+        bool keep = i == 0 || i + 1 == count || view.Z[i] != 0.0f;
+        if (i > 0 && blank != previousBlank) {
+            // 消隐变化：两侧的点都保留，可见线段的端点不被抽走
+            keep = true;
+            if (classes[i - 1] == BudgetOptional) {
+                optionalCount--;
+            }
+            if (classes[i - 1] != BudgetKeep) {
+                classes[i - 1] = BudgetKeep;
+                keepCount++;
+            }
+        }
+        if (!blank && !keep) {
+            const float dr = std::abs(view.R[i] - view.R[colorRef]);
+            const float dg = std::abs(view.G[i] - view.G[colorRef]);
+            const float db = std::abs(view.B[i] - view.B[colorRef]);
+            keep = dr + dg + db > BudgetColorStep;
+        }
+        if (i + 1 < count) {
+            // 方向相对参考方向转过 30° 时保留转折点并以当前方向为新参考
+            const float dx = view.X[i + 1] - view.X[i];
+            const float dy = view.Y[i + 1] - view.Y[i];
+            const float lengthSq = dx * dx + dy * dy;
+            if (lengthSq > 0.0f) {
+                // dot < cos × |d| 的无开方形式，只在更新参考方向时开方
+                const float dot = dx * refX + dy * refY;
+                const bool turned = hasDirection && (dot < 0.0f || dot * dot < BudgetTurnCosine * BudgetTurnCosine * lengthSq);
+                if (turned || !hasDirection) {
+                    const float length = std::sqrt(lengthSq);
+                    keep = keep || turned;
+                    refX = dx / length;
+                    refY = dy / length;
+                    hasDirection = true;
+                }
+            }
+        }
+        
+        if (keep) {
+            classes[i] = BudgetKeep;
+            keepCount++;
+            colorRef = i;
+        } else if (blank) {
+            classes[i] = BudgetBlank;
+        } else {
+            classes[i] = BudgetOptional;
+            optionalCount++;
+        }
+        previousBlank = blank;
+    }
+    
+    // 可见点按误差扩散均匀保留 quota 个，必须保留的点已超出预算时不保留可选点
+    const size_t quota = keepCount < budget ? (std::min)(budget - keepCount, optionalCount) : 0;
+    size_t error = 0;
+    size_t kept = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (classes[i] == BudgetOptional) {
+            error += quota;
+            if (error < optionalCount) {
+                continue;
+            }
+            error -= optionalCount;
+        } else if (classes[i] == BudgetBlank) {
+            continue;
+        }
+        if (kept != i) {
+            view.SetPoint(kept, view.GetPoint(i));
+        }
+        kept++;
+    }
+    
+    points.Resize(kept);
+    return count - kept;
+}
+
+//==========================================================================
+// 函数：BuildGalvoResponse
+// 描述：二阶振镜模型的零阶保持离散化：A = [0 1; -ω² -2ζω]，B = [0 ω²]ᵀ
+//       Φ = exp(A·Δt) 用缩放平方法（缩放到范数 ≤ 0.5 后 Taylor 展开 12 阶）计算，
+//       Γ = A⁻¹·(Φ - I)·B 展开为 [1 - Φ11 - 2ζω·Φ01, ω²·Φ01]；
+//       系数数取最慢极点的包络 e^(-σ·j·Δt) 衰减到 GalvoTailTolerance 处（σ = ζω，过阻尼时为 ω(ζ - √(ζ² - 1))）
+// 参数：
+//   naturalFrequency - 固有频率（Hz）
+//   damping - 阻尼比
+//   samplePeriod - 样本时长（秒）
+// 返回值：
+//   GalvoResponse - 离散化结果（参数无效时 Taps 为空）
+//==========================================================================
+GalvoResponse ScannerPipeline::BuildGalvoResponse(float naturalFrequency, float damping, double samplePeriod) {
+    GalvoResponse galvo;
+    if (!(naturalFrequency > 0.0f) || !(damping > 0.0f) || !(samplePeriod > 0.0) ||
+        !std::isfinite(naturalFrequency) || !std::isfinite(damping) || !std::isfinite(samplePeriod)) {
+        return galvo;
+    }
+    
+    const double omega = 2.0 * 3.14159265358979323846 * naturalFrequency;
+    const double zeta = damping;
+    
+    // exp(M)，M = A·Δt / 2^squarings
+    double m[4] = { 0.0, samplePeriod, -omega * omega * samplePeriod, -2.0 * zeta * omega * samplePeriod };
+    int squarings = 0;
+    double norm = (std::max)(std::abs(m[0]) + std::abs(m[1]), std::abs(m[2]) + std::abs(m[3]));
+    while (norm > 0.5) {
+        norm *= 0.5;
+        squarings++;
+    }
+    const double scale = std::ldexp(1.0, -squarings);
+    for (double& value : m) {
+        value *= scale;
+    }
+    double phi[4] = { 1.0, 0.0, 0.0, 1.0 };
+    double term[4] = { 1.0, 0.0, 0.0, 1.0 };
+    for (int order = 1; order <= 12; ++order) {
+        const double next[4] = {
+            (term[0] * m[0] + term[1] * m[2]) / order, (term[0] * m[1] + term[1] * m[3]) / order,
+            (term[2] * m[0] + term[3] * m[2]) / order, (term[2] * m[1] + term[3] * m[3]) / order
+        };
+        for (int i = 0; i < 4; ++i) {
+            term[i] = next[i];
+            phi[i] += next[i];
+        }
+    }
+    for (int i = 0; i < squarings; ++i) {
+        const double squared[4] = {
+            phi[0] * phi[0] + phi[1] * phi[2], phi[0] * phi[1] + phi[1] * phi[3],
+            phi[2] * phi[0] + phi[3] * phi[2], phi[2] * phi[1] + phi[3] * phi[3]
+        };
+        std::memcpy(phi, squared, sizeof(phi));
+    }
+    std::memcpy(galvo.Transition, phi, sizeof(phi));
+    galvo.Input[0] = 1.0 - phi[3] - 2.0 * zeta * omega * phi[1];
+    galvo.Input[1] = omega * omega * phi[1];
+    
+    // 截断长度：最慢极点的包络衰减到容差
+    const double decay = zeta < 1.0 ? zeta * omega : omega * (zeta - std::sqrt(zeta * zeta - 1.0));
+    const double length = std::ceil(std::log(1.0 / GalvoTailTolerance) / (decay * samplePeriod));
+    const size_t tapCount = length < static_cast<double>(MaxGalvoTaps) ? (std::max)(static_cast<size_t>(length), static_cast<size_t>(1))
+                                                                        : MaxGalvoTaps;
+    
+    // h[j] = [1 0]·Φʲ·Γ；双精度累加后按和归一化，静止输入的输出等于输入
+    std::vector<double> response(tapCount);
+    double state[2] = { galvo.Input[0], galvo.Input[1] };
+    double sum = 0.0;
+    for (size_t j = 0; j < tapCount; ++j) {
+        response[j] = state[0];
+        sum += state[0];
+        const double position = phi[0] * state[0] + phi[1] * state[1];
+        const double velocity = phi[2] * state[0] + phi[3] * state[1];
+        state[0] = position;
+        state[1] = velocity;
+    }
+    if (!(std::abs(sum) > 0.0)) {
+        return galvo;
+    }
+    
+    // 截断误差：继续推进到包络低于 1e-12（至多 64 倍最大系数数），累加被丢弃系数的绝对值
+    const double tailEnd = std::ceil(std::log(1e12) / (decay * samplePeriod));
+    const size_t tailCount = tailEnd < static_cast<double>(64 * MaxGalvoTaps) ? static_cast<size_t>(tailEnd) : 64 * MaxGalvoTaps;
+    double tail = 0.0;
+    for (size_t j = tapCount; j < tailCount; ++j) {
+        tail += std::abs(state[0]);
+        const double position = phi[0] * state[0] + phi[1] * state[1];
+        const double velocity = phi[2] * state[0] + phi[3] * state[1];
+        state[0] = position;
+        state[1] = velocity;
+    }
+    galvo.TailMass = tail / std::abs(sum);
+    galvo.Taps.resize(tapCount);
+    for (size_t j = 0; j < tapCount; ++j) {
+        galvo.Taps[j] = static_cast<float>(response[j] / sum);
+    }
+    return galvo;
+}
+
+//==========================================================================
+// 函数：IsSimdLevelSupported
+// 描述：检查实现级别是否可用
+// 参数：
+//   level - 实现级别
+// 返回值：
+//   bool - 可用返回 true
+//==========================================================================
+bool ScannerPipeline::IsSimdLevelSupported(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Auto:
+        case SimdLevel::Scalar:
+            return true;
+        case SimdLevel::SSE:
+#if BEYONDLINK_SCAN_SSE2
+            return true;
+#else
+            return false;
+#endif
+        case SimdLevel::AVX:
+#if BEYONDLINK_SCAN_AVX
+            return HasAvx();
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+//==========================================================================
+// 函数：ShadeSamples
+// 描述：按指定实现级别执行延迟着色
+// 参数：
+//   samples - [输入/输出] 样本
+//   speedSq - 各样本的速度平方
+//   edgeFade - 边缘淡化因子
+//   level - 实现级别
+// 返回值：
+//   bool - 级别不受支持时返回 false
+//==========================================================================
+bool ScannerPipeline::ShadeSamples(const MutableFrameView& samples, const float* speedSq, float edgeFade,
+                                   SimdLevel level) {
+    if (!IsSimdLevelSupported(level)) {
+        return false;
+    }
+    const ShadingConstants shading = Core::GetShadingConstants(edgeFade);
+    switch (level) {
+        case SimdLevel::Auto:
+            Core::ShadeSamples(samples, speedSq, 0, samples.Count, shading);
+            break;
+        case SimdLevel::Scalar:
+            ShadeSamplesScalar(samples, speedSq, 0, samples.Count, shading);
+            break;
+        case SimdLevel::SSE:
+#if BEYONDLINK_SCAN_SSE2
+            ShadeSamplesSSE(samples, speedSq, 0, samples.Count, shading);
+#endif
+            break;
+        case SimdLevel::AVX:
+#if BEYONDLINK_SCAN_AVX
+            ShadeSamplesAVX(samples, speedSq, 0, samples.Count, shading);
+#endif
+            break;
+    }
+    return true;
+}
+
+//==========================================================================
+// 函数：ConvolveTaps
+// 描述：按指定实现级别执行 FIR 卷积
+// 参数：
+//   input - 输入样本
+//   taps - 卷积系数（窗口顺序）
+//   tapCount - 系数数
+//   first, last - 输出范围
+//   output - [输出] 卷积结果
+//   level - 实现级别
+// 返回值：
+//   bool - 级别不受支持时返回 false
+//==========================================================================
+bool ScannerPipeline::ConvolveTaps(const float* input, const float* taps, size_t tapCount,
+                                   size_t first, size_t last, float* output, SimdLevel level) {
+    if (!IsSimdLevelSupported(level)) {
+        return false;
+    }
+    switch (level) {
+        case SimdLevel::Auto:
+            Core::ConvolveTaps(input, taps, tapCount, first, last, output);
+            break;
+        case SimdLevel::Scalar:
+            ConvolveTapsScalar(input, taps, tapCount, first, last, output);
+            break;
+        case SimdLevel::SSE:
+#if BEYONDLINK_SCAN_SSE2
+            ConvolveTapsSSE(input, taps, tapCount, first, last, output);
+#endif
+            break;
+        case SimdLevel::AVX:
+#if BEYONDLINK_SCAN_AVX
+            ConvolveTapsAVX(input, taps, tapCount, first, last, output);
+#endif
+            break;
+    }
+    return true;
+}
+
+//==========================================================================
+// 函数：Run
+// 描述：选择特化实例并执行融合处理
+// 参数：
+//   raw - 原始点
+//   params - 处理参数
+//   processed - [输出] 主点列表
+//   beam - [输出] 光束点列表
+//==========================================================================
+void ScannerPipeline::Run(const FrameView& raw, const ScannerPipelineParams& params,
+                          LaserFrame& processed, LaserFrame& beam) {
+    Select(params)(raw, params, processed, beam);
+}
+
+} // namespace Core
+} // namespace BeyondLink
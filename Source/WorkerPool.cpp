@@ -0,0 +1,210 @@
+﻿//==============================================================================
+// BeyondLink - Beyond激光可视化系统
+// 文件：WorkerPool.cpp
+// 作者：Yunsio
+// 日期：2025-10-06
+// 描述：常驻工作线程池实现（每线程任务队列 + 工作窃取）
+//==============================================================================
+
+#include "WorkerPool.h"
+#include <algorithm>
+
+namespace BeyondLink {
+namespace Core {
+
+namespace {
+
+// 当前线程是否正在执行线程池任务（嵌套调用时串行执行，避免死锁）
+thread_local bool t_InsidePool = false;
+
+} // namespace
+
+//==========================================================================
+// 构造函数：WorkerPool
+// 描述：创建工作线程
+// 参数：
+//   workerCount - 工作线程数
+//==========================================================================
+WorkerPool::WorkerPool(size_t workerCount)
+    : m_Queues(new TaskQueue[workerCount + 1])
+    , m_Task(nullptr)
+    , m_StealCount(0)
+    , m_PendingWorkers(0)
+    , m_Batch(0)
+    , m_Stopping(false)
+{
+    m_Workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i) {
+        m_Workers.emplace_back(&WorkerPool::WorkerLoop, this, i + 1);
+    }
+}
+
+//==========================================================================
+// 析构函数：~WorkerPool
+// 描述：通知并等待所有工作线程退出
+//==========================================================================
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stopping = true;
+    }
+    m_WakeCondition.notify_all();
+    
+    for (auto& worker : m_Workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+//==========================================================================
+// 函数：ParallelFor
+// 描述：发布任务批次，调用线程参与执行，等待所有工作线程完成
+// 参数：
+//   taskCount - 任务数量
+//   task - 任务函数
+//==========================================================================
+void WorkerPool::ParallelFor(size_t taskCount, const std::function<void(size_t)>& task) {
+    if (taskCount == 0) {
+        return;
+    }
+    
+    // 无工作线程、单个任务、嵌套调用或线程池被占用：串行执行
+    if (m_Workers.empty() || taskCount == 1 || t_InsidePool || !m_SubmitMutex.try_lock()) {
+        for (size_t i = 0; i < taskCount; ++i) {
+            task(i);
+        }
+        return;
+    }
+    std::lock_guard<std::mutex> submitLock(m_SubmitMutex, std::adopt_lock);
+    
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        
+        // 任务按序号轮流分配：调用者按代价降序排列时，每个线程都先拿到一个重任务
+        const size_t concurrency = GetConcurrency();
+        for (size_t q = 0; q < concurrency; ++q) {
+            m_Queues[q].Tasks.clear();
+            m_Queues[q].Head = 0;
+        }
+        for (size_t i = 0; i < taskCount; ++i) {
+            m_Queues[i % concurrency].Tasks.push_back(i);
+        }
+        
+        m_Task = &task;
+        m_PendingWorkers = m_Workers.size();
+        m_Batch++;
+    }
+    m_WakeCondition.notify_all();
+    
+    t_InsidePool = true;
+    RunTasks(0);
+    t_InsidePool = false;
+    
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_DoneCondition.wait(lock, [this]() { return m_PendingWorkers == 0; });
+    m_Task = nullptr;
+}
+
+//==========================================================================
+// 函数：GetDefaultWorkerCount
+// 描述：计算默认工作线程数
+// 参数：
+//   requested - 配置的线程数（<= 0 表示自动）
+// 返回值：
+//   size_t - 工作线程数
+//==========================================================================
+size_t WorkerPool::GetDefaultWorkerCount(int requested) {
+    if (requested > 0) {
+        return static_cast<size_t>(requested);
+    }
+    unsigned int hardware = std::thread::hardware_concurrency();
+    return hardware > 1 ? static_cast<size_t>(hardware - 1) : 0;
+}
+
+//==========================================================================
+// 函数：WorkerLoop
+// 描述：工作线程主循环
+//==========================================================================
+void WorkerPool::WorkerLoop(size_t self) {
+    t_InsidePool = true;
+    uint64_t seenBatch = 0;
+    
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_WakeCondition.wait(lock, [&]() { return m_Stopping || m_Batch != seenBatch; });
+            if (m_Stopping) {
+                return;
+            }
+            seenBatch = m_Batch;
+        }
+        
+        RunTasks(self);
+        
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (--m_PendingWorkers == 0) {
+            m_DoneCondition.notify_one();
+        }
+    }
+}
+
+//==========================================================================
+// 函数：RunTasks
+// 描述：执行自己队列中的任务，队列空后窃取其他队列的任务
+// 参数：
+//   self - 当前线程的队列序号
+//==========================================================================
+void WorkerPool::RunTasks(size_t self) {
+    const std::function<void(size_t)>& task = *m_Task;
+    size_t index = 0;
+    while (PopTask(self, index) || StealTask(self, index)) {
+        task(index);
+    }
+}
+
+//==========================================================================
+// 函数：PopTask
+// 描述：从自己队列头部领取任务
+// 参数：
+//   self - 当前线程的队列序号
+//   task - [输出] 任务序号
+// 返回值：
+//   bool - 队列为空返回 false
+//==========================================================================
+bool WorkerPool::PopTask(size_t self, size_t& task) {
+    TaskQueue& queue = m_Queues[self];
+    std::lock_guard<std::mutex> lock(queue.Mutex);
+    if (queue.Head >= queue.Tasks.size()) {
+        return false;
+    }
+    task = queue.Tasks[queue.Head++];
+    return true;
+}
+
+//==========================================================================
+// 函数：StealTask
+// 描述：依次从其他线程队列尾部窃取任务
+// 参数：
+//   self - 当前线程的队列序号
+//   task - [输出] 任务序号
+// 返回值：
+//   bool - 所有队列都为空返回 false
+//==========================================================================
+bool WorkerPool::StealTask(size_t self, size_t& task) {
+    const size_t concurrency = GetConcurrency();
+    for (size_t offset = 1; offset < concurrency; ++offset) {
+        TaskQueue& victim = m_Queues[(self + offset) % concurrency];
+        std::lock_guard<std::mutex> lock(victim.Mutex);
+        if (victim.Head < victim.Tasks.size()) {
+            task = victim.Tasks.back();
+            victim.Tasks.pop_back();
+            m_StealCount.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace Core
+} // namespace BeyondLink
@@ -0,0 +1,208 @@
+﻿//==============================================================================
+// BeyondLink - Beyond激光可视化系统
+// 文件：AdaptiveSamplingTests.cpp
+// 作者：Yunsio
+// 日期：2025-10-06
+// 描述：自适应插值实例的正确性测试
+//       对照 ReferencePipeline 的逐步自适应插值（每段等分数、t = s / d、帧末段终点、
+//       按段时长换算的递推参数和颜色权重）：单线程逐位一致，分块并行扫描和向量化着色按 1e-4 容差；
+//       并检查样本总数上限和 Ultra 质量下的输出点数；
+//       输入简化的合并段按代表的原始段数取样：对照参考路径，固定样本数和振镜模型的样本总数与不简化时相同
+//==============================================================================
+
+#include "ReferencePipeline.h"
+#include "TestCommon.h"
+#include "WorkerPool.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace BeyondLink::Core;
+using namespace BeyondLink::Tests;
+
+namespace {
+
+//==========================================================================
+// 函数：MakeUnevenFrame
+// 描述：生成段长悬殊的测试帧：短段（低于间距）、长跳转和零长度驻留交替，附带随机帧的空白和光束点
+//==========================================================================
+LaserFrame MakeUnevenFrame(std::mt19937& rng, size_t count) {
+    LaserFrame frame = MakeRandomFrame(rng, count);
+    MutableFrameView view = frame.MutableView();
+    std::uniform_real_distribution<float> jitter(-0.002f, 0.002f);
+    for (size_t i = 1; i < view.Count; ++i) {
+        if (i % 3 == 1) {
+            view.X[i] = view.X[i - 1] + jitter(rng);
+            view.Y[i] = view.Y[i - 1] + jitter(rng);
+        }
+    }
+    return frame;
+}
+
+//==========================================================================
+// 函数：MakeStrokeFrame
+// 描述：生成由共线细分的笔画组成的测试帧：每笔 steps + 1 个等距点、颜色相同，笔画之间为空白跳转
+//==========================================================================
+LaserFrame MakeStrokeFrame(std::mt19937& rng, size_t strokes, size_t steps) {
+    std::uniform_real_distribution<float> position(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> color(0.2f, 1.0f);
+    LaserFrame frame;
+    for (size_t stroke = 0; stroke < strokes; ++stroke) {
+        const float x0 = position(rng);
+        const float y0 = position(rng);
+        const float x1 = position(rng);
+        const float y1 = position(rng);
+        const float r = color(rng);
+        const float g = color(rng);
+        const float b = color(rng);
+        if (stroke > 0) {
+            frame.Append(LaserPoint(x0, y0, 0.0f, 0.0f, 0.0f));
+        }
+        for (size_t s = 0; s <= steps; ++s) {
+            const float t = static_cast<float>(s) / static_cast<float>(steps);
+            frame.Append(LaserPoint(x0 + (x1 - x0) * t, y0 + (y1 - y0) * t, r, g, b));
+        }
+    }
+    return frame;
+}
+
+} // namespace
+
+int main() {
+    const int factors[][2] = { { 8, 8 }, { 4, 8 }, { 2, 2 }, { 1, 1 }, { 2, 4 } };
+    const int sampleCounts[] = { 2, 5, 8, 12 };
+    const float spacings[] = { 0.0f, 0.004f, 0.05f, 0.3f };
+    const LaserSettings::InterpolationMode interpolations[] = {
+        LaserSettings::InterpolationMode::Linear, LaserSettings::InterpolationMode::Hermite
+    };
+    
+    WorkerPool pool(3);
+    std::mt19937 rng(11);
+    std::vector<LaserFrame> frames;
+    for (size_t size : { size_t(2), size_t(3), size_t(40), size_t(900) }) {
+        frames.push_back(MakeUnevenFrame(rng, size));
+    }
+    
+    int cases = 0;
+    for (const int* factor : factors) {
+        for (int sampleCount : sampleCounts) {
+            for (float spacing : spacings) {
+                for (int flags = 0; flags < 64; ++flags) {
+                    ScannerPipelineParams params;
+                    params.SampleCount = sampleCount;
+                    params.AdaptiveSampling = true;
+                    params.AdaptiveSpacing = spacing;
+                    params.AdaptiveMinSamples = (flags & 1) != 0 ? 2 : 1;
+                    params.AdaptiveMaxSamples = (flags & 2) != 0 ? sampleCount * 2 : sampleCount;
+                    params.ProcessedFactor = factor[0];
+                    params.BeamFactor = factor[1];
+                    params.BeamBrush = (flags & 4) != 0;
+                    params.CullBlankSegments = (flags & 8) != 0;
+                    params.Interpolation = interpolations[(flags >> 4) & 1];
+                    params.EdgeFade = 0.1f + 0.2f * static_cast<float>(sampleCount % 4);
+                    params.VelocitySmoothing = 0.7f + 0.05f * static_cast<float>(sampleCount % 4);
+                    
+                    // 位 5：分块并行扫描（预热窗口）和向量化着色，按 1e-4 容差比较；
+                    // 位置有误差时光束画刷去重在阈值附近的判断可能不同，不组合
+                    const bool approximate = (flags & 32) != 0;
+                    if (approximate && params.BeamBrush) {
+                        continue;
+                    }
+                    if (approximate) {
+                        params.Pool = &pool;
+                        params.ParallelMinSamples = 0;
+                        params.VectorizedShading = (flags & 1) != 0;
+                    }
+                    const float tolerance = approximate ? 1e-4f : 0.0f;
+                    
+                    for (const LaserFrame& raw : frames) {
+                        LaserFrame processed;
+                        LaserFrame beam;
+                        LaserFrame expectedProcessed;
+                        LaserFrame expectedBeam;
+                        ScannerPipelineStats stats;
+                        params.Stats = &stats;
+                        ScannerPipeline::Select(params)(raw.View(), params, processed, beam);
+                        params.Stats = nullptr;
+                        RunReferencePipeline(raw, params, expectedProcessed, expectedBeam);
+                        ++cases;
+                        
+                        BEYONDLINK_CHECK(CompareFrames(processed, expectedProcessed, tolerance, tolerance) &&
+                                         CompareFrames(beam, expectedBeam, tolerance, tolerance),
+                                         ScannerPipeline::GetVariantName(params) << ", spacing " << spacing
+                                         << ", min " << params.AdaptiveMinSamples << ", max " << params.AdaptiveMaxSamples
+                                         << (approximate ? ", pool" : "") << ", " << raw.Size() << " raw points, processed "
+                                         << processed.Size() << "/" << expectedProcessed.Size());
+                        
+                        // 样本总数不超过 (N - 1) × 最多样本数 + 1
+                        const uint64_t maxSamples = static_cast<uint64_t>(raw.Size() - 1) *
+                                                    static_cast<uint64_t>(params.AdaptiveMaxSamples) + 1;
+                        BEYONDLINK_CHECK(stats.Samples <= maxSamples,
+                                         stats.Samples << " samples exceed the bound " << maxSamples);
+                        
+                        // Ultra 质量、不去重不剔除时每个样本都输出
+                        if (params.ProcessedFactor == 1 && !params.BeamBrush && !params.CullBlankSegments) {
+                            BEYONDLINK_CHECK(processed.Size() == stats.Samples,
+                                             "p1 output " << processed.Size() << " != samples " << stats.Samples);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    
+    // 输入简化：合并段取 k 倍的样本数和时长
+    const size_t strokeCount = 6;
+    std::vector<LaserFrame> strokeFrames;
+    for (size_t steps : { size_t(1), size_t(4), size_t(37) }) {
+        strokeFrames.push_back(MakeStrokeFrame(rng, strokeCount, steps));
+    }
+    for (int sampleCount : sampleCounts) {
+        for (int mode = 0; mode < 3; ++mode) {
+            LaserSettings settings;
+            settings.SampleCount = sampleCount;
+            settings.LaserQuality = LaserSettings::QualityLevel::Ultra;
+            settings.AdaptiveSampling = mode == 1;
+            settings.AdaptivePixelSpacing = 3.0f;
+            settings.AdaptiveMaxSamples = sampleCount * 2;
+            if (mode == 2) {
+                settings.ScannerResponse = LaserSettings::ScannerModel::Galvo;
+            }
+            ScannerPipelineParams params = ScannerPipelineParams::FromSettings(settings, true, false);
+            params.SimplifyTolerance = 1e-3f;
+            
+            for (const LaserFrame& raw : strokeFrames) {
+                LaserFrame processed;
+                LaserFrame beam;
+                LaserFrame expectedProcessed;
+                LaserFrame expectedBeam;
+                ScannerPipelineStats stats;
+                params.Stats = &stats;
+                ScannerPipeline::Select(params)(raw.View(), params, processed, beam);
+                params.Stats = nullptr;
+                RunReferencePipeline(raw, params, expectedProcessed, expectedBeam);
+                ++cases;
+                
+                // 振镜模型：位置差来自脉冲响应截断，颜色经速度放大
+                const float tolerance = mode == 2 ? static_cast<float>(1e-4 + 3.0 * params.Galvo.TailMass) : 0.0f;
+                const float colorTolerance = mode == 2 ? 1e-2f : 0.0f;
+                BEYONDLINK_CHECK(CompareFrames(processed, expectedProcessed, tolerance, colorTolerance) &&
+                                 CompareFrames(beam, expectedBeam, tolerance, colorTolerance),
+                                 "simplified " << ScannerPipeline::GetVariantName(params) << ", " << raw.Size()
+                                 << " raw points, processed " << processed.Size() << "/" << expectedProcessed.Size());
+                
+                // 每笔的内部点都被移除（每笔保留两端，跳转保留空白点）；
+                // 固定样本数和振镜模型：样本总数 (N - 1) × S + 1（样本周期不变）
+                const size_t removable = raw.Size() - (3 * strokeCount - 1);
+                if (!params.AdaptiveSampling) {
+                    const uint64_t expectedSamples = static_cast<uint64_t>(raw.Size() - 1) *
+                                                     static_cast<uint64_t>(sampleCount) + 1;
+                    BEYONDLINK_CHECK(stats.Samples == expectedSamples && stats.SimplifiedPoints == removable,
+                                     "simplified " << ScannerPipeline::GetVariantName(params) << ": " << stats.Samples
+                                     << " samples, expected " << expectedSamples << ", " << stats.SimplifiedPoints
+                                     << " points removed");
+                }
+            }
+        }
+    }
+    return FinishTests("AdaptiveSamplingTests", cases);
+}
@@ -0,0 +1,264 @@
+﻿//==============================================================================
+// BeyondLink - Beyond激光可视化系统
+// 文件：GalvoResponseTests.cpp
+// 作者：Yunsio
+// 日期：2025-10-06
+// 描述：振镜模型测试
+//       BuildGalvoResponse 的离散化对照二阶系统阶跃响应解析解，脉冲响应系数与截断质量对照双精度递推；
+//       FIR 卷积对照直接递推（按 TailMass 放宽），标量 / SSE / AVX 卷积逐位一致，
+//       分块并行卷积与单线程输出逐位一致，融合处理对照参考路径的直接递推
+//==============================================================================
+
+#include "TestCommon.h"
+#include "ReferencePipeline.h"
+#include "ScannerPipeline.h"
+#include "WorkerPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <vector>
+
+using namespace BeyondLink::Core;
+using namespace BeyondLink::Tests;
+
+namespace {
+
+//==========================================================================
+// 结构体：GalvoCase
+// 描述：振镜参数组合（样本时长 = 1 / (扫描速率 × 每段样本数)）
+//==========================================================================
+struct GalvoCase {
+    float NaturalFrequency;
+    float Damping;
+    double SamplePeriod;
+};
+
+//==========================================================================
+// 函数：GetStepResponse
+// 描述：y'' + 2ζω·y' + ω²·y = ω² 从静止开始的单位阶跃响应解析解（欠阻尼、临界阻尼、过阻尼）
+//==========================================================================
+double GetStepResponse(double naturalFrequency, double damping, double time) {
+    const double omega = 2.0 * 3.14159265358979323846 * naturalFrequency;
+    if (damping < 1.0) {
+        const double damped = omega * std::sqrt(1.0 - damping * damping);
+        return 1.0 - std::exp(-damping * omega * time) *
+                     (std::cos(damped * time) + damping / std::sqrt(1.0 - damping * damping) * std::sin(damped * time));
+    }
+    if (damping == 1.0) {
+        return 1.0 - std::exp(-omega * time) * (1.0 + omega * time);
+    }
+    const double root = std::sqrt(damping * damping - 1.0);
+    const double s1 = -omega * (damping - root);
+    const double s2 = -omega * (damping + root);
+    return 1.0 - (s2 * std::exp(s1 * time) - s1 * std::exp(s2 * time)) / (s2 - s1);
+}
+
+//==========================================================================
+// 函数：Step
+// 描述：状态推进一步：s = Φ·s + Γ·u
+//==========================================================================
+void Step(const GalvoResponse& galvo, double state[2], double input) {
+    const double* phi = galvo.Transition;
+    const double position = phi[0] * state[0] + phi[1] * state[1] + galvo.Input[0] * input;
+    const double velocity = phi[2] * state[0] + phi[3] * state[1] + galvo.Input[1] * input;
+    state[0] = position;
+    state[1] = velocity;
+}
+
+//==========================================================================
+// 函数：CheckResponse
+// 描述：检查离散化、脉冲响应系数和截断质量
+//==========================================================================
+void CheckResponse(const GalvoCase& test, const GalvoResponse& galvo) {
+    const size_t tapCount = galvo.Taps.size();
+    BEYONDLINK_CHECK(tapCount > 0 && tapCount <= 1024, "tap count " << tapCount << " out of range");
+    if (tapCount == 0) {
+        return;
+    }
+    
+    // 零阶保持离散化是精确的：阶跃输入下各样本时刻的位置等于解析解
+    double state[2] = { 0.0, 0.0 };
+    double stepError = 0.0;
+    for (int n = 1; n <= 2000; ++n) {
+        Step(galvo, state, 1.0);
+        const double expected = GetStepResponse(test.NaturalFrequency, test.Damping, n * test.SamplePeriod);
+        stepError = (std::max)(stepError, std::abs(state[0] - expected));
+    }
+    BEYONDLINK_CHECK(stepError <= 1e-9, "step response error " << stepError);
+    
+    // h[j] = [1 0]·Φʲ·Γ / Σh，丢弃部分的 Σ|h[j]| / Σh 为 TailMass
+    std::vector<double> response(tapCount);
+    double impulse[2] = { galvo.Input[0], galvo.Input[1] };
+    double sum = 0.0;
+    for (size_t j = 0; j < tapCount; ++j) {
+        response[j] = impulse[0];
+        sum += impulse[0];
+        Step(galvo, impulse, 0.0);
+    }
+    double tail = 0.0;
+    for (size_t j = tapCount; j < 64 * 1024; ++j) {
+        tail += std::abs(impulse[0]);
+        Step(galvo, impulse, 0.0);
+    }
+    tail /= std::abs(sum);
+    
+    double tapSum = 0.0;
+    double tapError = 0.0;
+    for (size_t j = 0; j < tapCount; ++j) {
+        tapSum += galvo.Taps[j];
+        tapError = (std::max)(tapError, std::abs(galvo.Taps[j] - response[j] / sum));
+    }
+    BEYONDLINK_CHECK(std::abs(tapSum - 1.0) <= 1e-5, "taps must sum to 1, got " << tapSum);
+    BEYONDLINK_CHECK(tapError <= 1e-7, "taps differ from the recurrence by " << tapError);
+    BEYONDLINK_CHECK(std::abs(galvo.TailMass - tail) <= 1e-9 + 1e-6 * tail,
+                     "tail mass " << galvo.TailMass << " != " << tail);
+    if (tapCount < 1024) {
+        BEYONDLINK_CHECK(galvo.TailMass <= 1e-4, "untruncated response must leave a negligible tail, got " << galvo.TailMass);
+    }
+}
+
+//==========================================================================
+// 函数：CheckConvolution
+// 描述：随机游走输入（前 L 个样本静止于首个输入）的 FIR 卷积：
+//       各实现级别逐位一致，且对照从静止开始的直接递推在 1e-5 + 3 × TailMass 以内
+//==========================================================================
+void CheckConvolution(std::mt19937& rng, const GalvoResponse& galvo, size_t count) {
+    const size_t tapCount = galvo.Taps.size();
+    std::vector<float> taps(galvo.Taps.rbegin(), galvo.Taps.rend());
+    std::uniform_real_distribution<float> step(-0.05f, 0.05f);
+    std::vector<float> input(tapCount + count);
+    float value = 0.2f;
+    for (size_t k = 0; k < count; ++k) {
+        value = (std::min)(1.0f, (std::max)(-1.0f, value + step(rng)));
+        input[tapCount + k] = value;
+    }
+    std::fill(input.begin(), input.begin() + tapCount, input[tapCount]);
+    
+    std::vector<float> scalar(count, 0.0f);
+    ScannerPipeline::ConvolveTaps(input.data(), taps.data(), tapCount, 0, count, scalar.data(),
+                                  ScannerPipeline::SimdLevel::Scalar);
+    
+    double state[2] = { input[tapCount], 0.0 };
+    double error = 0.0;
+    for (size_t n = 0; n < count; ++n) {
+        error = (std::max)(error, std::abs(scalar[n] - state[0]));
+        Step(galvo, state, input[tapCount + n]);
+    }
+    BEYONDLINK_CHECK(error <= 1e-5 + 3.0 * galvo.TailMass,
+                     "FIR vs direct recurrence error " << error << ", tail mass " << galvo.TailMass);
+    
+    // 不同起点（块边界）和长度覆盖各向量宽度的主循环与尾部
+    const ScannerPipeline::SimdLevel levels[] = { ScannerPipeline::SimdLevel::SSE, ScannerPipeline::SimdLevel::AVX,
+                                                  ScannerPipeline::SimdLevel::Auto };
+    const char* const levelNames[] = { "SSE", "AVX", "Auto" };
+    const size_t firsts[] = { 0, 1, 3, 17, count / 2 };
+    for (size_t l = 0; l < sizeof(levels) / sizeof(levels[0]); ++l) {
+        if (!ScannerPipeline::IsSimdLevelSupported(levels[l])) {
+            continue;
+        }
+        for (size_t first : firsts) {
+            first = (std::min)(first, count - 1);
+            std::vector<float> vector(count, std::numeric_limits<float>::quiet_NaN());
+            ScannerPipeline::ConvolveTaps(input.data(), taps.data(), tapCount, first, count, vector.data(), levels[l]);
+            BEYONDLINK_CHECK(std::memcmp(vector.data() + first, scalar.data() + first, (count - first) * sizeof(float)) == 0,
+                             levelNames[l] << " convolution differs from scalar, " << tapCount << " taps, range ["
+                             << first << ", " << count << ")");
+            BEYONDLINK_CHECK(first == 0 || std::isnan(vector[first - 1]), "output before the range must not be written");
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    const GalvoCase galvoCases[] = {
+        { 2500.0f, 0.7f, 1.0 / (30000.0 * 8.0) },     // 默认设置
+        { 2500.0f, 0.3f, 1.0 / (30000.0 * 2.0) },
+        { 1000.0f, 1.0f, 1.0 / (60000.0 * 4.0) },     // 临界阻尼
+        { 800.0f, 1.5f, 1.0 / (30000.0 * 8.0) },      // 过阻尼
+        { 5000.0f, 0.7f, 1.0 / 30000.0 },             // 不插值、系数很少
+        { 200.0f, 0.2f, 1.0 / (100000.0 * 16.0) }     // 系数数达到上限，尾部被截去
+    };
+    
+    int cases = 0;
+    
+    // 参数无效时 Taps 为空
+    const GalvoCase invalidCases[] = {
+        { 0.0f, 0.7f, 1e-5 }, { -100.0f, 0.7f, 1e-5 }, { std::numeric_limits<float>::quiet_NaN(), 0.7f, 1e-5 },
+        { std::numeric_limits<float>::infinity(), 0.7f, 1e-5 }, { 2500.0f, 0.0f, 1e-5 }, { 2500.0f, -0.5f, 1e-5 },
+        { 2500.0f, 0.7f, 0.0 }, { 2500.0f, 0.7f, std::numeric_limits<double>::infinity() }
+    };
+    for (const GalvoCase& test : invalidCases) {
+        const GalvoResponse galvo = ScannerPipeline::BuildGalvoResponse(test.NaturalFrequency, test.Damping, test.SamplePeriod);
+        ++cases;
+        BEYONDLINK_CHECK(galvo.Taps.empty(), "invalid parameters (" << test.NaturalFrequency << " Hz, damping "
+                         << test.Damping << ", period " << test.SamplePeriod << ") must disable the galvo model");
+    }
+    
+    std::mt19937 rng(11);
+    for (const GalvoCase& test : galvoCases) {
+        const GalvoResponse galvo = ScannerPipeline::BuildGalvoResponse(test.NaturalFrequency, test.Damping, test.SamplePeriod);
+        ++cases;
+        CheckResponse(test, galvo);
+        if (galvo.Taps.empty()) {
+            continue;
+        }
+        for (size_t count : { size_t(1), size_t(5), size_t(33), size_t(100), size_t(3001) }) {
+            ++cases;
+            CheckConvolution(rng, galvo, count);
+        }
+    }
+    
+    // 融合处理对照参考路径的直接递推，分块并行对照单线程逐位一致
+    std::vector<std::unique_ptr<WorkerPool>> pools;
+    for (size_t workers = 2; workers <= 3; ++workers) {
+        pools.push_back(std::make_unique<WorkerPool>(workers));
+    }
+    const LaserFrame small = MakeRandomFrame(rng, 300);
+    const LaserFrame large = MakeRandomFrame(rng, 6000);
+    const float scanRates[] = { 30.0f, 100.0f };
+    const float naturalFrequencies[] = { 2500.0f, 200.0f };
+    for (float scanRate : scanRates) {
+        for (float naturalFrequency : naturalFrequencies) {
+            for (int sampleCount : { 1, 4, 8 }) {
+                LaserSettings settings;
+                settings.ScannerResponse = LaserSettings::ScannerModel::Galvo;
+                settings.ScanRateKpps = scanRate;
+                settings.GalvoNaturalFrequency = naturalFrequency;
+                settings.SampleCount = sampleCount;
+                settings.EdgeFade = 0.3f;
+                const ScannerPipelineParams params = ScannerPipelineParams::FromSettings(settings, true, false);
+                
+                LaserFrame processed;
+                LaserFrame beam;
+                LaserFrame expectedProcessed;
+                LaserFrame expectedBeam;
+                ScannerPipeline::Run(small.View(), params, processed, beam);
+                RunReferencePipeline(small, params, expectedProcessed, expectedBeam);
+                ++cases;
+                const float tolerance = static_cast<float>(1e-4 + 3.0 * params.Galvo.TailMass);
+                BEYONDLINK_CHECK(CompareFrames(processed, expectedProcessed, tolerance, 1e-2f) &&
+                                 CompareFrames(beam, expectedBeam, tolerance, 1e-2f),
+                                 ScannerPipeline::GetVariantName(params) << " at " << scanRate << " kpps, "
+                                 << naturalFrequency << " Hz differs from the direct recurrence");
+                
+                LaserFrame serialProcessed;
+                LaserFrame serialBeam;
+                ScannerPipeline::Run(large.View(), params, serialProcessed, serialBeam);
+                for (const std::unique_ptr<WorkerPool>& pool : pools) {
+                    ScannerPipelineParams parallel = params;
+                    parallel.Pool = pool.get();
+                    parallel.ParallelMinSamples = 0;
+                    ScannerPipeline::Run(large.View(), parallel, processed, beam);
+                    ++cases;
+                    BEYONDLINK_CHECK(CompareFrames(processed, serialProcessed) && CompareFrames(beam, serialBeam),
+                                     ScannerPipeline::GetVariantName(parallel) << " with " << pool->GetConcurrency()
+                                     << " threads differs from serial at " << scanRate << " kpps, " << naturalFrequency << " Hz");
+                }
+            }
+        }
+    }
+    return FinishTests("GalvoResponseTests", cases);
+}
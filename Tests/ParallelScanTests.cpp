@@ -0,0 +1,117 @@
+﻿//==============================================================================
+// BeyondLink - Beyond激光可视化系统
+// 文件：ParallelScanTests.cpp
+// 作者：Yunsio
+// 日期：2025-10-06
+// 描述：分块并行扫描精度测试
+//       以 1 到 4 个工作线程、三种分块起始状态计算方式（自动、预热窗口、精确进位）处理大帧，
+//       对照单线程输出：默认平滑因子下要求逐位一致，接近 1 的平滑因子按实测误差上限比较
+//==============================================================================
+
+#include "TestCommon.h"
+#include "ScannerPipeline.h"
+#include "WorkerPool.h"
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+using namespace BeyondLink::Core;
+using namespace BeyondLink::Tests;
+
+namespace {
+
+//==========================================================================
+// 函数：GetMaxError
+// 描述：两帧对应点的最大位置误差和颜色误差（点数不同时返回 false）
+//==========================================================================
+bool GetMaxError(const LaserFrame& a, const LaserFrame& b, float& position, float& color) {
+    position = 0.0f;
+    color = 0.0f;
+    if (a.Size() != b.Size()) {
+        return false;
+    }
+    const FrameView va = a.View();
+    const FrameView vb = b.View();
+    for (size_t i = 0; i < va.Count; ++i) {
+        position = (std::max)(position, (std::max)(std::abs(va.X[i] - vb.X[i]), std::abs(va.Y[i] - vb.Y[i])));
+        color = (std::max)(color, (std::max)(std::abs(va.R[i] - vb.R[i]),
+                                             (std::max)(std::abs(va.G[i] - vb.G[i]), std::abs(va.B[i] - vb.B[i]))));
+        if (va.Z[i] != vb.Z[i] || va.Focus[i] != vb.Focus[i]) {
+            color = std::numeric_limits<float>::infinity();
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    const LaserSettings::ChunkSeeding seedings[] = {
+        LaserSettings::ChunkSeeding::Auto, LaserSettings::ChunkSeeding::WarmUp, LaserSettings::ChunkSeeding::ExactCarry
+    };
+    const char* const seedingNames[] = { "auto", "warm-up", "exact-carry" };
+    const float smoothings[] = { 0.5f, 0.83f, 0.95f, 0.999f };
+    const int sampleCounts[] = { 8, 5 };
+    
+    std::mt19937 rng(7);
+    const LaserFrame raw = MakeRandomFrame(rng, 6000);
+    
+    std::vector<std::unique_ptr<WorkerPool>> pools;
+    for (size_t workers = 1; workers <= 3; ++workers) {
+        pools.push_back(std::make_unique<WorkerPool>(workers));
+    }
+    
+    int cases = 0;
+    for (int sampleCount : sampleCounts) {
+        for (float smoothing : smoothings) {
+            for (int flags = 0; flags < 8; ++flags) {
+                ScannerPipelineParams params;
+                params.SampleCount = sampleCount;
+                params.VelocitySmoothing = smoothing;
+                params.EdgeFade = 0.3f;
+                params.BeamBrush = (flags & 1) != 0;
+                params.CullBlankSegments = (flags & 2) != 0;
+                params.VectorizedShading = (flags & 4) != 0;
+                params.ProcessedFactor = 2;
+                params.BeamFactor = 4;
+                
+                LaserFrame serialProcessed;
+                LaserFrame serialBeam;
+                ScannerPipeline::Run(raw.View(), params, serialProcessed, serialBeam);
+                
+                for (size_t s = 0; s < 3; ++s) {
+                    for (const std::unique_ptr<WorkerPool>& pool : pools) {
+                        ScannerPipelineParams parallel = params;
+                        parallel.Pool = pool.get();
+                        parallel.ParallelMinSamples = 0;
+                        parallel.Seeding = seedings[s];
+                        
+                        LaserFrame processed;
+                        LaserFrame beam;
+                        ScannerPipeline::Run(raw.View(), parallel, processed, beam);
+                        ++cases;
+                        
+                        float position = 0.0f;
+                        float color = 0.0f;
+                        float beamPosition = 0.0f;
+                        float beamColor = 0.0f;
+                        const bool sameSize = GetMaxError(processed, serialProcessed, position, color) &&
+                                              GetMaxError(beam, serialBeam, beamPosition, beamColor);
+                        position = (std::max)(position, beamPosition);
+                        color = (std::max)(color, beamColor);
+                        
+                        // 默认平滑因子附近块起点误差在首个样本内衰减到舍入以下；平滑因子 0.999 时按实测上限比较
+                        // 向量化着色按块着色，块边界改变哪些样本落在标量尾部（精确 1 / sqrt），颜色差在 rsqrt 误差内
+                        const float positionTolerance = smoothing < 0.9f ? 0.0f : 1e-5f;
+                        const float colorTolerance = smoothing < 0.9f ? (params.VectorizedShading ? 1e-5f : 0.0f) : 1e-4f;
+                        BEYONDLINK_CHECK(sameSize && position <= positionTolerance && color <= colorTolerance,
+                                         ScannerPipeline::GetVariantName(parallel) << " " << seedingNames[s] << ", "
+                                         << pool->GetConcurrency() << " threads, smoothing " << smoothing
+                                         << (parallel.VectorizedShading ? " vectorized" : "") << (parallel.CullBlankSegments ? " cull" : "") << ": position error " << position << ", color error " << color);
+                    }
+                }
+            }
+        }
+    }
+    return FinishTests("ParallelScanTests", cases);
+}
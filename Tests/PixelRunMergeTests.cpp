@@ -0,0 +1,213 @@
+﻿//==============================================================================
+// BeyondLink - Beyond激光可视化系统
+// 文件：PixelRunMergeTests.cpp
+// 作者：Yunsio
+// 日期：2025-10-06
+// 描述：LOD 合并（ScannerPipeline::MergePixelRuns）单元测试
+//       检查加法混合的颜色总和不变、光束点（Z ≠ 0）从不参与合并、
+//       合并后颜色不超过量化顶点上限 4，以及每个输出点都是同一单元内连续输入点的累加
+//==============================================================================
+
+#include "TestCommon.h"
+#include "ScannerPipeline.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace BeyondLink::Core;
+using namespace BeyondLink::Tests;
+
+namespace {
+
+// 量化顶点格式可表示的颜色上限
+constexpr float QuantizedMaxColor = 4.0f;
+
+//==========================================================================
+// 函数：GetCell
+// 描述：坐标所在的网格单元（测试只使用视口内的坐标）
+//==========================================================================
+int GetCell(float coordinate, float cellsPerUnit) {
+    return static_cast<int>(std::floor((coordinate + 1.0f) * cellsPerUnit));
+}
+
+//==========================================================================
+// 函数：GetColorSum
+// 描述：帧内各颜色通道的总和（double 累加）
+//==========================================================================
+double GetColorSum(const LaserFrame& frame) {
+    double sum = 0.0;
+    const FrameView view = frame.View();
+    for (size_t i = 0; i < view.Count; ++i) {
+        sum += static_cast<double>(view.R[i]) + view.G[i] + view.B[i];
+    }
+    return sum;
+}
+
+//==========================================================================
+// 函数：MakeDenseFrame
+// 描述：生成在少数像素内游走的帧（大量点落入同一单元），约 1/8 为光束点
+//==========================================================================
+LaserFrame MakeDenseFrame(std::mt19937& rng, size_t count, float maxInput) {
+    std::uniform_real_distribution<float> step(-0.004f, 0.004f);
+    std::uniform_real_distribution<float> color(0.0f, maxInput);
+    LaserFrame frame;
+    float x = 0.1f;
+    float y = -0.2f;
+    for (size_t i = 0; i < count; ++i) {
+        x = (std::min)(0.9f, (std::max)(-0.9f, x + step(rng)));
+        y = (std::min)(0.9f, (std::max)(-0.9f, y + step(rng)));
+        LaserPoint point(x, y, color(rng), color(rng), color(rng));
+        point.Focus = color(rng);
+        if (rng() % 8 == 0) {
+            point.Z = 0.5f;
+        }
+        frame.Append(point);
+    }
+    return frame;
+}
+
+//==========================================================================
+// 函数：CheckMergedStructure
+// 描述：按输出顺序回放输入：每个输出点从对应输入点开始，按实现的累加顺序加上后续输入点的颜色，
+//       直到与输出颜色逐位相同；被合并的点必须与首点同单元且两者都不是光束点
+//==========================================================================
+void CheckMergedStructure(const LaserFrame& input, const LaserFrame& output, float cellsPerUnit, float maxColor) {
+    const FrameView in = input.View();
+    const FrameView out = output.View();
+    size_t i = 0;
+    for (size_t o = 0; o < out.Count; ++o) {
+        if (i >= in.Count) {
+            BEYONDLINK_CHECK(false, "output has more points than the input accounts for");
+            return;
+        }
+        const bool samePoint = out.X[o] == in.X[i] && out.Y[o] == in.Y[i] && out.Z[o] == in.Z[i] &&
+                               out.Focus[o] == in.Focus[i];
+        BEYONDLINK_CHECK(samePoint, "output point " << o << " must keep the position, Z and focus of input " << i);
+        
+        float r = in.R[i];
+        float g = in.G[i];
+        float b = in.B[i];
+        const size_t first = i++;
+        while (!(r == out.R[o] && g == out.G[o] && b == out.B[o]) && i < in.Count) {
+            BEYONDLINK_CHECK(in.Z[first] == 0.0f && in.Z[i] == 0.0f,
+                             "beam point merged at input " << (in.Z[first] != 0.0f ? first : i));
+            BEYONDLINK_CHECK(GetCell(in.X[i], cellsPerUnit) == GetCell(in.X[first], cellsPerUnit) &&
+                             GetCell(in.Y[i], cellsPerUnit) == GetCell(in.Y[first], cellsPerUnit),
+                             "input " << i << " merged across a cell boundary");
+            r += in.R[i];
+            g += in.G[i];
+            b += in.B[i];
+            ++i;
+        }
+        BEYONDLINK_CHECK(r == out.R[o] && g == out.G[o] && b == out.B[o],
+                         "output " << o << " colour is not a run sum of the input");
+        if (i - first > 1) {
+            BEYONDLINK_CHECK(out.R[o] <= maxColor && out.G[o] <= maxColor && out.B[o] <= maxColor,
+                             "merged colour exceeds the cap " << maxColor);
+        }
+    }
+    BEYONDLINK_CHECK(i == in.Count, "input points " << i << ".." << in.Count << " dropped");
+}
+
+} // namespace
+
+int main() {
+    int cases = 0;
+    const float cellsPerUnit = 512.0f;   // 1024 像素纹理，单元 = 1 像素
+    const float pixel = 1.0f / cellsPerUnit;
+    
+    // 同一像素内的连续点合并为一个：位置取首点，颜色累加（可精确表示的值，逐位比较）
+    {
+        LaserFrame frame;
+        frame.Append(LaserPoint(0.0f + 0.1f * pixel, 0.0f, 0.25f, 0.5f, 0.125f));
+        frame.Append(LaserPoint(0.0f + 0.5f * pixel, 0.2f * pixel, 0.25f, 0.25f, 0.125f));
+        frame.Append(LaserPoint(0.0f + 0.9f * pixel, 0.9f * pixel, 0.5f, 0.25f, 0.25f));
+        frame.Append(LaserPoint(0.0f + 1.1f * pixel, 0.0f, 1.0f, 1.0f, 1.0f));
+        const size_t merged = ScannerPipeline::MergePixelRuns(frame, cellsPerUnit, QuantizedMaxColor);
+        ++cases;
+        BEYONDLINK_CHECK(merged == 2 && frame.Size() == 2, "expected one run of 3 and a single point, merged " << merged);
+        if (frame.Size() == 2) {
+            const LaserPoint first = frame.GetPoint(0);
+            BEYONDLINK_CHECK(first.X == 0.1f * pixel && first.Y == 0.0f, "merged point must keep the first position");
+            BEYONDLINK_CHECK(first.R == 1.0f && first.G == 1.0f && first.B == 0.5f, "merged colour must be the sum");
+        }
+    }
+    
+    // 光束点（Z ≠ 0）从不合并：同一像素内的光束点、光束点后的普通点都保留
+    {
+        LaserFrame frame;
+        LaserPoint beam(0.5f, 0.5f, 1.0f, 1.0f, 1.0f);
+        beam.Z = 1.0f;
+        frame.Append(beam);
+        frame.Append(beam);
+        frame.Append(LaserPoint(0.5f, 0.5f, 0.5f, 0.5f, 0.5f));
+        frame.Append(LaserPoint(0.5f, 0.5f, 0.5f, 0.5f, 0.5f));
+        frame.Append(beam);
+        const size_t merged = ScannerPipeline::MergePixelRuns(frame, cellsPerUnit, QuantizedMaxColor);
+        ++cases;
+        BEYONDLINK_CHECK(merged == 1 && frame.Size() == 4, "only the two plain points may merge, merged " << merged);
+        if (frame.Size() == 4) {
+            BEYONDLINK_CHECK(frame.GetPoint(0).Z == 1.0f && frame.GetPoint(1).Z == 1.0f && frame.GetPoint(3).Z == 1.0f,
+                             "beam points must stay in place");
+            BEYONDLINK_CHECK(frame.GetPoint(2).R == 1.0f && frame.GetPoint(2).Z == 0.0f,
+                             "plain points after a beam must merge only with each other");
+        }
+    }
+    
+    // 颜色上限：6 个颜色为 1 的点在上限 4 下分为 4 + 2，总和不变
+    {
+        LaserFrame frame;
+        for (int i = 0; i < 6; ++i) {
+            frame.Append(LaserPoint(-0.25f, 0.75f, 1.0f, 0.5f, 0.0f));
+        }
+        const size_t merged = ScannerPipeline::MergePixelRuns(frame, cellsPerUnit, QuantizedMaxColor);
+        ++cases;
+        BEYONDLINK_CHECK(merged == 4 && frame.Size() == 2, "expected runs of 4 and 2, merged " << merged);
+        if (frame.Size() == 2) {
+            BEYONDLINK_CHECK(frame.GetPoint(0).R == 4.0f && frame.GetPoint(1).R == 2.0f,
+                             "cap must split the run at 4");
+        }
+    }
+    
+    // 单元边界与像素边界对齐：恰在边界上的点属于右侧单元，不与左侧紧邻的点合并
+    {
+        LaserFrame frame;
+        const float edge = -1.0f + 300.0f * pixel;
+        frame.Append(LaserPoint(edge - 0.05f * pixel, 0.0f, 0.5f, 0.5f, 0.5f));
+        frame.Append(LaserPoint(edge, 0.0f, 0.5f, 0.5f, 0.5f));
+        frame.Append(LaserPoint(edge + 0.5f * pixel, 0.0f, 0.5f, 0.5f, 0.5f));
+        const size_t merged = ScannerPipeline::MergePixelRuns(frame, cellsPerUnit, QuantizedMaxColor);
+        ++cases;
+        BEYONDLINK_CHECK(merged == 1 && frame.Size() == 2, "points across a pixel edge must not merge, merged " << merged);
+    }
+    
+    // 随机密集帧：颜色总和不变、光束点原样保留、输出结构为同单元连续输入的累加、合并颜色不超过上限
+    std::mt19937 rng(5);
+    for (int trial = 0; trial < 200; ++trial) {
+        const float maxInput = trial % 2 == 0 ? 1.0f : 2.5f;
+        const float maxColor = trial % 3 == 0 ? std::numeric_limits<float>::max() : QuantizedMaxColor;
+        const LaserFrame input = MakeDenseFrame(rng, 50 + static_cast<size_t>(trial) * 20, maxInput);
+        LaserFrame output;
+        output.AssignFrom(input);
+        const size_t merged = ScannerPipeline::MergePixelRuns(output, cellsPerUnit, maxColor);
+        ++cases;
+        
+        BEYONDLINK_CHECK(merged == input.Size() - output.Size(), "returned merge count must match the size change");
+        const double inputSum = GetColorSum(input);
+        BEYONDLINK_CHECK(std::abs(GetColorSum(output) - inputSum) <= 1e-5 * inputSum,
+                         "additive colour sum changed: " << GetColorSum(output) << " != " << inputSum);
+        
+        size_t inputBeams = 0;
+        size_t outputBeams = 0;
+        for (size_t i = 0; i < input.Size(); ++i) {
+            inputBeams += input.GetPoint(i).Z != 0.0f ? 1 : 0;
+        }
+        for (size_t i = 0; i < output.Size(); ++i) {
+            outputBeams += output.GetPoint(i).Z != 0.0f ? 1 : 0;
+        }
+        BEYONDLINK_CHECK(inputBeams == outputBeams, "beam point count changed: " << outputBeams << " != " << inputBeams);
+        CheckMergedStructure(input, output, cellsPerUnit, maxColor);
+    }
+    
+    return FinishTests("PixelRunMergeTests", cases);
+}
@@ -0,0 +1,379 @@
+﻿//==============================================================================
+// BeyondLink - Beyond激光可视化系统
+// 文件：ReferencePipeline.cpp
+// 作者：Yunsio
+// 日期：2025-10-06
+// 描述：扫描仪模拟的逐步物化参考实现
+//==============================================================================
+
+#include "ReferencePipeline.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace BeyondLink {
+namespace Tests {
+
+using namespace Core;
+
+namespace {
+
+//==========================================================================
+// 函数：IsSamePosition
+// 描述：判断两个位置是否相同（与 LaserPoint::IsSamePosition 的默认误差一致）
+//==========================================================================
+inline bool IsSamePosition(float x0, float y0, float x1, float y1) {
+    return std::abs(x0 - x1) < 0.0001f && std::abs(y0 - y1) < 0.0001f;
+}
+
+//==========================================================================
+// 函数：IsBlank
+// 描述：判断颜色是否为空白（与 LaserPoint::IsBlankPoint 一致）
+//==========================================================================
+inline bool IsBlank(float r, float g, float b) {
+    return r <= 0.0001f && g <= 0.0001f && b <= 0.0001f;
+}
+
+//==========================================================================
+// 函数：SmoothVector
+// 描述：对速度向量进行平滑处理（指数移动平均）
+// 参数：
+//   currentX, currentY - [输入/输出] 当前速度
+//   targetX, targetY - 目标速度
+//   smoothing - 平滑系数 (0-1)
+//==========================================================================
+inline void SmoothVector(float& currentX, float& currentY, float targetX, float targetY, float smoothing) {
+    currentX += (targetX - currentX) * (1.0f - smoothing);
+    currentY += (targetY - currentY) * (1.0f - smoothing);
+}
+
+//==========================================================================
+// 函数：ApplyGalvoResponse
+// 描述：振镜模型的直接递推：初始状态静止于第一个样本，位置输出先于本样本的输入更新
+//==========================================================================
+void ApplyGalvoResponse(MutableFrameView result, const ScannerPipelineParams& params) {
+    const GalvoResponse& galvo = params.Galvo;
+    const double* phi = galvo.Transition;
+    const float edgeFade = (std::max)(0.1f, params.EdgeFade);
+    const float inverseStep = 1.0f / (100.0f / params.SampleCount * 0.01f);
+    double stateX[2] = { result.X[0], 0.0 };
+    double stateY[2] = { result.Y[0], 0.0 };
+    float previousX = result.X[0];
+    float previousY = result.Y[0];
+    for (size_t i = 0; i < result.Count; ++i) {
+        const double targetX = result.X[i];
+        const double targetY = result.Y[i];
+        const float pathX = static_cast<float>(stateX[0]);
+        const float pathY = static_cast<float>(stateY[0]);
+        const float velX = (pathX - previousX) * inverseStep;
+        const float velY = (pathY - previousY) * inverseStep;
+        previousX = pathX;
+        previousY = pathY;
+        
+        const double nextX[2] = { phi[0] * stateX[0] + phi[1] * stateX[1] + galvo.Input[0] * targetX,
+                                  phi[2] * stateX[0] + phi[3] * stateX[1] + galvo.Input[1] * targetX };
+        const double nextY[2] = { phi[0] * stateY[0] + phi[1] * stateY[1] + galvo.Input[0] * targetY,
+                                  phi[2] * stateY[0] + phi[3] * stateY[1] + galvo.Input[1] * targetY };
+        std::memcpy(stateX, nextX, sizeof(stateX));
+        std::memcpy(stateY, nextY, sizeof(stateY));
+        
+        // 边缘淡化：静止时取强度上限
+        const float velLength = std::sqrt(velX * velX + velY * velY);
+        float intensity = velLength > 0.0f ? (std::min)(4.0f, 1.0f / velLength * 0.2f * edgeFade * 2.0f) : 4.0f;
+        intensity = (std::min)(4.0f, intensity) / (std::max)(1.0, edgeFade * 2.0 * 4.0);
+        float fadePercent = (std::max)(0.0, edgeFade - 0.5) * 2.0;
+        intensity = intensity * (1.0f - fadePercent) + fadePercent;
+        
+        result.X[i] = pathX;
+        result.Y[i] = pathY;
+        if (result.Z[i] == 0.0f) {
+            result.R[i] *= intensity;
+            result.G[i] *= intensity;
+            result.B[i] *= intensity;
+        }
+    }
+}
+
+} // namespace
+
+//==========================================================================
+// 函数：InterpolatePoints
+// 描述：在相邻点之间进行插值，增加点密度
+//==========================================================================
+void InterpolatePoints(const FrameView& points, int sampleCount,
+                       LaserSettings::InterpolationMode interpolation, LaserFrame& result) {
+    const FrameView& in = points;
+    if (in.Count < 2 || sampleCount <= 1) {
+        result.Resize(in.Count);
+        MutableFrameView copy = result.MutableView();
+        for (size_t i = 0; i < in.Count; ++i) {
+            copy.SetPoint(i, in.GetPoint(i));
+        }
+        return;
+    }
+    
+    const size_t segmentCount = in.Count - 1;
+    result.Resize(segmentCount * sampleCount);
+    MutableFrameView out = result.MutableView();
+    
+    size_t index = 0;
+    for (size_t i = 0; i < segmentCount; ++i) {
+        const float z0 = in.Z[i];
+        
+        for (int s = 0; s < sampleCount; ++s, ++index) {
+            float t = static_cast<float>(s) / static_cast<float>(sampleCount - 1);
+            
+            ScannerPipeline::GetSamplePosition(in, i, interpolation, t, out.X[index], out.Y[index]);
+            out.R[index] = in.R[i] + (in.R[i + 1] - in.R[i]) * t;
+            out.G[index] = in.G[i] + (in.G[i + 1] - in.G[i]) * t;
+            out.B[index] = in.B[i] + (in.B[i + 1] - in.B[i]) * t;
+            out.Z[index] = (z0 > 0.0f) ? (z0 + (in.Z[i + 1] - z0) * t) : 0.0f;
+            out.Focus[index] = in.Focus[i] + (in.Focus[i + 1] - in.Focus[i]) * t;
+        }
+    }
+}
+
+//==========================================================================
+// 函数：InterpolateAdaptive
+// 描述：按段长确定等分数的插值（段长按 double 计算）
+//==========================================================================
+void InterpolateAdaptive(const FrameView& points, const ScannerPipelineParams& params,
+                         const size_t* spans, LaserFrame& result, std::vector<AdaptiveSample>& origins) {
+    const FrameView& in = points;
+    int maxSamples = params.SampleCount;
+    int minSamples = params.SampleCount;
+    float spacing = 0.0f;
+    if (params.AdaptiveSampling) {
+        maxSamples = (std::max)(1, params.AdaptiveMaxSamples);
+        minSamples = (std::min)((std::max)(1, params.AdaptiveMinSamples), maxSamples);
+        spacing = params.AdaptiveSpacing;
+    }
+    const size_t segmentCount = in.Count - 1;
+    result.Clear();
+    origins.clear();
+    
+    for (size_t i = 0; i < segmentCount; ++i) {
+        const int span = spans ? static_cast<int>(spans[i]) : 1;
+        int divisions = maxSamples * span;
+        if (spacing > 0.0f) {
+            const double dx = static_cast<double>(in.X[i + 1]) - in.X[i];
+            const double dy = static_cast<double>(in.Y[i + 1]) - in.Y[i];
+            const double ratio = std::ceil(std::sqrt(dx * dx + dy * dy) / spacing);
+            if (ratio < static_cast<double>(maxSamples * span)) {
+                divisions = (std::max)(minSamples * span, static_cast<int>(ratio));
+            }
+        }
+        const float weight = static_cast<float>(static_cast<double>(params.SampleCount * span) / divisions);
+        const float z0 = in.Z[i];
+        const int samples = (i + 1 == segmentCount) ? divisions + 1 : divisions;
+        
+        for (int s = 0; s < samples; ++s) {
+            const float t = static_cast<float>(s) / static_cast<float>(divisions);
+            LaserPoint point;
+            ScannerPipeline::GetSamplePosition(in, i, params.Interpolation, t, point.X, point.Y);
+            point.R = in.R[i] + (in.R[i + 1] - in.R[i]) * t;
+            point.G = in.G[i] + (in.G[i + 1] - in.G[i]) * t;
+            point.B = in.B[i] + (in.B[i + 1] - in.B[i]) * t;
+            point.Z = (z0 > 0.0f) ? (z0 + (in.Z[i + 1] - z0) * t) : 0.0f;
+            point.Focus = in.Focus[i] + (in.Focus[i + 1] - in.Focus[i]) * t;
+            if (point.Z == 0.0f) {
+                point.R *= weight;
+                point.G *= weight;
+                point.B *= weight;
+            }
+            result.Append(point);
+            origins.push_back(AdaptiveSample{ i, divisions, span });
+        }
+    }
+}
+
+//==========================================================================
+// 函数：ApplyScannerSimulation
+// 描述：应用扫描仪模拟效果（速度平滑、边缘淡化）
+//       位置递推只读写 X/Y 通道，颜色通道仅在非光束点时按强度缩放
+//==========================================================================
+void ApplyScannerSimulation(LaserFrame& samples, const ScannerPipelineParams& params,
+                            const std::vector<AdaptiveSample>* origins) {
+    MutableFrameView result = samples.MutableView();
+    if (result.Count == 0) {
+        return;
+    }
+    if (!params.Galvo.Taps.empty()) {
+        ApplyGalvoResponse(result, params);
+        return;
+    }
+    
+    const float smoothing = params.VelocitySmoothing;
+    const float edgeFade = (std::max)(0.1f, params.EdgeFade);
+    
+    float currentVelX = 0.0f;
+    float currentVelY = 0.0f;
+    float currentPosX = result.X[0];
+    float currentPosY = result.Y[0];
+    
+    for (size_t i = 0; i < result.Count; ++i) {
+        // 计算到目标点的向量
+        float targetVelX = result.X[i] - currentPosX;
+        float targetVelY = result.Y[i] - currentPosY;
+        float distance = std::sqrt(targetVelX * targetVelX + targetVelY * targetVelY);
+        
+        float intensity = 1.0f;
+        
+        if (distance > 0.0f) {
+            // 更新位置
+            float stepSize = 100.0f / params.SampleCount * 0.01f;
+            
+            // 自适应插值：按段时长换算平滑系数和步长（等分数等于 S·k 时与固定模式相同）
+            const int divisions = origins ? (*origins)[i].Divisions : params.SampleCount;
+            const int nominal = origins ? params.SampleCount * (*origins)[i].Span : params.SampleCount;
+            if (divisions != nominal && smoothing >= 0.0f) {
+                const double timeScale = static_cast<double>(nominal) / divisions;
+                const float alpha = static_cast<float>(1.0 - std::pow(static_cast<double>(smoothing), timeScale));
+                currentVelX += (targetVelX - currentVelX) * alpha;
+                currentVelY += (targetVelY - currentVelY) * alpha;
+                stepSize = static_cast<float>(stepSize * timeScale);
+            } else {
+                // 平滑速度向量
+                SmoothVector(currentVelX, currentVelY, targetVelX, targetVelY, smoothing);
+            }
+            currentPosX += currentVelX * stepSize;
+            currentPosY += currentVelY * stepSize;
+            
+            // 计算边缘淡化强度
+            float velLength = std::sqrt(currentVelX * currentVelX + currentVelY * currentVelY);
+            intensity = (std::min)(4.0f, 1.0f / velLength * 0.2f * edgeFade * 2.0f);
+            intensity = (std::min)(4.0f, intensity) / (std::max)(1.0, edgeFade * 2.0 * 4.0);
+            
+            // 插值淡化效果
+            float fadePercent = (std::max)(0.0, edgeFade - 0.5) * 2.0;
+            intensity = intensity * (1.0f - fadePercent) + fadePercent;
+        }
+        
+        result.X[i] = currentPosX;
+        result.Y[i] = currentPosY;
+        
+        // 光束点（Z > 0）不应用淡化
+        if (result.Z[i] == 0.0f) {
+            result.R[i] *= intensity;
+            result.G[i] *= intensity;
+            result.B[i] *= intensity;
+        }
+    }
+}
+
+//==========================================================================
+// 函数：DownsamplePoints
+// 描述：降采样点数据，每隔 factor 个点取一个
+//==========================================================================
+void DownsamplePoints(const FrameView& points, int factor, LaserFrame& result) {
+    const size_t stride = static_cast<size_t>((std::max)(1, factor));
+    const size_t newSize = (points.Count + stride - 1) / stride;
+    result.Resize(newSize);
+    
+    MutableFrameView out = result.MutableView();
+    for (size_t i = 0, src = 0; i < newSize; ++i, src += stride) {
+        out.SetPoint(i, points.GetPoint(src));
+    }
+}
+
+//==========================================================================
+// 函数：CullBlankSamples
+// 描述：剔除消隐段：样本序号 × 降采样倍数 / 每段样本数 为所在的原始段
+//==========================================================================
+void CullBlankSamples(const FrameView& raw, int sampleCount, int factor,
+                      const std::vector<AdaptiveSample>* origins, LaserFrame& samples) {
+    const size_t samplesPerSegment = static_cast<size_t>((std::max)(1, sampleCount));
+    const size_t stride = static_cast<size_t>((std::max)(1, factor));
+    MutableFrameView view = samples.MutableView();
+    size_t kept = 0;
+    for (size_t j = 0; j < view.Count; ++j) {
+        const size_t segment = origins ? (*origins)[j * stride].Segment : j * stride / samplesPerSegment;
+        const size_t next = sampleCount > 1 ? segment + 1 : segment;
+        if (IsBlank(raw.R[segment], raw.G[segment], raw.B[segment]) &&
+            IsBlank(raw.R[next], raw.G[next], raw.B[next])) {
+            continue;
+        }
+        view.SetPoint(kept++, view.GetPoint(j));
+    }
+    samples.Resize(kept);
+}
+
+//==========================================================================
+// 函数：RemoveDuplicatePoints
+// 描述：原地移除连续重复位置的点（写入位置不超过读取位置）
+//==========================================================================
+void RemoveDuplicatePoints(LaserFrame& points) {
+    if (points.Empty()) {
+        return;
+    }
+    
+    MutableFrameView view = points.MutableView();
+    size_t kept = 1;
+    
+    for (size_t i = 1; i < view.Count; ++i) {
+        if (!IsSamePosition(view.X[i], view.Y[i], view.X[kept - 1], view.Y[kept - 1])) {
+            if (kept != i) {
+                view.SetPoint(kept, view.GetPoint(i));
+            }
+            kept++;
+        }
+    }
+    
+    points.Resize(kept);
+}
+
+//==========================================================================
+// 函数：RunReferencePipeline
+// 描述：逐步处理：简化 → 插值 → 模拟 → 降采样 → 剔除 → 去重 → LOD 合并
+//==========================================================================
+void RunReferencePipeline(const LaserFrame& raw, const ScannerPipelineParams& params,
+                          LaserFrame& processed, LaserFrame& beam) {
+    // 输入简化：参考路径处理简化后的原始点，合并段按代表的原始段数自适应插值
+    const bool simplify = params.SimplifyTolerance > 0.0f && params.SampleCount > 1;
+    const LaserFrame* input = &raw;
+    LaserFrame simplified;
+    std::vector<size_t> spans;
+    if (params.ScannerSimulation && simplify && raw.Size() > 2) {
+        simplified.Resize(raw.Size());
+        spans.resize(raw.Size());
+        simplified.Resize(ScannerPipeline::SimplifyPoints(raw.View(), params.SimplifyTolerance,
+                                                          simplified.MutableView(), nullptr, spans.data()));
+        input = &simplified;
+    }
+    const FrameView in = input->View();
+    const bool simulate = params.ScannerSimulation && in.Count > 1;
+    
+    if (simulate) {
+        LaserFrame samples;
+        std::vector<AdaptiveSample> origins;
+        const bool adaptive = (params.AdaptiveSampling || simplify) && params.SampleCount > 1;
+        if (adaptive) {
+            InterpolateAdaptive(in, params, spans.empty() ? nullptr : spans.data(), samples, origins);
+        } else {
+            InterpolatePoints(in, params.SampleCount, params.Interpolation, samples);
+        }
+        ApplyScannerSimulation(samples, params, adaptive ? &origins : nullptr);
+        DownsamplePoints(samples.View(), params.ProcessedFactor, processed);
+        DownsamplePoints(samples.View(), params.BeamFactor, beam);
+        if (params.CullBlankSegments) {
+            CullBlankSamples(in, params.SampleCount, params.ProcessedFactor, adaptive ? &origins : nullptr, processed);
+            CullBlankSamples(in, params.SampleCount, params.BeamFactor, adaptive ? &origins : nullptr, beam);
+        }
+    } else {
+        processed.AssignFrom(*input);
+        beam.AssignFrom(*input);
+    }
+    
+    if (params.BeamBrush) {
+        RemoveDuplicatePoints(processed);
+    }
+    if (!params.BeamOutput) {
+        beam.Clear();
+    }
+    if (simulate && params.LodCellsPerUnit > 0.0f) {
+        ScannerPipeline::MergePixelRuns(processed, params.LodCellsPerUnit, params.LodMaxColor);
+    }
+}
+
+} // namespace Tests
+} // namespace BeyondLink
@@ -0,0 +1,120 @@
+﻿//==============================================================================
+// BeyondLink - Beyond激光可视化系统
+// 文件：ReferencePipeline.h
+// 作者：Yunsio
+// 日期：2025-10-06
+// 描述：扫描仪模拟的逐步物化参考实现（插值 → 模拟 → 降采样 → 剔除 → 去重）
+//       每一步输出完整的中间帧，运算顺序与 ScannerPipeline 的融合处理一致，
+//       供测试程序逐位或按容差校验各特化处理实例
+//==============================================================================
+
+#pragma once
+
+#include "LaserFrame.h"
+#include "LaserSettings.h"
+#include "ScannerPipeline.h"
+#include <vector>
+
+namespace BeyondLink {
+namespace Tests {
+
+//==========================================================================
+// 结构体：AdaptiveSample
+// 描述：自适应插值样本的来源（所在原始段、该段的等分数 d 和代表的原始段数 k）
+//==========================================================================
+struct AdaptiveSample {
+    size_t Segment = 0;
+    int Divisions = 1;
+    int Span = 1;
+};
+
+//==========================================================================
+// 函数：InterpolatePoints
+// 描述：在相邻点之间插值，每段输出 sampleCount 个样本（t = s / (sampleCount - 1)）
+//       位置按插值方式计算（见 ScannerPipeline::GetSamplePosition），其余通道线性插值
+// 参数：
+//   points - 原始点
+//   sampleCount - 每段样本数（<= 1 或不足 2 个点时复制原始点）
+//   interpolation - 样本位置的插值方式
+//   result - [输出] 插值后的点
+//==========================================================================
+void InterpolatePoints(const Core::FrameView& points, int sampleCount,
+                       Core::LaserSettings::InterpolationMode interpolation, Core::LaserFrame& result);
+
+//==========================================================================
+// 函数：InterpolateAdaptive
+// 描述：自适应插值：每段等分数 d = clamp(ceil(段长 / 间距), 最少 × k, 最多 × k)（间距 <= 0 时取最多 × k），
+//       k 为该段代表的原始段数，未开启 AdaptiveSampling 时最少 = 最多 = S；
+//       段内取 t = s / d（s < d，帧末段包含 s = d 的终点）；
+//       淡化样本（非光束段或 Z = 0）的颜色 × S·k/d，S 为 SampleCount
+// 参数：
+//   points - 原始点（至少 2 个点）
+//   params - 处理参数（使用 SampleCount、Interpolation、AdaptiveSampling 和 Adaptive* 字段）
+//   spans - 各段代表的原始段数（为空时均为 1）
+//   result - [输出] 插值后的点
+//   origins - [输出] 各样本的来源
+//==========================================================================
+void InterpolateAdaptive(const Core::FrameView& points, const Core::ScannerPipelineParams& params,
+                         const size_t* spans, Core::LaserFrame& result, std::vector<AdaptiveSample>& origins);
+
+//==========================================================================
+// 函数：ApplyScannerSimulation
+// 描述：原地应用扫描仪模拟：速度平滑递推和边缘淡化
+//       振镜模型时逐样本推进双精度状态的二阶递推 s[n+1] = Φ·s[n] + Γ·u[n]
+//       （处理实例为 FIR 卷积），速度取相邻输出位移 / 步长
+// 参数：
+//       自适应插值的样本按所在段的时长换算递推参数：α' = 1 - 平滑因子^(S·k/d)，步长 × S·k/d
+// 参数：
+//   samples - [输入/输出] 插值后的样本（至少 1 个）
+//   params - 处理参数（使用 SampleCount、VelocitySmoothing、EdgeFade、Galvo）
+//   origins - 自适应插值样本的来源（为空时按固定样本数处理；不与振镜模型组合）
+//==========================================================================
+void ApplyScannerSimulation(Core::LaserFrame& samples, const Core::ScannerPipelineParams& params,
+                            const std::vector<AdaptiveSample>* origins = nullptr);
+
+//==========================================================================
+// 函数：DownsamplePoints
+// 描述：降采样，每隔 factor 个点取一个
+// 参数：
+//   points - 输入点
+//   factor - 降采样倍数（<= 1 时完整复制）
+//   result - [输出] 降采样后的点
+//==========================================================================
+void DownsamplePoints(const Core::FrameView& points, int factor, Core::LaserFrame& result);
+
+//==========================================================================
+// 函数：CullBlankSamples
+// 描述：去掉取样位置落在两端点均为空白的原始段内的样本
+// 参数：
+//   raw - 插值使用的原始点
+//   sampleCount - 每段样本数
+//   factor - samples 的降采样倍数
+//   origins - 自适应插值样本的来源（为空时按固定样本数换算所在段）
+//   samples - [输入/输出] 降采样后的样本
+//==========================================================================
+void CullBlankSamples(const Core::FrameView& raw, int sampleCount, int factor,
+                      const std::vector<AdaptiveSample>* origins, Core::LaserFrame& samples);
+
+//==========================================================================
+// 函数：RemoveDuplicatePoints
+// 描述：原地移除连续重复位置的点（光束画刷）
+// 参数：
+//   points - [输入/输出] 点列表
+//==========================================================================
+void RemoveDuplicatePoints(Core::LaserFrame& points);
+
+//==========================================================================
+// 函数：RunReferencePipeline
+// 描述：按参数逐步处理原始帧，得到处理实例应输出的主点和光束点列表
+//       包含输入简化、自适应插值、消隐段剔除、光束画刷去重和 LOD 合并
+// 参数：
+//   raw - 原始点
+//   params - 处理参数（忽略 Pool、VectorizedShading、Arena 和 Stats）
+//   processed - [输出] 主点列表
+//   beam - [输出] 光束点列表（BeamOutput 关闭时为空）
+//==========================================================================
+void RunReferencePipeline(const Core::LaserFrame& raw, const Core::ScannerPipelineParams& params,
+                          Core::LaserFrame& processed, Core::LaserFrame& beam);
+
+} // namespace Tests
+} // namespace BeyondLink
@@ -0,0 +1,140 @@
+﻿//==============================================================================
+// BeyondLink - Beyond激光可视化系统
+// 文件：ScannerPipelineTests.cpp
+// 作者：Yunsio
+// 日期：2025-10-06
+// 描述：融合处理实例与逐步物化参考路径的对照测试
+//       遍历质量等级、每段样本数、插值方式、光束画刷、光束输出、消隐剔除、
+//       LOD 合并和输入简化的组合，分别以单线程、分块并行扫描、向量化着色和振镜模型运行，
+//       单线程要求逐位一致，其余模式按浮点误差容差比较
+//==============================================================================
+
+#include "ReferencePipeline.h"
+#include "TestCommon.h"
+#include "WorkerPool.h"
+
+using namespace BeyondLink::Core;
+using namespace BeyondLink::Tests;
+
+namespace {
+
+//==========================================================================
+// 枚举：RunMode
+// 描述：处理实例的运行方式
+//==========================================================================
+enum class RunMode {
+    Serial,       // 单线程逐样本着色：与参考路径逐位一致
+    Pool,         // 分块并行扫描：块起点误差，1e-4 容差
+    Vectorized,   // SIMD 着色：rsqrt 近似，1e-4 容差
+    Galvo         // 振镜模型：FIR 卷积对直接递推，截断误差容差
+};
+
+const char* const RunModeNames[] = { "serial", "pool", "vectorized", "galvo" };
+
+//==========================================================================
+// 函数：RunCase
+// 描述：用同一原始帧分别运行处理实例和参考路径并比较输出
+//==========================================================================
+void RunCase(const LaserFrame& raw, const ScannerPipelineParams& params, RunMode mode) {
+    LaserFrame processed;
+    LaserFrame beam;
+    LaserFrame expectedProcessed;
+    LaserFrame expectedBeam;
+    ScannerPipeline::Select(params)(raw.View(), params, processed, beam);
+    RunReferencePipeline(raw, params, expectedProcessed, expectedBeam);
+    
+    // 振镜模型：位置差来自脉冲响应截断（按 TailMass 放宽），颜色经速度（位移 / 步长）放大
+    float tolerance = 0.0f;
+    float colorTolerance = 0.0f;
+    if (mode == RunMode::Galvo) {
+        tolerance = static_cast<float>(1e-4 + 3.0 * params.Galvo.TailMass);
+        colorTolerance = 1e-2f;
+    } else if (mode != RunMode::Serial) {
+        tolerance = 1e-4f;
+        colorTolerance = 1e-4f;
+    }
+    
+    const bool sameProcessed = CompareFrames(processed, expectedProcessed, tolerance, colorTolerance);
+    const bool sameBeam = CompareFrames(beam, expectedBeam, tolerance, colorTolerance);
+    BEYONDLINK_CHECK(sameProcessed && sameBeam,
+                     ScannerPipeline::GetVariantName(params) << " (" << RunModeNames[static_cast<int>(mode)]
+                     << ", " << raw.Size() << " raw points, processed " << processed.Size() << "/"
+                     << expectedProcessed.Size() << ", beam " << beam.Size() << "/" << expectedBeam.Size() << ")");
+}
+
+} // namespace
+
+int main() {
+    const LaserSettings::QualityLevel qualities[] = {
+        LaserSettings::QualityLevel::Low, LaserSettings::QualityLevel::Medium,
+        LaserSettings::QualityLevel::High, LaserSettings::QualityLevel::Ultra
+    };
+    const LaserSettings::InterpolationMode interpolations[] = {
+        LaserSettings::InterpolationMode::Linear, LaserSettings::InterpolationMode::CatmullRom,
+        LaserSettings::InterpolationMode::Hermite
+    };
+    const int sampleCounts[] = { 1, 2, 3, 5, 8, 12 };
+    const size_t frameSizes[] = { 1, 2, 3, 17, 160 };
+    
+    WorkerPool pool(3);
+    std::mt19937 rng(42);
+    std::vector<LaserFrame> frames;
+    for (size_t size : frameSizes) {
+        frames.push_back(MakeRandomFrame(rng, size));
+    }
+    
+    int cases = 0;
+    for (LaserSettings::QualityLevel quality : qualities) {
+        for (int sampleCount : sampleCounts) {
+            for (int mode = 0; mode < 4; ++mode) {
+                const RunMode runMode = static_cast<RunMode>(mode);
+                LaserSettings settings;
+                settings.LaserQuality = quality;
+                settings.SampleCount = sampleCount;
+                settings.EdgeFade = 0.15f * static_cast<float>(sampleCount % 7);
+                settings.VelocitySmoothing = 0.5f + 0.1f * static_cast<float>(sampleCount % 5);
+                if (runMode == RunMode::Galvo) {
+                    settings.ScannerResponse = LaserSettings::ScannerModel::Galvo;
+                }
+                
+                // 组合位：1 不模拟，2 光束画刷，4 不输出光束点，8 消隐剔除，
+                // 16/32 插值方式（3 = 线性 + 输入简化），64 LOD 合并
+                for (int flags = 0; flags < 128; ++flags) {
+                    const bool simulate = (flags & 1) == 0;
+                    const bool brush = (flags & 2) != 0;
+                    const bool lod = (flags & 64) != 0;
+                    // 不模拟时各运行方式相同；振镜模型的位置误差使光束画刷去重在阈值附近的判断可能不同；
+                    // 有误差时 LOD 单元边界附近的点可能落入不同单元，均只在逐位一致时比较
+                    if ((!simulate || lod) && runMode != RunMode::Serial) {
+                        continue;
+                    }
+                    if (brush && runMode == RunMode::Galvo) {
+                        continue;
+                    }
+                    ScannerPipelineParams params = ScannerPipelineParams::FromSettings(settings, simulate, brush);
+                    params.BeamOutput = (flags & 4) == 0;
+                    params.CullBlankSegments = (flags & 8) != 0;
+                    params.Interpolation = interpolations[((flags >> 4) & 3) % 3];
+                    if (((flags >> 4) & 3) == 3) {
+                        params.SimplifyTolerance = 0.05f;
+                    }
+                    if (lod) {
+                        params.LodCellsPerUnit = 40.0f;
+                        params.LodMaxColor = 4.0f;
+                    }
+                    if (runMode == RunMode::Pool) {
+                        params.Pool = &pool;
+                        params.ParallelMinSamples = 0;
+                    }
+                    params.VectorizedShading = runMode == RunMode::Vectorized;
+                    
+                    for (const LaserFrame& raw : frames) {
+                        RunCase(raw, params, runMode);
+                        ++cases;
+                    }
+                }
+            }
+        }
+    }
+    return FinishTests("ScannerPipelineTests", cases);
+}
@@ -0,0 +1,152 @@
+﻿//==============================================================================
+// BeyondLink - Beyond激光可视化系统
+// 文件：SimdShadingTests.cpp
+// 作者：Yunsio
+// 日期：2025-10-06
+// 描述：向量化边缘淡化着色测试
+//       SSE/AVX 实现对照标量实现和逐样本路径的 double 除法公式，
+//       覆盖边界速度：0、非规格化数、着色下限 1e-30 附近、强度上限 4 的钳制边界和负值（不着色），
+//       以及不是向量宽度整数倍的样本数（标量尾部）
+//==============================================================================
+
+#include "TestCommon.h"
+#include "ScannerPipeline.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace BeyondLink::Core;
+using namespace BeyondLink::Tests;
+
+namespace {
+
+// rsqrt + 一次牛顿迭代对照精确 1 / sqrt 的颜色相对误差上限
+constexpr float RelativeTolerance = 1e-6f;
+
+//==========================================================================
+// 函数：ShadePerSample
+// 描述：逐样本路径的边缘淡化强度（与 ScannerPipeline 的逐样本着色运算顺序相同，double 除法）
+//       速度平方是平方和，-0 与 +0 相同
+//==========================================================================
+float ShadePerSample(float speedSq, float edgeFade) {
+    const float fade = (std::max)(0.1f, edgeFade);
+    const float velLength = std::sqrt((std::max)(0.0f, speedSq));
+    float intensity = (std::min)(4.0f, 1.0f / velLength * 0.2f * fade * 2.0f);
+    intensity = (std::min)(4.0f, intensity) / (std::max)(1.0, fade * 2.0 * 4.0);
+    float fadePercent = (std::max)(0.0, fade - 0.5) * 2.0;
+    return intensity * (1.0f - fadePercent) + fadePercent;
+}
+
+//==========================================================================
+// 函数：MakeEdgeSpeeds
+// 描述：生成边界速度平方：强度上限钳制边界为 |v| = 0.4 × edgeFade / 4
+//==========================================================================
+std::vector<float> MakeEdgeSpeeds(float edgeFade) {
+    const float fade = (std::max)(0.1f, edgeFade);
+    const float clampSpeed = 0.2f * fade * 2.0f / 4.0f;
+    const float clampSpeedSq = clampSpeed * clampSpeed;
+    const float minSpeedSq = 1e-30f;
+    std::vector<float> speeds = {
+        0.0f, -0.0f,
+        std::numeric_limits<float>::denorm_min(), 1e-40f, std::numeric_limits<float>::min(),
+        std::nextafter(minSpeedSq, 0.0f), minSpeedSq, std::nextafter(minSpeedSq, 1.0f), 1e-20f,
+        std::nextafter(clampSpeedSq, 0.0f), clampSpeedSq, std::nextafter(clampSpeedSq, 1.0f),
+        clampSpeedSq * 0.999f, clampSpeedSq * 1.001f,
+        1e-6f, 0.01f, 1.0f, 25.0f, 1e6f, 1e30f,
+        -1.0f, -std::numeric_limits<float>::denorm_min()
+    };
+    // 钳制边界附近的密集取样
+    for (int i = -32; i <= 32; ++i) {
+        speeds.push_back(clampSpeedSq * (1.0f + static_cast<float>(i) * 1e-5f));
+    }
+    return speeds;
+}
+
+//==========================================================================
+// 函数：MakeSamples
+// 描述：生成颜色为 (1, 0.5, 0.25) 的样本，按 offset 轮换速度使各值落在向量的不同通道和标量尾部
+//==========================================================================
+LaserFrame MakeSamples(const std::vector<float>& speeds, size_t offset, size_t count, std::vector<float>& speedSq) {
+    LaserFrame samples;
+    speedSq.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        samples.Append(LaserPoint(0.0f, 0.0f, 1.0f, 0.5f, 0.25f));
+        speedSq[i] = speeds[(i + offset) % speeds.size()];
+    }
+    return samples;
+}
+
+//==========================================================================
+// 函数：IsClose
+// 描述：相对误差比较（两者都为 0 时相等）
+//==========================================================================
+bool IsClose(float actual, float expected) {
+    return std::abs(actual - expected) <= RelativeTolerance * std::abs(expected);
+}
+
+} // namespace
+
+int main() {
+    const float edgeFades[] = { 0.0f, 0.1f, 0.3f, 0.5f, 0.75f, 1.0f };
+    const ScannerPipeline::SimdLevel levels[] = { ScannerPipeline::SimdLevel::SSE, ScannerPipeline::SimdLevel::AVX,
+                                                  ScannerPipeline::SimdLevel::Auto };
+    const char* const levelNames[] = { "SSE", "AVX", "Auto" };
+    
+    int cases = 0;
+    for (float edgeFade : edgeFades) {
+        const std::vector<float> speeds = MakeEdgeSpeeds(edgeFade);
+        const float restIntensity = ShadePerSample(0.0f, edgeFade);
+        
+        for (size_t count : { size_t(1), size_t(3), size_t(7), size_t(8), size_t(13), size_t(31), speeds.size() }) {
+            for (size_t offset = 0; offset < 8; ++offset) {
+                std::vector<float> speedSq;
+                LaserFrame scalar = MakeSamples(speeds, offset, count, speedSq);
+                BEYONDLINK_CHECK(ScannerPipeline::ShadeSamples(scalar.MutableView(), speedSq.data(), edgeFade,
+                                                               ScannerPipeline::SimdLevel::Scalar),
+                                 "scalar shading must always be available");
+                ++cases;
+                
+                // 标量实现对照逐样本公式：负速度颜色不变，静止（含非规格化数）取强度上限
+                for (size_t i = 0; i < count; ++i) {
+                    const float speed = speedSq[i];
+                    const float expected = speed < 0.0f ? 1.0f : ShadePerSample(speed, edgeFade);
+                    BEYONDLINK_CHECK(IsClose(scalar.R()[i], expected),
+                                     "scalar vs per-sample, edgeFade " << edgeFade << ", speedSq " << speed
+                                     << ": " << scalar.R()[i] << " != " << expected);
+                    if (speed < 0.0f) {
+                        BEYONDLINK_CHECK(scalar.R()[i] == 1.0f && scalar.G()[i] == 0.5f && scalar.B()[i] == 0.25f,
+                                         "negative speed must leave colour untouched");
+                    } else if (speed < 1e-30f) {
+                        BEYONDLINK_CHECK(scalar.R()[i] == restIntensity,
+                                         "speedSq " << speed << " below the shading floor must clamp to the cap");
+                    }
+                }
+                
+                for (size_t l = 0; l < sizeof(levels) / sizeof(levels[0]); ++l) {
+                    if (!ScannerPipeline::IsSimdLevelSupported(levels[l])) {
+                        continue;
+                    }
+                    LaserFrame vector = MakeSamples(speeds, offset, count, speedSq);
+                    ScannerPipeline::ShadeSamples(vector.MutableView(), speedSq.data(), edgeFade, levels[l]);
+                    ++cases;
+                    for (size_t i = 0; i < count; ++i) {
+                        const float speed = speedSq[i];
+                        const bool same = IsClose(vector.R()[i], scalar.R()[i]) &&
+                                          IsClose(vector.G()[i], scalar.G()[i]) &&
+                                          IsClose(vector.B()[i], scalar.B()[i]);
+                        BEYONDLINK_CHECK(same, levelNames[l] << " vs scalar, edgeFade " << edgeFade << ", speedSq "
+                                         << speed << ": " << vector.R()[i] << " != " << scalar.R()[i]);
+                        // 负速度和着色下限以下（含 0、非规格化数）在各级别逐位相同
+                        if (speed < 1e-30f) {
+                            BEYONDLINK_CHECK(vector.R()[i] == scalar.R()[i] && vector.G()[i] == scalar.G()[i] &&
+                                             vector.B()[i] == scalar.B()[i],
+                                             levelNames[l] << " must match scalar exactly at speedSq " << speed);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return FinishTests("SimdShadingTests", cases);
+}
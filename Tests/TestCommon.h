@@ -0,0 +1,147 @@
+﻿//==============================================================================
+// BeyondLink - Beyond激光可视化系统
+// 文件：TestCommon.h
+// 作者：Yunsio
+// 日期：2025-10-06
+// 描述：单元测试公共工具：断言宏、随机测试帧生成和帧比较
+//       测试程序失败时返回非零退出码，由 ctest 判定结果
+//==============================================================================
+
+#pragma once
+
+#include "LaserFrame.h"
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <random>
+
+namespace BeyondLink {
+namespace Tests {
+
+//==========================================================================
+// 函数：GetFailureCount
+// 描述：获取当前测试程序累计的失败断言数
+//==========================================================================
+inline int& GetFailureCount() {
+    static int failures = 0;
+    return failures;
+}
+
+//==========================================================================
+// 宏：BEYONDLINK_CHECK
+// 描述：断言条件成立，失败时输出位置和说明并计数（不中止，继续后续用例）
+//==========================================================================
+#define BEYONDLINK_CHECK(condition, message)                                             \
+    do {                                                                                 \
+        if (!(condition)) {                                                              \
+            ++::BeyondLink::Tests::GetFailureCount();                                    \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": " << #condition << " - "      \
+                      << message << std::endl;                                           \
+        }                                                                                \
+    } while (0)
+
+//==========================================================================
+// 函数：FinishTests
+// 描述：输出测试结果
+// 参数：
+//   name - 测试程序名称
+//   cases - 执行的用例数
+// 返回值：
+//   int - 进程退出码（全部通过为 0）
+//==========================================================================
+inline int FinishTests(const char* name, int cases) {
+    const int failures = GetFailureCount();
+    std::cout << name << ": " << cases << " cases, " << failures << " failures" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
+
+//==========================================================================
+// 函数：MakeRandomFrame
+// 描述：生成随机测试帧，覆盖处理实例的各类分支：
+//       空白点、光束点（Z > 0）、与前一点位置相同的驻留点和连续重复点
+// 参数：
+//   rng - 随机数生成器
+//   count - 点数
+// 返回值：
+//   Core::LaserFrame - 测试帧
+//==========================================================================
+inline Core::LaserFrame MakeRandomFrame(std::mt19937& rng, size_t count) {
+    std::uniform_real_distribution<float> position(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> color(0.0f, 1.0f);
+    
+    Core::LaserFrame frame;
+    frame.Reserve(count);
+    while (frame.Size() < count) {
+        Core::LaserPoint point(position(rng), position(rng), color(rng), color(rng), color(rng));
+        const unsigned kind = rng() % 10;
+        if (kind == 0) {
+            point.R = point.G = point.B = 0.0f;
+        }
+        point.Focus = color(rng);
+        if (kind == 6 || (kind == 7 && frame.Size() % 3 != 0)) {
+            point.Z = color(rng);
+        }
+        if (!frame.Empty()) {
+            const Core::LaserPoint previous = frame.GetPoint(frame.Size() - 1);
+            if (kind < 4 && (rng() % 2) != 0) {
+                point.X = previous.X;
+                point.Y = previous.Y;
+                if (rng() % 3 != 0) {
+                    point.R = previous.R;
+                    point.G = previous.G;
+                    point.B = previous.B;
+                }
+            }
+            if (kind == 5) {
+                for (unsigned repeat = rng() % 15; repeat > 0 && frame.Size() < count; --repeat) {
+                    frame.Append(previous);
+                }
+            }
+        }
+        if (frame.Size() < count) {
+            frame.Append(point);
+        }
+    }
+    return frame;
+}
+
+//==========================================================================
+// 函数：CompareFrames
+// 描述：逐点比较两帧（容差为 0 时逐通道按位比较）
+//       位置按 tolerance、颜色按 colorTolerance 比较，Z 和聚焦总是要求相等
+// 参数：
+//   a, b - 待比较的帧
+//   tolerance - 位置容差
+//   colorTolerance - 颜色容差
+// 返回值：
+//   bool - 点数相同且各点在容差内一致返回 true
+//==========================================================================
+inline bool CompareFrames(const Core::LaserFrame& a, const Core::LaserFrame& b,
+                          float tolerance = 0.0f, float colorTolerance = 0.0f) {
+    if (a.Size() != b.Size()) {
+        return false;
+    }
+    if (a.Empty()) {
+        return true;
+    }
+    const Core::FrameView va = a.View();
+    const Core::FrameView vb = b.View();
+    if (tolerance == 0.0f && colorTolerance == 0.0f) {
+        const size_t bytes = a.Size() * sizeof(float);
+        return std::memcmp(va.X, vb.X, bytes) == 0 && std::memcmp(va.Y, vb.Y, bytes) == 0 &&
+               std::memcmp(va.R, vb.R, bytes) == 0 && std::memcmp(va.G, vb.G, bytes) == 0 &&
+               std::memcmp(va.B, vb.B, bytes) == 0 && std::memcmp(va.Z, vb.Z, bytes) == 0 &&
+               std::memcmp(va.Focus, vb.Focus, bytes) == 0;
+    }
+    for (size_t i = 0; i < va.Count; ++i) {
+        if (std::abs(va.X[i] - vb.X[i]) > tolerance || std::abs(va.Y[i] - vb.Y[i]) > tolerance ||
+            std::abs(va.R[i] - vb.R[i]) > colorTolerance || std::abs(va.G[i] - vb.G[i]) > colorTolerance ||
+            std::abs(va.B[i] - vb.B[i]) > colorTolerance || va.Z[i] != vb.Z[i] || va.Focus[i] != vb.Focus[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace Tests
+} // namespace BeyondLink
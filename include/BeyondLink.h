@@ -13,8 +13,10 @@
 #include "LaserProtocol.h"
 #include "LaserSource.h"
 #include "LaserSettings.h"
+#include "WorkerPool.h"
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 namespace BeyondLink {
 
@@ -126,6 +128,56 @@ public:
     //==========================================================================
     std::shared_ptr<Core::LaserSource> GetLaserSource(int deviceID);
 
+    //==========================================================================
+    // 常量：ZoneStreamIDBase
+    // 描述：区域流激光源 ID 的起始值（区域流 ID = 起始值 + 设备 * 子网数 + 子网）
+    //      与设备 ID (0-8) 分开，避免纹理和激光源映射冲突
+    //==========================================================================
+    static constexpr int ZoneStreamIDBase = 1000;
+
+    //==========================================================================
+    // 函数：GetZoneStreamID
+    // 描述：计算（设备, 子网）区域流对应的激光源 ID
+    // 参数：
+    //   deviceID - 设备 ID
+    //   subnetID - 子网 ID (0-30)
+    // 返回值：
+    //   区域流激光源 ID
+    //==========================================================================
+    static int GetZoneStreamID(int deviceID, int subnetID) {
+        return ZoneStreamIDBase + deviceID * Core::LaserProtocol::SubnetCount + subnetID;
+    }
+
+    //==========================================================================
+    // 函数：SetDevicePriority
+    // 描述：设置设备在帧点数预算（FramePointBudget）分配中的优先级，设备的区域流使用相同优先级
+    //      各激光源按 优先级 × 点数需求 的比例分配预算，需求较小的激光源不超过其需求
+    // 参数：
+    //   deviceID - 设备 ID
+    //   priority - 优先级（默认 1.0，例如当前查看的设备取更大的值）
+    //==========================================================================
+    void SetDevicePriority(int deviceID, float priority);
+
+    //==========================================================================
+    // 函数：GetDevicePointCount
+    // 描述：获取设备的处理后点数量（区域流模式下为该设备所有区域流之和）
+    // 参数：
+    //   deviceID - 设备 ID
+    // 返回值：
+    //   点数量
+    //==========================================================================
+    size_t GetDevicePointCount(int deviceID);
+
+    //==========================================================================
+    // 函数：GetActiveZoneCount
+    // 描述：获取设备已收到数据的区域流数量（未启用区域流模式时为 0）
+    // 参数：
+    //   deviceID - 设备 ID
+    // 返回值：
+    //   区域流数量
+    //==========================================================================
+    int GetActiveZoneCount(int deviceID);
+
     //==========================================================================
     // 函数：GetRenderer
     // 描述：获取渲染器指针（用于高级操作）
@@ -142,6 +194,38 @@ public:
     //==========================================================================
     Core::LaserProtocol::NetworkStats GetNetworkStats() const;
 
+    //==========================================================================
+    // 函数：GetLatencyStats
+    // 描述：获取网络接收到分发的延迟统计
+    // 返回值：
+    //   延迟统计结构体
+    //==========================================================================
+    Core::LaserProtocol::LatencyStats GetLatencyStats() const;
+
+    //==========================================================================
+    // 函数：GetFrameCacheStats
+    // 描述：获取所有激光源的帧缓存统计汇总
+    // 返回值：
+    //   帧缓存统计结构体
+    //==========================================================================
+    Core::FrameCacheStats GetFrameCacheStats();
+
+    //==========================================================================
+    // 函数：GetArenaPeakBytes
+    // 描述：获取所有激光源帧内存池的峰值用量之和
+    // 返回值：
+    //   峰值字节数
+    //==========================================================================
+    size_t GetArenaPeakBytes();
+
+    //==========================================================================
+    // 函数：GetPipelineStats
+    // 描述：获取所有激光源的扫描仪模拟处理统计汇总
+    // 返回值：
+    //   处理统计结构体
+    //==========================================================================
+    Core::ScannerPipelineStats GetPipelineStats();
+
     //==========================================================================
     // 函数：GetSettings
     // 描述：获取/访问系统配置参数
@@ -153,14 +237,16 @@ public:
 
 private:
     //==========================================================================
-    // 函数：OnLaserDataReceived
-    // 描述：网络数据接收回调函数（内部使用）
-    //      当接收到激光数据包时被调用，更新对应设备的激光源
+    // 函数：ResolveInboundSource
+    // 描述：网络接收线程的目标激光源查找函数（内部使用）
+    //      解码器将点直接写入返回激光源的接收缓冲，不再经过中间点列表
     // 参数：
     //   deviceID - 设备 ID
-    //   points - 解析后的激光点列表
+    //   subnetID - 子网 ID（未知时为 -1）
+    // 返回值：
+    //   目标激光源指针（找不到时为 nullptr）
     //==========================================================================
-    void OnLaserDataReceived(int deviceID, const std::vector<Core::LaserPoint>& points);
+    Core::LaserSource* ResolveInboundSource(int deviceID, int subnetID);
 
     //==========================================================================
     // 函数：EnsureLaserSource
@@ -170,6 +256,33 @@ private:
     //==========================================================================
     void EnsureLaserSource(int deviceID);
 
+    //==========================================================================
+    // 函数：GetZoneStream
+    // 描述：获取（设备, 子网）区域流的激光源，不存在则创建
+    //      新建的区域流先放入待注册列表，由主线程在 Update 中注册到渲染器
+    //      调用者必须持有 m_SourcesMutex
+    // 参数：
+    //   deviceID - 设备 ID
+    //   subnetID - 子网 ID
+    // 返回值：
+    //   区域流激光源（参数越界时返回 nullptr）
+    //==========================================================================
+    std::shared_ptr<Core::LaserSource> GetZoneStream(int deviceID, int subnetID);
+
+    //==========================================================================
+    // 函数：RegisterPendingZoneStreams
+    // 描述：将接收线程新建的区域流注册到渲染器（仅在主线程调用）
+    //      调用者必须持有 m_SourcesMutex
+    //==========================================================================
+    void RegisterPendingZoneStreams();
+
+    //==========================================================================
+    // 函数：AllocatePointBudget
+    // 描述：按设备优先级和各激光源上一帧的点数需求分配帧点数预算（仅在主线程调用）
+    //      总需求不超过预算时所有激光源不限制；调用者必须持有 m_SourcesMutex
+    //==========================================================================
+    void AllocatePointBudget();
+
 private:
     Core::LaserSettings m_Settings;                                      // 系统配置
     bool m_Initialized;                                                  // 初始化标志
@@ -177,10 +290,23 @@ private:
     // 核心组件
     std::unique_ptr<LaserRenderer> m_Renderer;                           // 渲染器
     std::unique_ptr<Core::LaserProtocol> m_Protocol;                     // 网络协议处理器
+    std::unique_ptr<Core::WorkerPool> m_WorkerPool;                      // 常驻工作线程池（未启用并行时为空）
     
     // 激光源管理（设备 ID → 激光源）
     std::unordered_map<int, std::shared_ptr<Core::LaserSource>> m_LaserSources;
     std::mutex m_SourcesMutex;                                           // 激光源访问互斥锁
+    
+    // 区域流（扁平索引：设备 * 子网数 + 子网 → 激光源，按需创建）
+    std::vector<std::shared_ptr<Core::LaserSource>> m_ZoneStreams;
+    std::vector<std::pair<int, std::shared_ptr<Core::LaserSource>>> m_PendingZoneStreams;  // 待注册到渲染器的区域流（设备 ID, 激光源）
+    
+    // Update 使用的激光源快照（按处理代价降序，跨帧复用容量）
+    std::vector<std::pair<size_t, std::shared_ptr<Core::LaserSource>>> m_UpdateQueue;
+    
+    // 帧点数预算分配（设备 ID → 优先级；分配用的需求与权重按 m_UpdateQueue 顺序，跨帧复用容量）
+    std::unordered_map<int, float> m_DevicePriorities;
+    std::vector<size_t> m_BudgetDemands;
+    std::vector<double> m_BudgetWeights;
 };
 
 } // namespace BeyondLink
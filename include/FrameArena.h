@@ -0,0 +1,115 @@
+﻿//==============================================================================
+// 文件：FrameArena.h
+// 作者：Yunsio
+// 日期：2025-10-06
+// 描述：帧内存池（线性分配器）
+//      处理管线的中间结果从内存池分配，每帧开始时整体重置
+//==============================================================================
+
+#pragma once
+
+#include "LaserFrame.h"
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace BeyondLink {
+namespace Core {
+
+//==========================================================================
+// 类：FrameArena
+// 描述：单线程线性（bump）分配器
+//      - Allocate 只移动偏移量，不单独释放
+//      - 当前块不足时追加新块，Reset 时合并为一个不小于峰值的块
+//      - 稳定运行后每帧只有一个块，不再调用系统分配器
+//      非线程安全，由所属 LaserSource 的互斥锁保护
+//==========================================================================
+class FrameArena {
+public:
+    static constexpr size_t DefaultAlignment = 32;      // 默认对齐（与 LaserFrame 通道一致）
+
+    //==========================================================================
+    // 构造函数：FrameArena
+    // 参数：
+    //   initialBytes - 初始块大小（字节）
+    //==========================================================================
+    explicit FrameArena(size_t initialBytes = 64 * 1024);
+    ~FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    //==========================================================================
+    // 函数：Allocate
+    // 描述：分配一段对齐的内存，有效期到下次 Reset
+    // 参数：
+    //   bytes - 字节数
+    //   alignment - 对齐字节数（2 的幂）
+    // 返回值：
+    //   内存首地址
+    //==========================================================================
+    void* Allocate(size_t bytes, size_t alignment = DefaultAlignment);
+
+    //==========================================================================
+    // 函数：AllocateArray
+    // 描述：分配 count 个 T 的数组（不构造，仅用于平凡类型）
+    //==========================================================================
+    template <typename T>
+    T* AllocateArray(size_t count) {
+        return static_cast<T*>(Allocate(count * sizeof(T), alignof(T) > DefaultAlignment ? alignof(T) : DefaultAlignment));
+    }
+
+    //==========================================================================
+    // 函数：AllocateFrame
+    // 描述：分配 count 个点的 SoA 帧（7 个对齐通道）
+    // 参数：
+    //   count - 点数量
+    // 返回值：
+    //   可写帧视图
+    //==========================================================================
+    MutableFrameView AllocateFrame(size_t count);
+
+    //==========================================================================
+    // 函数：Reset
+    // 描述：释放本帧的全部分配；上一帧溢出到多个块时合并为一个块
+    //==========================================================================
+    void Reset();
+
+    //==========================================================================
+    // 函数：GetUsedBytes / GetPeakBytes / GetCapacityBytes
+    // 描述：本帧已用字节 / 历史单帧峰值 / 已持有的块总大小
+    //==========================================================================
+    size_t GetUsedBytes() const { return m_UsedBytes; }
+    size_t GetPeakBytes() const { return m_PeakBytes; }
+    size_t GetCapacityBytes() const;
+
+private:
+    //==========================================================================
+    // 结构体：Block
+    // 描述：内存块
+    //==========================================================================
+    struct Block {
+        uint8_t* Data;
+        size_t Size;
+    };
+
+    //==========================================================================
+    // 函数：AddBlock
+    // 描述：追加一个至少 minBytes 字节的新块并设为当前块
+    //==========================================================================
+    void AddBlock(size_t minBytes);
+
+    //==========================================================================
+    // 函数：ReleaseBlocks
+    // 描述：释放所有块
+    //==========================================================================
+    void ReleaseBlocks();
+
+    std::vector<Block> m_Blocks;                 // 内存块列表（最后一个为当前块）
+    size_t m_Offset;                             // 当前块内的偏移量
+    size_t m_UsedBytes;                          // 本帧已分配字节（含对齐填充）
+    size_t m_PeakBytes;                          // 单帧峰值
+};
+
+} // namespace Core
+} // namespace BeyondLink
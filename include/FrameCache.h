@@ -0,0 +1,175 @@
+﻿//==============================================================================
+// 文件：FrameCache.h
+// 作者：Yunsio
+// 日期：2025-10-06
+// 描述：激光帧缓存模块
+//      以帧内容哈希为键缓存处理后的点列表（有界 LRU）
+//      静态画面和循环动画可跳过重复的扫描仪模拟
+//==============================================================================
+
+#pragma once
+
+#include "LaserFrame.h"
+#include "HotBeam.h"
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+namespace BeyondLink {
+namespace Core {
+
+//==========================================================================
+// 结构体：FrameCacheStats
+// 描述：帧缓存统计信息
+//==========================================================================
+struct FrameCacheStats {
+    uint64_t Hits = 0;                           // 命中次数（跳过扫描仪模拟）
+    uint64_t Misses = 0;                         // 未命中次数（完整处理）
+    uint64_t DecodeSkips = 0;                    // 跳过解码的数据包数（与当前帧相同）
+    size_t Entries = 0;                          // 当前缓存条目数
+    size_t MemoryBytes = 0;                      // 缓存点数据占用内存（字节）
+    
+    //==========================================================================
+    // 函数：Merge
+    // 描述：累加另一组统计（用于多个激光源汇总）
+    // 参数：
+    //   other - 另一组统计
+    //==========================================================================
+    void Merge(const FrameCacheStats& other) {
+        Hits += other.Hits;
+        Misses += other.Misses;
+        DecodeSkips += other.DecodeSkips;
+        Entries += other.Entries;
+        MemoryBytes += other.MemoryBytes;
+    }
+    
+    //==========================================================================
+    // 函数：GetHitRate
+    // 描述：计算命中率
+    // 返回值：
+    //   命中率 [0.0, 1.0]，无访问时为 0
+    //==========================================================================
+    double GetHitRate() const {
+        uint64_t total = Hits + Misses;
+        return total > 0 ? static_cast<double>(Hits) / static_cast<double>(total) : 0.0;
+    }
+};
+
+//==========================================================================
+// 类：FrameCache
+// 描述：单个激光源的处理结果缓存（有界 LRU）
+//      键为帧内容哈希与处理参数的组合，值为主点、光束点列表和高强度光束游程
+//      点列表以共享帧保存和恢复，不拷贝点数据（光束点与主点相同时共用一个缓冲）
+//      非线程安全，由所属 LaserSource 的互斥锁保护
+//==========================================================================
+class FrameCache {
+public:
+    //==========================================================================
+    // 构造函数：FrameCache
+    // 参数：
+    //   capacity - 最大缓存帧数（至少为 1）
+    //==========================================================================
+    explicit FrameCache(size_t capacity);
+
+    //==========================================================================
+    // 函数：Restore
+    // 描述：查找缓存并取出处理结果（共享帧），命中时条目移到最近使用位置
+    // 参数：
+    //   key - 帧键
+    //   processed - [输出] 主点列表
+    //   beam - [输出] 光束点列表（条目未保存光束点时不变）
+    //   hotBeams - [输出] 高强度光束游程
+    //   pointDemand - [输出] 点预算抽取前的主点数
+    // 返回值：
+    //   true - 命中
+    //   false - 未命中（输出不变）
+    //==========================================================================
+    bool Restore(uint64_t key,
+                 SharedFrame& processed,
+                 SharedFrame& beam,
+                 std::vector<HotBeamRun>& hotBeams,
+                 size_t& pointDemand);
+
+    //==========================================================================
+    // 函数：Store
+    // 描述：写入处理结果（保存共享帧的引用），已满时淘汰最久未使用的条目
+    // 参数：
+    //   key - 帧键
+    //   processed - 主点列表
+    //   beam - 光束点列表（为空表示不保存）
+    //   hotBeams - 高强度光束游程
+    //   pointDemand - 点预算抽取前的主点数（命中时恢复，供全局点预算分配使用）
+    //==========================================================================
+    void Store(uint64_t key,
+               const SharedFrame& processed,
+               const SharedFrame& beam,
+               const std::vector<HotBeamRun>& hotBeams,
+               size_t pointDemand);
+
+    //==========================================================================
+    // 函数：RecordHit / RecordDecodeSkip
+    // 描述：记录缓存之外的复用（当前输出已是该帧 / 数据包与当前帧相同）
+    //==========================================================================
+    void RecordHit() { m_Stats.Hits++; }
+    void RecordDecodeSkip() { m_Stats.DecodeSkips++; }
+
+    //==========================================================================
+    // 函数：Clear
+    // 描述：清空所有缓存条目（统计计数保留）
+    //==========================================================================
+    void Clear();
+
+    //==========================================================================
+    // 函数：GetStats
+    // 描述：获取缓存统计信息
+    // 返回值：
+    //   统计信息结构体
+    //==========================================================================
+    FrameCacheStats GetStats() const;
+
+    //==========================================================================
+    // 函数：HashBytes
+    // 描述：计算数据块的 64 位哈希（按 8 字节字处理，用于帧内容寻址）
+    // 参数：
+    //   data - 数据指针
+    //   size - 字节数
+    //   seed - 哈希种子（区分不同数据格式）
+    // 返回值：
+    //   非零哈希值（0 保留表示"未知帧"）
+    //==========================================================================
+    static uint64_t HashBytes(const void* data, size_t size, uint64_t seed);
+
+    //==========================================================================
+    // 函数：CombineKey
+    // 描述：将帧内容哈希与处理参数组合为缓存键
+    // 参数：
+    //   frameHash - 帧内容哈希
+    //   salt - 处理参数签名
+    // 返回值：
+    //   非零缓存键
+    //==========================================================================
+    static uint64_t CombineKey(uint64_t frameHash, uint64_t salt);
+
+private:
+    //==========================================================================
+    // 结构体：Entry
+    // 描述：缓存条目
+    //==========================================================================
+    struct Entry {
+        uint64_t Key = 0;
+        SharedFrame Processed;
+        SharedFrame Beam;
+        std::vector<HotBeamRun> HotBeams;
+        size_t PointDemand = 0;                  // 点预算抽取前的主点数
+    };
+
+    size_t m_Capacity;                                                   // 最大条目数
+    std::list<Entry> m_Entries;                                          // LRU 链表（前端最近使用）
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> m_Index;    // 键 → 条目
+    FrameCacheStats m_Stats;                                             // 统计计数
+};
+
+} // namespace Core
+} // namespace BeyondLink
@@ -0,0 +1,63 @@
+﻿//==============================================================================
+// 文件：HotBeam.h
+// 作者：Yunsio
+// 日期：2025-10-06
+// 描述：高强度光束的游程记录（静止光束增强渲染）
+//      每条光束只记录一次位置、颜色、重复次数和 Z 斜坡，需要逐点数据时再展开
+//==============================================================================
+
+#pragma once
+
+#include "LaserPoint.h"
+#include "LaserFrame.h"
+#include <algorithm>
+#include <vector>
+#include <cstddef>
+
+namespace BeyondLink {
+namespace Core {
+
+//==========================================================================
+// 结构体：HotBeamRun
+// 描述：一条静止光束的高强度点游程
+//      展开后第 j 个点（0 <= j < RepeatCount）与 Point 相同，仅 Z 不同：
+//      Z = max(ZFloor, ZEnd × j / (RepeatCount - 1))
+//==========================================================================
+struct HotBeamRun {
+    LaserPoint Point;                            // 光束点（Z 不使用，由斜坡生成）
+    int RepeatCount = 0;                         // 展开的点数
+    float ZFloor = 0.0001f;                      // Z 下限（保证展开点均为光束点）
+    float ZEnd = 1.0f;                           // 斜坡终点 Z
+    
+    //==========================================================================
+    // 函数：GetPoint
+    // 描述：获取展开后的第 index 个点
+    //==========================================================================
+    LaserPoint GetPoint(int index) const {
+        LaserPoint point = Point;
+        point.Z = (std::max)(ZFloor, ZEnd * (static_cast<float>(index) / static_cast<float>(RepeatCount - 1)));
+        return point;
+    }
+};
+
+//==========================================================================
+// 函数：CountHotBeamPoints
+// 描述：计算游程展开后的总点数
+// 参数：
+//   runs - 光束游程列表
+// 返回值：
+//   展开点数
+//==========================================================================
+size_t CountHotBeamPoints(const std::vector<HotBeamRun>& runs);
+
+//==========================================================================
+// 函数：ExpandHotBeams
+// 描述：将游程展开为逐点帧（按通道直接写入，复用输出容量）
+// 参数：
+//   runs - 光束游程列表
+//   result - [输出] 展开后的点帧
+//==========================================================================
+void ExpandHotBeams(const std::vector<HotBeamRun>& runs, LaserFrame& result);
+
+} // namespace Core
+} // namespace BeyondLink
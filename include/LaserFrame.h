@@ -0,0 +1,247 @@
+﻿//==============================================================================
+// 文件：LaserFrame.h
+// 作者：Yunsio
+// 日期：2025-10-06
+// 描述：激光帧数据容器（结构数组 SoA 布局）
+//      X/Y/R/G/B/Z/Focus 各通道独立存放在对齐的连续数组中
+//      处理管线内部使用，仅在渲染上传时转换为 28 字节 LaserPoint 顶点
+//==============================================================================
+
+#pragma once
+
+#include "LaserPoint.h"
+#include <vector>
+#include <memory>
+#include <new>
+#include <cstddef>
+
+namespace BeyondLink {
+namespace Core {
+
+//==========================================================================
+// 类：AlignedAllocator
+// 描述：按指定字节对齐分配内存的分配器（通道数组按 SIMD 宽度对齐）
+//==========================================================================
+template <typename T, size_t Alignment>
+class AlignedAllocator {
+public:
+    using value_type = T;
+    
+    template <typename U>
+    struct rebind { using other = AlignedAllocator<U, Alignment>; };
+    
+    AlignedAllocator() noexcept = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+    
+    T* allocate(size_t count) {
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(Alignment)));
+    }
+    
+    void deallocate(T* pointer, size_t) noexcept {
+        ::operator delete(pointer, std::align_val_t(Alignment));
+    }
+    
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+};
+
+//==========================================================================
+// 结构体：BasicFrameView
+// 描述：帧数据的轻量视图（各通道指针 + 点数量），不持有内存
+//      FrameView 为只读视图，MutableFrameView 为可写视图
+//==========================================================================
+template <typename T>
+struct BasicFrameView {
+    T* X = nullptr;
+    T* Y = nullptr;
+    T* R = nullptr;
+    T* G = nullptr;
+    T* B = nullptr;
+    T* Z = nullptr;
+    T* Focus = nullptr;
+    size_t Count = 0;
+    
+    //==========================================================================
+    // 函数：GetPoint
+    // 描述：按索引组装为 LaserPoint
+    //==========================================================================
+    LaserPoint GetPoint(size_t index) const {
+        return LaserPoint(X[index], Y[index], R[index], G[index], B[index], Z[index], Focus[index]);
+    }
+    
+    //==========================================================================
+    // 函数：SetPoint
+    // 描述：按索引写入 LaserPoint 的各通道（仅可写视图可用）
+    //==========================================================================
+    void SetPoint(size_t index, const LaserPoint& point) const {
+        X[index] = point.X;
+        Y[index] = point.Y;
+        R[index] = point.R;
+        G[index] = point.G;
+        B[index] = point.B;
+        Z[index] = point.Z;
+        Focus[index] = point.Focus;
+    }
+};
+
+using FrameView = BasicFrameView<const float>;
+using MutableFrameView = BasicFrameView<float>;
+
+//==========================================================================
+// 函数：ToConstView
+// 描述：将可写视图转换为只读视图
+//==========================================================================
+inline FrameView ToConstView(const MutableFrameView& view) {
+    FrameView result;
+    result.X = view.X;
+    result.Y = view.Y;
+    result.R = view.R;
+    result.G = view.G;
+    result.B = view.B;
+    result.Z = view.Z;
+    result.Focus = view.Focus;
+    result.Count = view.Count;
+    return result;
+}
+
+//==========================================================================
+// 类：LaserFrame
+// 描述：一帧激光点数据（SoA 布局）
+//      - 各通道 32 字节对齐，便于向量化处理
+//      - 仅位置的处理（重复点检测、距离计算）只访问 X/Y 通道
+//      - Resize/Clear 保留容量，缓冲可跨帧复用
+//==========================================================================
+class LaserFrame {
+public:
+    static constexpr size_t Alignment = 32;      // 通道数组对齐字节数
+    static constexpr size_t ChannelCount = 7;    // 通道数量
+    using Channel = std::vector<float, AlignedAllocator<float, Alignment>>;
+
+    //==========================================================================
+    // 函数：Size / Empty / Capacity
+    // 描述：获取点数量 / 是否为空 / 已分配容量（点数）
+    //==========================================================================
+    size_t Size() const { return m_X.size(); }
+    bool Empty() const { return m_X.empty(); }
+    size_t Capacity() const { return m_X.capacity(); }
+
+    //==========================================================================
+    // 函数：Resize / Reserve / Clear
+    // 描述：调整点数量 / 预留容量 / 清空（保留容量）
+    //==========================================================================
+    void Resize(size_t count);
+    void Reserve(size_t count);
+    void Clear();
+
+    //==========================================================================
+    // 函数：Append
+    // 描述：在末尾追加一个点
+    // 参数：
+    //   point - 激光点
+    //==========================================================================
+    void Append(const LaserPoint& point);
+
+    //==========================================================================
+    // 函数：GetPoint / SetPoint
+    // 描述：按索引读取/写入完整的点（逐通道访问，仅用于非热点路径）
+    //==========================================================================
+    LaserPoint GetPoint(size_t index) const { return View().GetPoint(index); }
+    void SetPoint(size_t index, const LaserPoint& point) { MutableView().SetPoint(index, point); }
+
+    //==========================================================================
+    // 函数：X / Y / R / G / B / Z / Focus
+    // 描述：获取通道数组首地址
+    //==========================================================================
+    float* X() { return m_X.data(); }
+    float* Y() { return m_Y.data(); }
+    float* R() { return m_R.data(); }
+    float* G() { return m_G.data(); }
+    float* B() { return m_B.data(); }
+    float* Z() { return m_Z.data(); }
+    float* Focus() { return m_Focus.data(); }
+    const float* X() const { return m_X.data(); }
+    const float* Y() const { return m_Y.data(); }
+    const float* R() const { return m_R.data(); }
+    const float* G() const { return m_G.data(); }
+    const float* B() const { return m_B.data(); }
+    const float* Z() const { return m_Z.data(); }
+    const float* Focus() const { return m_Focus.data(); }
+
+    //==========================================================================
+    // 函数：View / MutableView
+    // 描述：获取只读/可写视图（Resize 后失效）
+    //==========================================================================
+    FrameView View() const;
+    MutableFrameView MutableView();
+
+    //==========================================================================
+    // 函数：Assign
+    // 描述：从 AoS 点数组复制（拆分到各通道）
+    // 参数：
+    //   points - LaserPoint 数组
+    //   count - 点数量
+    //==========================================================================
+    void Assign(const LaserPoint* points, size_t count);
+
+    //==========================================================================
+    // 函数：AssignFrom
+    // 描述：从另一帧复制全部点（保留本帧容量）
+    // 参数：
+    //   other - 源帧
+    //==========================================================================
+    void AssignFrom(const LaserFrame& other);
+
+    //==========================================================================
+    // 函数：CopyTo
+    // 描述：转换为 AoS 顶点布局（渲染上传边界使用）
+    // 参数：
+    //   points - 输出数组（至少 Size() 个点）
+    //==========================================================================
+    void CopyTo(LaserPoint* points) const;
+
+    //==========================================================================
+    // 函数：Swap
+    // 描述：与另一帧交换数据（不拷贝点数据）
+    //==========================================================================
+    void Swap(LaserFrame& other) noexcept;
+
+    //==========================================================================
+    // 函数：GetMemoryBytes
+    // 描述：获取已分配的通道内存（字节）
+    //==========================================================================
+    size_t GetMemoryBytes() const { return Capacity() * ChannelCount * sizeof(float); }
+
+private:
+    Channel m_X;                                 // X 坐标
+    Channel m_Y;                                 // Y 坐标
+    Channel m_R;                                 // 红色通道
+    Channel m_G;                                 // 绿色通道
+    Channel m_B;                                 // 蓝色通道
+    Channel m_Z;                                 // 深度/光束标记
+    Channel m_Focus;                             // 聚焦值
+};
+
+//==========================================================================
+// 类型：SharedFrame
+// 描述：引用计数的不可变帧，内容相同的输出列表（主点/光束点/原始点）共用同一缓冲
+//      只能由 AcquireWritableFrame 创建，持有者只读
+//==========================================================================
+using SharedFrame = std::shared_ptr<const LaserFrame>;
+
+//==========================================================================
+// 函数：AcquireWritableFrame
+// 描述：获取可写入的帧缓冲（写时复制）
+//      没有其他持有者时原地复用缓冲容量；仍被共享时替换为新缓冲（不拷贝旧内容），
+//      其他持有者看到的内容不变
+// 参数：
+//   frame - [输入/输出] 共享帧（为空时创建）
+// 返回值：
+//   可写帧的引用（frame 被再次共享前有效）
+//==========================================================================
+LaserFrame& AcquireWritableFrame(SharedFrame& frame);
+
+} // namespace Core
+} // namespace BeyondLink
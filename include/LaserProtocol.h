@@ -30,6 +30,7 @@
 
 #include "LaserPoint.h"
 #include "LaserSettings.h"
+#include "LaserFrame.h"
 #include <vector>
 #include <thread>
 #include <atomic>
@@ -39,6 +40,8 @@
 namespace BeyondLink {
 namespace Core {
 
+class LaserSource;
+
 //==========================================================================
 // 类：LaserProtocol
 // 描述：Beyond 激光网络通信协议处理器
@@ -86,21 +89,31 @@ public:
     bool IsRunning() const { return m_Running; }
 
     //==========================================================================
-    // 类型：DataCallback
-    // 描述：数据接收回调函数类型
+    // 常量：SubnetCount
+    // 描述：每个设备的子网（投影区域）数量，多播地址 239.255.X.0 - 239.255.X.30
+    //==========================================================================
+    static constexpr int SubnetCount = 31;
+
+    //==========================================================================
+    // 类型：SourceResolver
+    // 描述：目标激光源查找函数类型
+    //      解码器直接把点写入目标激光源的接收缓冲（未设置时数据包只计入统计）
+    //      返回的激光源必须在接收线程停止前保持有效
     // 参数：
-    //   deviceID - 设备 ID (0-3)
-    //   points - 解析后的激光点列表
+    //   deviceID - 设备 ID
+    //   subnetID - 子网 ID (0-30)，取自目标地址 239.255.X.Y 的 Y，未知时为 -1
+    // 返回值：
+    //   目标激光源指针（nullptr 表示丢弃该数据包）
     //==========================================================================
-    using DataCallback = std::function<void(int deviceID, const std::vector<LaserPoint>&)>;
-    
+    using SourceResolver = std::function<LaserSource*(int deviceID, int subnetID)>;
+
     //==========================================================================
-    // 函数：SetDataCallback
-    // 描述：设置数据接收回调函数
+    // 函数：SetSourceResolver
+    // 描述：设置目标激光源查找函数（在 Start 之前调用）
     // 参数：
-    //   callback - 回调函数
+    //   resolver - 查找函数
     //==========================================================================
-    void SetDataCallback(DataCallback callback) { m_DataCallback = callback; }
+    void SetSourceResolver(SourceResolver resolver) { m_SourceResolver = resolver; }
 
     //==========================================================================
     // 结构体：NetworkStats
@@ -120,6 +133,55 @@ public:
     //   网络统计信息结构体
     //==========================================================================
     NetworkStats GetStats() const { return m_Stats; }
+
+    //==========================================================================
+    // 结构体：LatencyStats
+    // 描述：到达到分发延迟统计（从内核接收数据包到分发返回）
+    //      起点取内核接收时间戳，包含阻塞等待的唤醒延迟和自旋的检测延迟；
+    //      平台不提供时间戳时退回为取出数据包的时刻（只含分发耗时，计入 UnstampedReceives）
+    //      直方图按 2 的幂划分微秒区间：桶 0 为 <1us，桶 i 为 [2^(i-1), 2^i) us
+    //==========================================================================
+    struct LatencyStats {
+        static constexpr int BucketCount = 21;   // 最后一个桶收纳所有 >=2^19 us 的样本
+        uint64_t Buckets[BucketCount] = {};      // 延迟直方图
+        uint64_t Samples = 0;                    // 样本总数
+        uint64_t MaxMicroseconds = 0;            // 最大延迟（微秒）
+        uint64_t SpinReceives = 0;               // 自旋阶段直接取到的数据包数（低延迟模式）
+        uint64_t BlockingWakeups = 0;            // 阻塞等待后因 socket 可读而唤醒的次数（低延迟模式，不含超时）
+        uint64_t UnstampedReceives = 0;          // 没有内核接收时间戳、从取出时刻计时的数据包数
+        bool BusyPollMode = false;               // 统计采集时是否处于低延迟模式
+
+        //======================================================================
+        // 函数：GetPercentile
+        // 描述：根据直方图估算百分位延迟（返回所在桶的上界）
+        // 参数：
+        //   percentile - 百分位 [0.0, 1.0]
+        // 返回值：
+        //   延迟上界（微秒），无样本时返回 0
+        //======================================================================
+        uint64_t GetPercentile(double percentile) const {
+            if (Samples == 0) {
+                return 0;
+            }
+            uint64_t target = static_cast<uint64_t>(percentile * static_cast<double>(Samples));
+            uint64_t accumulated = 0;
+            for (int i = 0; i < BucketCount; ++i) {
+                accumulated += Buckets[i];
+                if (accumulated > target) {
+                    return 1ull << i;
+                }
+            }
+            return MaxMicroseconds;
+        }
+    };
+
+    //==========================================================================
+    // 函数：GetLatencyStats
+    // 描述：获取接收到分发延迟统计
+    // 返回值：
+    //   延迟统计结构体
+    //==========================================================================
+    LatencyStats GetLatencyStats() const;
     
     //==========================================================================
     // 函数：GetPort
@@ -185,26 +247,69 @@ private:
     //      循环接收 UDP 数据包，提取目标地址，解析激光数据
     //==========================================================================
     void ReceiveThread();
+
+    //==========================================================================
+    // 函数：WaitForReadable
+    // 描述：阻塞等待 socket 可读（低延迟模式自旋预算耗尽后的回退路径）
+    // 参数：
+    //   timeoutMs - 最长等待时间（毫秒），超时后返回以便检查停止标志
+    // 返回值：
+    //   true - socket 可读
+    //   false - 超时、出错或 socket 已关闭
+    //==========================================================================
+    bool WaitForReadable(int timeoutMs);
+
+    //==========================================================================
+    // 函数：EnableReceiveTimestamps
+    // 描述：请求内核为接收的数据包附加到达时间戳（Windows 为 SIO_TIMESTAMPING，其他平台为 SO_TIMESTAMPNS）
+    //      不支持时延迟统计退回为从取出数据包的时刻计时
+    // 返回值：
+    //   true - 已启用
+    //   false - 平台不支持
+    //==========================================================================
+    bool EnableReceiveTimestamps();
+
+    //==========================================================================
+    // 函数：RecordLatency
+    // 描述：记录一个数据包的到达到分发延迟
+    // 参数：
+    //   microseconds - 延迟（微秒）
+    //   fromSpin - 数据包是否在自旋阶段取得
+    //   stamped - 起点是否为内核接收时间戳
+    //==========================================================================
+    void RecordLatency(uint64_t microseconds, bool fromSpin, bool stamped);
     
     //==========================================================================
-    // 函数：ParsePacket
-    // 描述：解析 UDP 数据包为激光点列表
+    // 函数：DecodePacketInPlace
+    // 描述：解析数据包并直接写入目标激光源的接收缓冲，随后原子发布
     //      1. 调用 linetD2_x64.dll::ReadLaserData 解析包
     //      2. 根据 extractedDeviceID 调用 GetData 获取点数据
-    //      3. 转换为 LaserPoint 格式（Y 轴反转，颜色归一化）
+    //      3. 转换到接收缓冲（Y 轴反转，颜色归一化），不经过中间点列表
     // 参数：
-    //   data - UDP 数据包内容
+    //   data - UDP 数据包内容（DLL 直接读取，不再复制）
     //   length - 数据包长度
     //   extractedDeviceID - 从目标地址提取的设备 ID
-    //   deviceID - 输出：解析到的设备 ID
-    //   points - 输出：解析后的激光点列表
+    //   extractedSubnetID - 从目标地址提取的子网 ID
     // 返回值：
-    //   true - 解析成功
-    //   false - 解析失败
+    //   true - 已写入并发布到激光源
+    //   false - 解析失败、无点数据或无目标激光源
+    //==========================================================================
+    bool DecodePacketInPlace(uint8_t* data, size_t length,
+                             int extractedDeviceID, int extractedSubnetID);
+
     //==========================================================================
-    bool ParsePacket(const uint8_t* data, size_t length, 
-                     int extractedDeviceID, int& deviceID, 
-                     std::vector<LaserPoint>& points);
+    // 函数：ConvertPoints
+    // 描述：将 DLL 输出的点数据（X, Y, Focus, R, G, B 各 float）转换为 LaserPoint
+    //      Y 轴反转、颜色归一化，颜色归属前一个点（协议特性）
+    // 参数：
+    //   floatData - DLL 输出数据（每点 6 个 float）
+    //   pointCount - 点数量
+    //   points - 输出帧视图（至少 pointCount 个点，逐通道写入）
+    //==========================================================================
+    static void ConvertPoints(const float* floatData, int pointCount, const MutableFrameView& points);
+
+    // DLL 输出哈希种子（帧缓存用，与 LaserSource 的原始点哈希区分）
+    static constexpr uint64_t DecodedFrameHashSeed = 0x4C696E6574443258ull;
     
     //==========================================================================
     // 函数：GetMulticastAddress
@@ -223,30 +328,31 @@ private:
     int m_MaxDevices;                            // 最大设备数量
     
 #ifdef _WIN32
-    SOCKET m_Socket = INVALID_SOCKET;            // Windows Socket 句柄
+    std::atomic<SOCKET> m_Socket{ INVALID_SOCKET };  // Windows Socket 句柄（Stop 关闭时接收线程可能正在读取）
     WSADATA m_WSAData;                           // WSA 数据
     
-    // linetD2_x64.dll 函数指针（用于解析 Pangolin 协议）
-    HMODULE m_DllHandle;                                            // DLL 句柄
-    void (*m_InitDll)(int maxDevices);                             // 初始化函数
-    void (*m_ReadLaserData)(void* data, int length);               // 读取激光数据
-    void* (*m_GetData)(int device, int* pointCount);               // 获取解析后的数据
-    void (*m_Release)();                                           // 释放资源
+    HMODULE m_DllHandle = nullptr;               // linetD2_x64.dll 句柄
 #else
-    int m_Socket = -1;                           // Linux Socket 句柄
+    std::atomic<int> m_Socket{ -1 };             // Linux Socket 句柄（Stop 关闭时接收线程可能正在读取）
 #endif
     
+    // linetD2_x64.dll 函数指针（用于解析 Pangolin 协议；非 Windows 平台没有 DLL，数据包只计入统计）
+    void (*m_InitDll)(int maxDevices) = nullptr;                   // 初始化函数
+    void (*m_ReadLaserData)(void* data, int length) = nullptr;     // 读取激光数据
+    void* (*m_GetData)(int device, int* pointCount) = nullptr;     // 获取解析后的数据
+    void (*m_Release)() = nullptr;                                 // 释放资源
+    
     // 线程控制
     std::atomic<bool> m_Running;                 // 运行标志
     std::thread m_ReceiveThread;                 // 接收线程
     
-    // 数据回调
-    DataCallback m_DataCallback;                 // 数据回调函数
-    std::mutex m_CallbackMutex;                  // 回调互斥锁
+    // 数据分发
+    SourceResolver m_SourceResolver;             // 目标激光源查找函数（原地解码）
     
     // 统计信息
     mutable NetworkStats m_Stats;                // 网络统计
     mutable std::mutex m_StatsMutex;             // 统计互斥锁
+    LatencyStats m_LatencyStats;                 // 接收到分发延迟统计（由 m_StatsMutex 保护）
     
     // 多播组管理
     std::vector<std::string> m_JoinedGroups;     // 已加入的多播组列表
@@ -85,6 +85,16 @@ public:
     //   source - 激光源智能指针
     //==========================================================================
     void AddLaserSource(int deviceID, std::shared_ptr<Core::LaserSource> source);
+
+    //==========================================================================
+    // 函数：AddCompositeSource
+    // 描述：将额外的激光源（如区域流）合成到指定设备的纹理
+    //      渲染时与设备自身的激光源一起加法混合绘制
+    // 参数：
+    //   deviceID - 目标设备 ID（必须已通过 AddLaserSource 创建资源）
+    //   source - 激光源智能指针
+    //==========================================================================
+    void AddCompositeSource(int deviceID, std::shared_ptr<Core::LaserSource> source);
     
     //==========================================================================
     // 函数：RemoveLaserSource
@@ -192,28 +202,43 @@ private:
 
     //==========================================================================
     // 函数：RenderSource
-    // 描述：渲染单个激光源到其纹理
+    // 描述：渲染单个设备纹理（设备激光源及其合成源）
+    //      所有激光源的输出代数与上次渲染相同时跳过（纹理内容仍然有效）
     //      1. 上传顶点数据到 GPU
     //      2. 设置渲染状态和着色器
     //      3. 绘制点云（POINTLIST）
     //      4. 生成 Mipmap（可选）
     // 参数：
     //   deviceID - 设备 ID
+    //==========================================================================
+    void RenderSource(int deviceID);
+
+    //==========================================================================
+    // 函数：DrawSourcePoints
+    // 描述：上传并绘制一个激光源的处理后点数据到当前渲染目标
+    //      首次有点可画时绑定并清除渲染目标
+    // 参数：
+    //   deviceID - 目标纹理的设备 ID
     //   source - 激光源指针
+    //   targetBound - [输入/输出] 渲染目标是否已绑定并清除
+    //   oldRTV, oldDSV - [输出] 绑定前的渲染目标（用于恢复）
     //==========================================================================
-    void RenderSource(int deviceID, Core::LaserSource* source);
+    void DrawSourcePoints(int deviceID, Core::LaserSource* source,
+                          bool& targetBound,
+                          ID3D11RenderTargetView*& oldRTV, ID3D11DepthStencilView*& oldDSV);
 
     //==========================================================================
     // 函数：UploadVertexData
     // 描述：上传顶点数据到 GPU 动态缓冲区
     //      使用 MAP_WRITE_DISCARD 高效更新
     //      如果缓冲区不够大，会自动重新创建更大的缓冲区
+    //      SoA 帧在写入映射内存时转换为 LaserPoint 顶点布局
     // 参数：
-    //   points - 激光点列表
+    //   points - 激光点帧
     //   vertexBuffer - 顶点缓冲区（引用，可能会被重新创建）
     //   bufferCapacity - 缓冲区容量（引用，扩展时会更新）
     //==========================================================================
-    void UploadVertexData(const std::vector<Core::LaserPoint>& points, 
+    void UploadVertexData(const Core::LaserFrame& points, 
                           ID3D11Buffer*& vertexBuffer, 
                           size_t& bufferCapacity);
 
@@ -235,6 +260,7 @@ private:
     ID3D11VertexShader* m_VertexShader;          // 顶点着色器
     ID3D11PixelShader* m_PixelShader;            // 像素着色器
     ID3D11InputLayout* m_InputLayout;            // 输入布局
+    UINT m_VertexStride;                         // 顶点步长（LaserPoint 28 字节 / QuantizedVertex 12 字节）
 
     //==========================================================================
     // 结构体：SourceResources
@@ -247,6 +273,8 @@ private:
         ID3D11Buffer* VertexBuffer;              // 动态顶点缓冲区
         size_t VertexCapacity;                   // 顶点缓冲区容量
         std::shared_ptr<Core::LaserSource> Source;  // 激光源智能指针
+        std::vector<std::shared_ptr<Core::LaserSource>> CompositeSources;  // 合成到本纹理的额外激光源
+        uint64_t RenderedSignature;              // 纹理当前内容对应的渲染签名（0 表示需要重绘）
     };
     std::unordered_map<int, SourceResources> m_SourceResources;  // 设备ID → 资源映射
 
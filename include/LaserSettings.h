@@ -23,6 +23,14 @@ struct LaserSettings {
     //======================================================================
     int NetworkPort = 5568;                  // UDP 端口号（Beyond 默认端口）
     int MaxLaserDevices = 4;                 // 最大激光设备数量（0-3）
+    bool LowLatencyReceive = false;          // 低延迟接收模式（忙轮询）
+                                             // 接收线程在非阻塞 socket 上自旋，适合为接收独占一个 CPU 核心
+    int BusyPollBudgetMicroseconds = 200;    // 自旋预算（微秒）
+                                             // 超过预算仍无数据时回退为阻塞等待，避免空转
+    bool EnableZoneStreams = false;          // 按（设备, 子网）拆分独立激光源
+                                             // 239.255.X.Y 的每个子网 Y 对应 Beyond 的一个投影区域，各自独立处理
+    bool CompositeZoneStreams = true;        // 将同一设备的各区域流合成到设备纹理
+                                             // 关闭时每个区域流渲染到独立纹理
     
     //======================================================================
     // 渲染配置
@@ -32,6 +40,11 @@ struct LaserSettings {
                                              // 更高的分辨率提供更好的细节但消耗更多 GPU 资源
     bool EnableMipmaps = true;               // 是否生成 Mipmap 纹理链
                                              // 启用可提升远距离观看的视觉质量
+    bool QuantizedVertexUpload = false;      // 使用量化顶点格式上传（12 字节/点，默认 28 字节）
+                                             // 位置误差约 1.5e-5，颜色误差约 1/510（见 QuantizedPoint.h）
+    float LodPixelTolerance = 0.0f;          // 细节层次：合并落在同一输出像素网格单元内的连续样本（0 = 关闭）
+                                             // 1.0 时网格即纹理像素，合并后颜色累加，加法混合的亮度不变
+    float LodViewScale = 1.0f;               // 纹理的显示缩放（缩略图/预览 < 1），LOD 网格按显示像素计算
     
     //======================================================================
     // 扫描仪模拟
@@ -44,6 +57,29 @@ struct LaserSettings {
                                              // 根据扫描速度动态调整亮度，模拟真实效果
     float VelocitySmoothing = 0.83f;         // 速度平滑因子 [0.0, 1.0]
                                              // 更高的值产生更平滑的运动，模拟扫描仪惯性
+    enum class ScannerModel {
+        VelocitySmoothing,  // 速度平滑：每轴一阶速度递推（VelocitySmoothing），与扫描速率无关
+        Galvo               // 振镜：每轴二阶系统（固有频率、阻尼比），样本时长由扫描速率换算
+    };
+    ScannerModel ScannerResponse = ScannerModel::VelocitySmoothing;  // 扫描仪响应模型
+    float GalvoNaturalFrequency = 2500.0f;   // 振镜固有频率（Hz）
+    float GalvoDamping = 0.7f;               // 振镜阻尼比（< 1 时拐角处有过冲）
+    float ScanRateKpps = 30.0f;              // 扫描速率（千点/秒），每个原始点的时长为其倒数
+                                             // 振镜模型以预计算的截断脉冲响应做 FIR 卷积，不使用自适应插值
+    bool VectorizedEdgeFade = false;         // 边缘淡化使用向量化着色（递推与着色分两遍）
+                                             // 纯 float + rsqrt 运算，颜色相对误差 < 1e-6（见 ScannerPipeline.h）
+    bool AdaptiveSampling = false;           // 按段长自适应插值样本数（取代每段固定 SampleCount 个样本）
+                                             // 长段保持原密度，短段和零长度段（静止光束）只取少量样本
+    float AdaptivePixelSpacing = 2.0f;       // 自适应插值的目标样本间距（按 TextureSize 换算的像素）
+    int AdaptiveMinSamples = 1;              // 自适应插值每段最少样本数
+    int AdaptiveMaxSamples = 0;              // 自适应插值每段最多样本数（0 = SampleCount）
+    bool CullBlankSegments = false;          // 消隐段（两端点均为空白）只推进扫描仪递推，不输出样本
+                                             // 加法混合下空白点没有贡献，减少顶点上传与绘制（不模拟时不剔除）
+    float SimplifyPixelTolerance = 0.0f;     // 插值前的输入简化容差（按 TextureSize 换算的像素，0 = 关闭）
+                                             // Douglas-Peucker 移除共线的原始点；拐角、颜色/消隐变化、光束与驻留点保留
+                                             // 合并段按代表的原始段数取样，扫描时长与亮度不变；SampleCount <= 1 时不简化
+    int FramePointBudget = 0;                // 每帧所有激光源主点列表的总点数预算（0 = 不限制）
+                                             // 按设备优先级 × 点数需求分配，超出的激光源保留拐角、颜色与消隐变化后均匀抽取
     
     //======================================================================
     // 光束检测
@@ -71,12 +107,40 @@ struct LaserSettings {
         Ultra       // 超高质量：无降采样，适用于高端硬件
     };
     QualityLevel LaserQuality = QualityLevel::High;  // 默认质量级别
+    enum class InterpolationMode {
+        Linear,     // 线性：相邻点之间取弦上的样本
+        CatmullRom, // Catmull-Rom：节点切线取相邻两点差的一半（均匀参数化）
+        Hermite     // 三次 Hermite：节点切线按相邻段长加权，段长悬殊时过冲更小
+    };
+    InterpolationMode QualityInterpolation[4] = {  // 各质量级别（Low/Medium/High/Ultra）的插值方式
+        InterpolationMode::Linear, InterpolationMode::Linear,
+        InterpolationMode::Linear, InterpolationMode::Linear
+    };                                       // 三次插值以较少的 SampleCount 得到平滑曲线；拐角、消隐与光束处保持折线
     
     //======================================================================
     // 并行处理
     //======================================================================
-    bool EnableParallelProcessing = false;   // 启用多线程并行处理
-                                             // 实验性功能，可能提升多设备场景的性能
+    bool EnableParallelProcessing = false;   // 启用多设备并行处理
+                                             // 各激光源在常驻线程池上并行更新，工作窃取平衡点数不均的设备
+    bool ParallelScannerSimulation = false;  // 大帧的扫描仪模拟递推使用分块并行前缀扫描
+                                             // 与串行结果的差异在浮点舍入范围内（见 ScannerPipeline.h）
+    int ParallelScanMinSamples = 65536;      // 插值后样本数达到此值才并行扫描
+                                             // 小帧的线程同步开销大于收益
+    enum class ChunkSeeding {
+        Auto,       // 自动：预热窗口足够短时使用预热，否则使用精确进位
+        WarmUp,     // 预热窗口：各块从前方窗口以静止状态起步推进递推
+        ExactCarry  // 精确进位：仿射映射分块前缀扫描（多一遍整帧遍历）
+    };
+    ChunkSeeding ParallelScanSeeding = ChunkSeeding::Auto;  // 帧内分块的起始状态计算方式
+    int WorkerThreadCount = 0;               // 工作线程数（0 = 硬件线程数 - 1）
+    
+    //======================================================================
+    // 帧缓存
+    //======================================================================
+    bool EnableFrameCache = false;           // 启用帧内容缓存
+                                             // 相同帧跳过解码，重复帧（循环动画）跳过扫描仪模拟
+    int FrameCacheCapacity = 32;             // 每个激光源缓存的最大帧数（LRU 淘汰）
+                                             // 内存占用约为 帧数 × 处理后点数 × 28 字节 × 2（主点与光束点相同时 × 1）
 };
 
 } // namespace Core
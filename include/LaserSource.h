@@ -10,18 +10,38 @@
 
 #include "LaserPoint.h"
 #include "LaserSettings.h"
+#include "LaserFrame.h"
+#include "FrameCache.h"
+#include "HotBeam.h"
+#include "FrameArena.h"
+#include "ScannerPipeline.h"
 #include <vector>
 #include <memory>
 #include <mutex>
+#include <atomic>
 
 namespace BeyondLink {
 namespace Core {
 
+//==========================================================================
+// 结构体：FrameSnapshot
+// 描述：一次处理结果的不可变快照，由 UpdatePointList 原子发布
+//      读取方（渲染、统计、导出）无需持有激光源的锁，持有期间内容不变
+//==========================================================================
+struct FrameSnapshot {
+    uint64_t Generation = 0;                     // 输出代数（与 GetFrameGeneration 对应）
+    SharedFrame Processed;                       // 主点列表
+    SharedFrame Beam;                            // 光束点列表（仅登记了光束点需求时非空）
+};
+
+using SharedSnapshot = std::shared_ptr<const FrameSnapshot>;
+
 //==========================================================================
 // 类：LaserSource
 // 描述：单个激光设备的数据处理管线
 //      从网络接收原始激光点 → 扫描仪模拟 → 光束检测 → 准备渲染
 //      每个设备（0-3）对应一个 LaserSource 实例
+//      处理结果以不可变快照发布，渲染与统计通过 GetSnapshot() 无锁读取
 //==========================================================================
 class LaserSource {
 public:
@@ -51,10 +71,80 @@ public:
     //==========================================================================
     void SetPointList(std::vector<LaserPoint>&& points);
 
+    //==========================================================================
+    // 函数：IsFrameCacheEnabled
+    // 描述：帧缓存是否启用（无锁，接收线程据此决定是否对解码输出计算哈希）
+    //      随 SetSettings 更新，解码器不使用自己的配置副本
+    // 返回值：
+    //   true - 已启用
+    //==========================================================================
+    bool IsFrameCacheEnabled() const { return m_FrameCacheEnabled.load(std::memory_order_relaxed); }
+
+    //==========================================================================
+    // 函数：IsCurrentFrame
+    // 描述：检查帧哈希是否与当前原始帧相同（帧缓存启用时用于跳过解码）
+    //      相同时记录一次解码跳过
+    // 参数：
+    //   frameHash - 帧内容哈希（由解码器对 DLL 输出计算）
+    // 返回值：
+    //   true - 与当前原始帧相同，无需解码
+    //   false - 不同或帧缓存未启用
+    //==========================================================================
+    bool IsCurrentFrame(uint64_t frameHash);
+
+    //==========================================================================
+    // 函数：BeginInboundFrame
+    // 描述：获取接收缓冲的可写视图，解码器直接将转换后的点写入各通道
+    //      接收缓冲只由单个生产者（网络接收线程）访问，写入期间无需加锁
+    // 参数：
+    //   pointCount - 本帧点数量
+    // 返回值：
+    //   可写入 pointCount 个点的帧视图
+    //==========================================================================
+    MutableFrameView BeginInboundFrame(size_t pointCount);
+
+    //==========================================================================
+    // 函数：CommitInboundFrame
+    // 描述：发布接收缓冲中的帧（加锁交换为原始点列表，不拷贝点数据）
+    //      旧的原始点列表成为下一帧的接收缓冲，复用其容量
+    // 参数：
+    //   frameHash - 帧内容哈希（0 表示未知，帧缓存启用时会自行计算）
+    //==========================================================================
+    void CommitInboundFrame(uint64_t frameHash = 0);
+
+    //==========================================================================
+    // 函数：SetSettings
+    // 描述：更新系统配置参数；影响处理结果的字段变化时递增设置版本，下次 UpdatePointList 时重新处理
+    // 参数：
+    //   settings - 新的配置参数
+    //==========================================================================
+    void SetSettings(const LaserSettings& settings);
+
+    //==========================================================================
+    // 枚举：OutputList
+    // 描述：按需计算的输出列表（主点列表始终计算）
+    //==========================================================================
+    enum OutputList : uint32_t {
+        OutputBeam = 0x01,                       // 光束点列表
+        OutputHotBeam = 0x02                     // 高强度光束游程
+    };
+
+    //==========================================================================
+    // 函数：RegisterOutputInterest / UnregisterOutputInterest
+    // 描述：登记/取消对输出列表的持续需求
+    //      已登记的列表在 UpdatePointList 中随主点列表一起计算；
+    //      未登记的列表在其获取函数首次调用时按当前帧计算，结果缓存到下次更新
+    // 参数：
+    //   outputs - OutputList 标志组合
+    //==========================================================================
+    void RegisterOutputInterest(uint32_t outputs);
+    void UnregisterOutputInterest(uint32_t outputs);
+
     //==========================================================================
     // 函数：UpdatePointList
     // 描述：更新处理点列表，应用扫描仪模拟和光束检测
     //      通常在每帧调用，将原始点转换为可渲染的点
+    //      输入帧代数、设置版本和模拟开关都未变化时直接返回（空操作）
     // 参数：
     //   enableScannerSim - 是否启用扫描仪模拟
     //==========================================================================
@@ -62,35 +152,102 @@ public:
 
     //==========================================================================
     // 函数：GetProcessedPoints
-    // 描述：获取处理后的主点列表（用于渲染）
+    // 描述：获取处理后的主点列表（SoA 布局，调用方持有 GetMutex() 锁；无锁读取使用 GetSnapshot()）
     // 返回值：
-    //   处理后的激光点列表的常量引用
+    //   处理后的激光帧的常量引用
     //==========================================================================
-    const std::vector<LaserPoint>& GetProcessedPoints() const { return m_ProcessedPoints; }
+    const LaserFrame& GetProcessedPoints() const { return *m_ProcessedFrame; }
+    
+    //==========================================================================
+    // 函数：GetProcessedFrame
+    // 描述：获取处理后主点列表的共享帧（不可变，持有期间内容不变，可在释放锁后继续读取）
+    // 返回值：
+    //   共享帧
+    //==========================================================================
+    SharedFrame GetProcessedFrame() const { return m_ProcessedFrame; }
     
     //==========================================================================
     // 函数：GetBeamPoints
-    // 描述：获取光束点列表
+    // 描述：获取光束点列表（未登记需求时按需计算，调用方与读取主点列表一样持有 GetMutex() 锁）
+    // 返回值：
+    //   光束点帧的常量引用
+    //==========================================================================
+    const LaserFrame& GetBeamPoints() { EvaluateBeamPoints(); return *m_BeamFrame; }
+    
+    //==========================================================================
+    // 函数：GetBeamFrame
+    // 描述：获取光束点列表的共享帧（与主点列表或原始帧相同时为同一缓冲）
     // 返回值：
-    //   光束点列表的常量引用
+    //   共享帧
     //==========================================================================
-    const std::vector<LaserPoint>& GetBeamPoints() const { return m_BeamPoints; }
+    SharedFrame GetBeamFrame() { EvaluateBeamPoints(); return m_BeamFrame; }
+    
+    //==========================================================================
+    // 函数：GetHotBeams
+    // 描述：获取高强度光束游程列表（每条静止光束一条记录，可直接用于实例化渲染）
+    //      未登记需求时按需检测
+    // 返回值：
+    //   光束游程列表的常量引用
+    //==========================================================================
+    const std::vector<HotBeamRun>& GetHotBeams() { EvaluateHotBeams(); return m_HotBeams; }
     
     //==========================================================================
     // 函数：GetHotBeamPoints
-    // 描述：获取高强度光束点列表（静止光束的增强渲染）
+    // 描述：获取展开后的高强度光束点列表（首次调用时由游程展开，结果缓存到下次更新）
+    // 返回值：
+    //   高强度光束点帧的常量引用
+    //==========================================================================
+    const LaserFrame& GetHotBeamPoints();
+
+    //==========================================================================
+    // 函数：GetSnapshot
+    // 描述：获取最近发布的处理结果快照（任意线程，不获取激光源的锁，不阻塞处理）
+    // 返回值：
+    //   快照（代数不小于调用前读到的 GetFrameGeneration）
+    //==========================================================================
+    SharedSnapshot GetSnapshot() const { return std::atomic_load_explicit(&m_Snapshot, std::memory_order_acquire); }
+
+    //==========================================================================
+    // 函数：GetFrameGeneration
+    // 描述：获取输出代数，处理结果每次变化时递增（在快照发布之后递增）
+    //      渲染器据此判断是否需要重新上传顶点数据
+    // 返回值：
+    //   输出代数（0 表示尚未产生过输出）
+    //==========================================================================
+    uint64_t GetFrameGeneration() const { return m_FrameGeneration.load(std::memory_order_acquire); }
+
+    //==========================================================================
+    // 函数：GetInputPointCount
+    // 描述：获取当前原始帧的点数量（无锁，用于估算处理代价）
+    // 返回值：
+    //   点数量
+    //==========================================================================
+    size_t GetInputPointCount() const { return m_InputPointCount.load(std::memory_order_relaxed); }
+
+    //==========================================================================
+    // 函数：GetPointDemand
+    // 描述：获取最近一次处理在点预算抽取前的主点数量（无锁，用于分配点预算）
     // 返回值：
-    //   高强度光束点列表的常量引用
+    //   点数量（尚未处理过时为 0）
+    //==========================================================================
+    size_t GetPointDemand() const { return m_PointDemand.load(std::memory_order_relaxed); }
+
+    //==========================================================================
+    // 函数：SetPointBudget
+    // 描述：设置主点列表的点数预算，超出时按重要性抽取（见 ScannerPipeline::DecimateToBudget）
+    //      预算变化时下次 UpdatePointList 重新处理当前帧
+    // 参数：
+    //   budget - 点数预算（0 表示不限制）
     //==========================================================================
-    const std::vector<LaserPoint>& GetHotBeamPoints() const { return m_HotBeamPoints; }
+    void SetPointBudget(size_t budget);
 
     //==========================================================================
     // 函数：GetPointCount
-    // 描述：获取处理后的点数量
+    // 描述：获取处理后的点数量（读取快照，无锁）
     // 返回值：
     //   点数量
     //==========================================================================
-    size_t GetPointCount() const { return m_ProcessedPoints.size(); }
+    size_t GetPointCount() const { return GetSnapshot()->Processed->Size(); }
     
     //==========================================================================
     // 函数：GetBeamPointCount
@@ -98,7 +255,7 @@ public:
     // 返回值：
     //   光束点数量
     //==========================================================================
-    size_t GetBeamPointCount() const { return m_BeamPoints.size(); }
+    size_t GetBeamPointCount() { return GetBeamPoints().Size(); }
     
     //==========================================================================
     // 函数：GetHotBeamPointCount
@@ -106,7 +263,7 @@ public:
     // 返回值：
     //   高强度光束点数量
     //==========================================================================
-    size_t GetHotBeamPointCount() const { return m_HotBeamPoints.size(); }
+    size_t GetHotBeamPointCount() { return CountHotBeamPoints(GetHotBeams()); }
 
     //==========================================================================
     // 函数：GetDeviceID
@@ -135,7 +292,46 @@ public:
     // 描述：获取/设置光束画刷是否启用
     //==========================================================================
     bool IsBeamBrushEnabled() const { return m_EnableBeamBrush; }
-    void SetBeamBrushEnabled(bool enabled) { m_EnableBeamBrush = enabled; }
+    void SetBeamBrushEnabled(bool enabled) {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_EnableBeamBrush != enabled) {
+            m_EnableBeamBrush = enabled;
+            m_SettingsVersion++;
+        }
+    }
+
+    //==========================================================================
+    // 函数：SetWorkerPool
+    // 描述：设置分块并行扫描使用的线程池（ParallelScannerSimulation 启用时生效）
+    //      线程池由 BeyondLinkSystem 持有，生命周期长于激光源
+    // 参数：
+    //   pool - 线程池（nullptr 表示单线程处理）
+    //==========================================================================
+    void SetWorkerPool(WorkerPool* pool);
+
+    //==========================================================================
+    // 函数：GetFrameCacheStats
+    // 描述：获取帧缓存统计信息（未启用时全部为 0）
+    // 返回值：
+    //   帧缓存统计
+    //==========================================================================
+    FrameCacheStats GetFrameCacheStats() const;
+
+    //==========================================================================
+    // 函数：GetArenaPeakBytes
+    // 描述：获取帧内存池的单帧峰值用量（中间结果占用的内存）
+    // 返回值：
+    //   峰值字节数
+    //==========================================================================
+    size_t GetArenaPeakBytes() const;
+
+    //==========================================================================
+    // 函数：GetPipelineStats
+    // 描述：获取扫描仪模拟处理统计（累计样本数与消隐剔除数）
+    // 返回值：
+    //   处理统计
+    //==========================================================================
+    ScannerPipelineStats GetPipelineStats() const;
 
     //==========================================================================
     // 函数：GetMutex
@@ -147,77 +343,110 @@ public:
 
 private:
     //==========================================================================
-    // 函数：ApplyScannerSimulation
-    // 描述：应用扫描仪物理模拟（惯性、速度平滑、边缘淡化）
-    // 参数：
-    //   points - 输入点列表
-    // 返回值：
-    //   模拟后的点列表
+    // 函数：EvaluateBeamPoints
+    // 描述：当前输出未包含光束点列表时计算光束点列表
+    //      与原始帧或主点列表相同时共享其缓冲，否则以光束输出重新运行处理实例
     //==========================================================================
-    std::vector<LaserPoint> ApplyScannerSimulation(const std::vector<LaserPoint>& points);
+    void EvaluateBeamPoints();
     
     //==========================================================================
-    // 函数：InterpolatePoints
-    // 描述：在相邻点之间插值，增加点密度以提升渲染平滑度
-    // 参数：
-    //   points - 输入点列表
-    //   sampleCount - 每对点之间插入的样本数
+    // 函数：ShareBeamPoints
+    // 描述：光束点列表与原始帧或主点列表内容相同时共享其缓冲
     // 返回值：
-    //   插值后的点列表
+    //   已共享返回 true
     //==========================================================================
-    std::vector<LaserPoint> InterpolatePoints(const std::vector<LaserPoint>& points, int sampleCount);
+    bool ShareBeamPoints();
     
     //==========================================================================
-    // 函数：DownsamplePoints
-    // 描述：按指定倍数降采样点列表（根据质量设置）
-    // 参数：
-    //   points - 输入点列表
-    //   factor - 降采样倍数（1=无降采样，2=保留一半，8=保留1/8）
-    // 返回值：
-    //   降采样后的点列表
+    // 函数：ReleaseOutputAliases
+    // 描述：解除输出列表之间及与原始帧的共享（写入新输出前调用）
     //==========================================================================
-    std::vector<LaserPoint> DownsamplePoints(const std::vector<LaserPoint>& points, int factor);
+    void ReleaseOutputAliases();
     
     //==========================================================================
-    // 函数：GenerateHotBeams
-    // 描述：检测并生成高强度光束点（用于静止光束的增强渲染）
-    //      识别连续重复的点位置，生成额外的高亮点
+    // 函数：PublishSnapshot
+    // 描述：发布当前输出的快照，随后递增输出代数
     // 参数：
-    //   points - 输入点列表
+    //   includeBeam - 快照是否包含光束点列表
     //==========================================================================
-    void GenerateHotBeams(const std::vector<LaserPoint>& points);
+    void PublishSnapshot(bool includeBeam);
     
     //==========================================================================
-    // 函数：RemoveDuplicatePoints
-    // 描述：移除连续重复的点（用于 BeamBrush 模式优化）
+    // 函数：EvaluateHotBeams
+    // 描述：当前输出未包含高强度光束游程时检测静止光束
+    //==========================================================================
+    void EvaluateHotBeams();
+    
+    //==========================================================================
+    // 函数：GenerateHotBeams
+    // 描述：检测静止光束并生成高强度光束游程（用于静止光束的增强渲染）
+    //      识别连续重复的点位置，每条光束记录一条游程
     // 参数：
     //   points - 输入点列表
-    // 返回值：
-    //   去重后的点列表
     //==========================================================================
-    std::vector<LaserPoint> RemoveDuplicatePoints(const std::vector<LaserPoint>& points);
+    void GenerateHotBeams(const LaserFrame& points);
     
     //==========================================================================
-    // 函数：SmoothVector
-    // 描述：平滑二维向量（用于速度向量的惯性模拟）
+    // 函数：HashRawPoints
+    // 描述：计算原始点列表的内容哈希（帧缓存未启用时返回 0）
     // 参数：
-    //   currentX, currentY - 当前向量（将被修改）
-    //   targetX, targetY - 目标向量
-    //   smoothing - 平滑因子 [0.0, 1.0]
+    //   points - 原始点列表
+    // 返回值：
+    //   帧内容哈希
     //==========================================================================
-    void SmoothVector(float& currentX, float& currentY, 
-                      float targetX, float targetY, 
-                      float smoothing);
+    uint64_t HashRawPoints(const LaserFrame& points) const;
 
 private:
     int m_DeviceID;                              // 设备 ID (0-3)
     LaserSettings m_Settings;                    // 系统配置参数
     
-    // 点数据缓冲
-    std::vector<LaserPoint> m_RawPoints;         // 原始接收的点
-    std::vector<LaserPoint> m_ProcessedPoints;   // 处理后的主点列表
-    std::vector<LaserPoint> m_BeamPoints;        // 光束点列表
-    std::vector<LaserPoint> m_HotBeamPoints;     // 高强度光束点
+    // 点数据缓冲（SoA 布局，引用计数共享，独占时跨帧复用容量）
+    SharedFrame m_RawFrame;                      // 原始接收的点
+    SharedFrame m_InboundFrame;                  // 接收缓冲（解码器直接写入，提交时与 m_RawFrame 交换）
+    SharedFrame m_ProcessedFrame;                // 处理后的主点列表（不模拟且不去重时共享原始帧）
+    SharedFrame m_BeamFrame;                     // 光束点列表（与原始帧或主点列表相同时共享）
+    SharedFrame m_SpareProcessedFrame;           // 上一帧的主点缓冲（已发布的快照释放后复用）
+    SharedFrame m_SpareBeamFrame;                // 上一帧的光束点缓冲
+    SharedSnapshot m_Snapshot;                   // 最近发布的快照（原子读写）
+    std::vector<HotBeamRun> m_HotBeams;          // 高强度光束游程
+    LaserFrame m_HotBeamPoints;                  // 高强度光束游程的展开缓存（按需生成）
+    LaserFrame m_BeamScratch;                    // 处理实例的丢弃输出（不需要的光束点或按需计算时的主点）
+    
+    // 按需输出
+    uint32_t m_OutputInterest;                   // 已登记需求的输出列表（OutputList 标志）
+    bool m_BeamPointsValid;                      // 光束点列表与当前输出一致
+    bool m_HotBeamsValid;                        // 高强度光束游程与当前输出一致
+    bool m_HotBeamPointsExpanded;                // 展开缓存与当前游程一致
+    
+    // 代数跟踪（脏标记）
+    uint64_t m_InputGeneration;                  // 输入帧代数（每次发布原始帧递增）
+    uint64_t m_SettingsVersion;                  // 处理参数版本（影响处理结果的设置变化时递增）
+    uint64_t m_ProcessedInputGeneration;         // 当前输出对应的输入帧代数
+    uint64_t m_ProcessedSettingsVersion;         // 当前输出对应的处理参数版本
+    bool m_ProcessedScannerSim;                  // 当前输出对应的扫描仪模拟开关
+    std::atomic<uint64_t> m_FrameGeneration;     // 输出代数（处理结果变化时递增）
+    std::atomic<size_t> m_InputPointCount;       // 当前原始帧点数（调度用，无锁读取）
+    
+    // 点预算
+    size_t m_PointBudget;                        // 主点列表点数预算（0 表示不限制）
+    size_t m_ProcessedPointBudget;               // 当前输出对应的点数预算
+    std::atomic<size_t> m_PointDemand;           // 最近一次处理抽取前的主点数（无锁读取）
+    
+    // 帧内存池（插值/模拟等中间结果，每次处理开始时重置）
+    FrameArena m_Arena;
+    
+    // 特化处理实例（处理参数变化时重新选择）
+    ScannerPipelineParams m_PipelineParams;      // 当前实例对应的处理参数
+    ScannerPipelineFunc m_Pipeline;              // 当前特化处理函数
+    uint64_t m_PipelineSettingsVersion;          // 当前实例对应的处理参数版本
+    WorkerPool* m_WorkerPool;                    // 分块并行扫描线程池（不持有）
+    ScannerPipelineStats m_PipelineStats;        // 处理统计（按需计算的光束点不计入）
+    
+    // 帧缓存
+    std::unique_ptr<FrameCache> m_FrameCache;    // 处理结果缓存（未启用时为空，由 m_Mutex 保护）
+    std::atomic<bool> m_FrameCacheEnabled;       // 帧缓存启用标志（接收线程无锁读取）
+    uint64_t m_RawFrameHash;                     // 当前原始帧内容哈希（0 表示未知）
+    uint64_t m_OutputKey;                        // 当前处理结果对应的缓存键（0 表示无）
     
     // 渲染参数
     float m_LineWidth;                           // 线宽
@@ -229,6 +458,9 @@ private:
     
     // 缓冲容量管理
     static constexpr size_t InitialCapacity = 10000;  // 初始缓冲容量
+    
+    // 原始点列表哈希种子（与解码器的 DLL 输出哈希区分）
+    static constexpr uint64_t RawPointHashSeed = 0x4C61736572507473ull;
 };
 
 } // namespace Core
@@ -0,0 +1,111 @@
+﻿//==============================================================================
+// 文件：QuantizedPoint.h
+// 作者：Yunsio
+// 日期：2025-10-06
+// 描述：量化激光点格式（10 字节）及 SIMD 打包/解包
+//      用于线程间队列、录制文件和可选的紧凑顶点输入布局
+//==============================================================================
+
+#pragma once
+
+#include "LaserPoint.h"
+#include "LaserFrame.h"
+#include <cstdint>
+#include <cstddef>
+
+namespace BeyondLink {
+namespace Core {
+
+//==========================================================================
+// 结构体：QuantizedPoint
+// 描述：量化激光点（10 字节，LaserPoint 为 28 字节）
+//      X/Y   - int16 SNORM，范围 [-1, 1]（超出部分截断）
+//      R/G/B - uint8 UNORM，相对于 Gain 的颜色
+//      Focus - uint8 UNORM，范围 [0, 1]
+//      Extra - 光束点：Z 的 UNORM8 值（Z > 0 时至少为 1，保留光束标记）
+//              非光束点：颜色增益，Gain = 1 + Extra × 3/255，范围 [1, 4]
+//              扫描仪模拟的边缘淡化强度可达 4，颜色因此可能超过 1
+//      Flags - 标志位（见 QuantizedFlags）
+//
+//      误差上界（相对浮点路径）：
+//      X/Y   ≤ 1/65534（≈1.5e-5），[-1, 1] 之外截断到边界
+//      R/G/B ≤ Gain/510（Gain 为量化后的增益），颜色不超过 1 时 ≤ 1/510
+//            Beyond 的 8 位颜色（n/255）无损；超过 4 的颜色截断为 4
+//      Focus ≤ 1/510
+//      Z     ≤ 1/510，小于 1/510 的正值提升为 1/255（光束标记始终保持）
+//==========================================================================
+#pragma pack(push, 1)
+struct QuantizedPoint {
+    int16_t X;          // X 坐标（SNORM16）
+    int16_t Y;          // Y 坐标（SNORM16）
+    uint8_t R;          // 红色（UNORM8，乘以增益）
+    uint8_t G;          // 绿色（UNORM8，乘以增益）
+    uint8_t B;          // 蓝色（UNORM8，乘以增益）
+    uint8_t Focus;      // 聚焦值（UNORM8）
+    uint8_t Extra;      // 光束点为 Z，否则为颜色增益
+    uint8_t Flags;      // 标志位
+};
+#pragma pack(pop)
+
+static_assert(sizeof(QuantizedPoint) == 10, "QuantizedPoint must be 10 bytes");
+
+//==========================================================================
+// 枚举：QuantizedFlags
+// 描述：QuantizedPoint::Flags 的标志位
+//==========================================================================
+enum QuantizedFlags : uint8_t {
+    QuantizedBeam = 0x01,       // 光束点（Z > 0），Extra 为 Z
+    QuantizedBlank = 0x02,      // 空白点（无可见颜色）
+    QuantizedOverdrive = 0x04   // 颜色超过 1，Extra 为增益
+};
+
+//==========================================================================
+// 结构体：QuantizedVertex
+// 描述：GPU 顶点格式（QuantizedPoint + 2 字节填充 = 12 字节）
+//      步长补齐到 4 字节，保证每个输入元素都按 4 字节对齐
+//      输入布局：R16G16_SNORM @0，R8G8B8A8_UNORM @4，R8G8_UINT @8
+//==========================================================================
+struct QuantizedVertex {
+    QuantizedPoint Point;
+    uint16_t Padding;
+};
+
+static_assert(sizeof(QuantizedVertex) == 12, "QuantizedVertex must be 12 bytes");
+
+//==========================================================================
+// 函数：QuantizePoint / DequantizePoint
+// 描述：单点量化/反量化（标量版本，与 SIMD 版本结果一致）
+//==========================================================================
+QuantizedPoint QuantizePoint(const LaserPoint& point);
+LaserPoint DequantizePoint(const QuantizedPoint& point);
+
+//==========================================================================
+// 函数：PackQuantizedPoints
+// 描述：将帧量化为 QuantizedPoint 数组（SSE2 每次处理 4 个点）
+// 参数：
+//   frame - 输入帧视图
+//   points - [输出] 量化点数组（至少 frame.Count 个）
+//==========================================================================
+void PackQuantizedPoints(const FrameView& frame, QuantizedPoint* points);
+
+//==========================================================================
+// 函数：PackQuantizedVertices
+// 描述：将帧量化为 12 字节 GPU 顶点（渲染上传使用）
+// 参数：
+//   frame - 输入帧视图
+//   vertices - [输出] 顶点数组（至少 frame.Count 个）
+//==========================================================================
+void PackQuantizedVertices(const FrameView& frame, QuantizedVertex* vertices);
+
+//==========================================================================
+// 函数：UnpackQuantizedPoints
+// 描述：将量化点数组还原到帧的各通道（SSE2 每次处理 4 个点）
+// 参数：
+//   points - 量化点数组
+//   count - 点数量
+//   frame - [输出] 帧（调整为 count 个点）
+//==========================================================================
+void UnpackQuantizedPoints(const QuantizedPoint* points, size_t count, LaserFrame& frame);
+
+} // namespace Core
+} // namespace BeyondLink
@@ -0,0 +1,350 @@
+﻿//==============================================================================
+// 文件：ScannerPipeline.h
+// 作者：Yunsio
+// 日期：2025-10-06
+// 描述：扫描仪模拟流式处理引擎
+//      插值、速度/位置递推、边缘淡化和降采样在一次遍历中完成
+//      只计算并输出质量等级保留的样本，结果与逐步物化的处理路径逐位一致
+//==============================================================================
+
+#pragma once
+
+#include "LaserFrame.h"
+#include "LaserSettings.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace BeyondLink {
+namespace Core {
+
+class WorkerPool;
+class FrameArena;
+
+//==========================================================================
+// 结构体：ScannerPipelineStats
+// 描述：扫描仪模拟处理统计（累计值）
+//==========================================================================
+struct ScannerPipelineStats {
+    uint64_t Samples = 0;                        // 递推样本数（插值后）
+    uint64_t CulledSamples = 0;                  // 消隐段中只推进递推、未输出的样本数
+    uint64_t MergedSamples = 0;                  // LOD 合并到同一像素的主点样本数
+    uint64_t InputPoints = 0;                    // 扫描仪模拟的原始点数（简化前）
+    uint64_t SimplifiedPoints = 0;               // 输入简化移除的原始点数
+    uint64_t BudgetDroppedPoints = 0;            // 点预算抽取掉的主点数
+    
+    //==========================================================================
+    // 函数：Merge
+    // 描述：累加另一组统计（用于多个激光源汇总）
+    // 参数：
+    //   other - 另一组统计
+    //==========================================================================
+    void Merge(const ScannerPipelineStats& other) {
+        Samples += other.Samples;
+        CulledSamples += other.CulledSamples;
+        MergedSamples += other.MergedSamples;
+        InputPoints += other.InputPoints;
+        SimplifiedPoints += other.SimplifiedPoints;
+        BudgetDroppedPoints += other.BudgetDroppedPoints;
+    }
+    
+    //==========================================================================
+    // 函数：GetCulledRatio
+    // 描述：计算消隐剔除比例
+    // 返回值：
+    //   剔除样本占递推样本的比例 [0.0, 1.0]，无样本时为 0
+    //==========================================================================
+    double GetCulledRatio() const {
+        return Samples > 0 ? static_cast<double>(CulledSamples) / static_cast<double>(Samples) : 0.0;
+    }
+    
+    //==========================================================================
+    // 函数：GetSimplifiedRatio
+    // 描述：计算输入简化移除的原始点比例
+    // 返回值：
+    //   移除点数占原始点数的比例 [0.0, 1.0]，无原始点时为 0
+    //==========================================================================
+    double GetSimplifiedRatio() const {
+        return InputPoints > 0 ? static_cast<double>(SimplifiedPoints) / static_cast<double>(InputPoints) : 0.0;
+    }
+};
+
+//==========================================================================
+// 结构体：GalvoResponse
+// 描述：二阶振镜模型（每轴 y'' + 2ζω·y' + ω²·y = ω²·u）按样本时长零阶保持精确离散化的结果
+//      状态为（位置, 速度），s[n+1] = Φ·s[n] + Γ·u[n]，位置输出 y[n] = Σ h[j]·u[n-1-j]
+//==========================================================================
+struct GalvoResponse {
+    double Transition[4] = {};                   // 状态转移矩阵 Φ = exp(A·Δt)（行优先）
+    double Input[2] = {};                        // 输入向量 Γ = A⁻¹·(Φ - I)·B
+    std::vector<float> Taps;                     // 截断脉冲响应 h[j] = [1 0]·Φʲ·Γ（和归一化为 1；为空时不使用振镜模型）
+    double TailMass = 0.0;                       // 截断丢弃部分的 Σ|h[j]|（卷积与直接递推的位置差约为其 3 倍以内）
+};
+
+//==========================================================================
+// 结构体：ScannerPipelineParams
+// 描述：流式处理参数
+//==========================================================================
+struct ScannerPipelineParams {
+    int SampleCount = 8;                         // 每段插值样本数（<= 1 时不插值）
+    bool AdaptiveSampling = false;               // 按段长自适应样本数（SampleCount > 1 时有效）
+                                                 // 每段 d = clamp(ceil(段长 / 间距), 最少, 最多) 个样本，t = s / d（s < d，帧末段含终点）
+                                                 // 递推按段时长换算（α' = 1 - 平滑因子^(S/d)，步长 × S/d），淡化样本颜色 × S/d
+                                                 // 总样本数不超过 (N-1) × 最多样本数 + 1；分块并行扫描只使用预热窗口起始状态
+    float AdaptiveSpacing = 0.0f;                // 自适应插值的目标样本间距（原始坐标单位）
+    int AdaptiveMinSamples = 1;                  // 自适应插值每段最少样本数
+    int AdaptiveMaxSamples = 8;                  // 自适应插值每段最多样本数
+    LaserSettings::InterpolationMode Interpolation = LaserSettings::InterpolationMode::Linear;  // 样本位置的插值方式
+                                                 // 三次插值的位置见 GetSamplePosition，颜色、Z 和聚焦仍为线性；切线在处理前按段批量计算
+    float SimplifyTolerance = 0.0f;              // 插值前的输入简化容差（原始坐标单位，0 = 不简化，仅扫描仪模拟且 SampleCount > 1）
+                                                 // 内核处理简化后的点（见 SimplifyPoints），使用自适应样本数实例：
+                                                 // 代表 k 个原始段的合并段取 k 倍的样本数上下限（固定模式为 S × k）和 k 倍时长，
+                                                 // 扫描速度、淡化亮度和振镜的样本周期与不简化时相同
+    float VelocitySmoothing = 0.83f;             // 速度平滑因子
+    GalvoResponse Galvo;                         // 振镜模型（Taps 非空时取代速度平滑递推）
+                                                 // 物化全部插值样本后做 FIR 卷积（见 ConvolveTaps），分块并行时与单线程逐位一致；
+                                                 // 速度取相邻样本位移 / 步长，静止样本按强度上限着色；消隐段剔除只跳过输出
+    float EdgeFade = 0.1f;                       // 边缘淡化因子（内部下限 0.1）
+    int ProcessedFactor = 2;                     // 主点列表降采样倍数
+    int BeamFactor = 2;                          // 光束点列表降采样倍数
+    bool ScannerSimulation = true;               // 启用扫描仪模拟（关闭时直接输出原始点）
+    bool BeamBrush = false;                      // 主点列表移除连续重复位置
+    bool BeamOutput = true;                      // 输出光束点列表（关闭时光束点输出为空）
+    bool CullBlankSegments = false;              // 消隐段只推进递推，不输出样本（仅扫描仪模拟）
+                                                 // 输出等于不剔除时的输出去掉这些样本（降采样的取样位置不变）
+    float LodCellsPerUnit = 0.0f;                // 主点 LOD 网格密度（每单位坐标的单元数，0 = 不合并，仅扫描仪模拟）
+                                                 // 主点列表最后经过 MergePixelRuns
+    float LodMaxColor = 4.0f;                    // LOD 合并后颜色通道的上限（量化顶点上传时为 4）
+    WorkerPool* Pool = nullptr;                  // 分块并行扫描使用的线程池（为空时单线程）
+                                                 // 大帧按原始段分块，按样本序号拼接；与串行的差异只来自块起点误差，并随递推逐样本衰减
+                                                 // 默认平滑因子下逐位一致，平滑因子 0.999 时位置误差 < 1e-5（单位坐标），颜色误差 < 1e-4
+    size_t ParallelMinSamples = 65536;           // 插值后样本数达到此值才并行扫描
+    LaserSettings::ChunkSeeding Seeding = LaserSettings::ChunkSeeding::Auto;  // 分块起始状态计算方式
+                                                 // 预热窗口从前方窗口静止起步推进递推，精确进位由仿射映射得到块起点
+    bool VectorizedShading = false;              // 递推只记录速度，边缘淡化由 SIMD 着色统一计算
+                                                 // 串行递推只记录保留样本的速度，随后统一着色（见 ShadeSamples），颜色相对误差 < 1e-6
+    FrameArena* Arena = nullptr;                 // 着色暂存使用的帧内存池（为空时使用临时缓冲）
+    ScannerPipelineStats* Stats = nullptr;       // 处理统计（为空时不统计）
+    
+    //==========================================================================
+    // 函数：FromSettings
+    // 描述：由系统配置生成处理参数（降采样倍数取决于质量等级）
+    // 参数：
+    //   settings - 系统配置
+    //   scannerSimulation - 是否启用扫描仪模拟
+    //   beamBrush - 是否启用光束画刷
+    // 返回值：
+    //   处理参数
+    //==========================================================================
+    static ScannerPipelineParams FromSettings(const LaserSettings& settings,
+                                              bool scannerSimulation, bool beamBrush);
+    
+    //==========================================================================
+    // 函数：IsBeamSameAsProcessed
+    // 描述：光束点列表是否与主点列表逐点相同（不去重，且不模拟或两者降采样倍数相同）
+    //      相同时只需计算主点列表，光束点列表共用同一缓冲（LOD 只作用于主点列表）
+    //==========================================================================
+    bool IsBeamSameAsProcessed() const {
+        return !BeamBrush && (!ScannerSimulation || (ProcessedFactor == BeamFactor && LodCellsPerUnit <= 0.0f));
+    }
+};
+
+//==========================================================================
+// 类型：ScannerPipelineFunc
+// 描述：特化的处理函数（由 ScannerPipeline::Select 选择）
+//==========================================================================
+using ScannerPipelineFunc = void (*)(const FrameView& raw, const ScannerPipelineParams& params,
+                                     LaserFrame& processed, LaserFrame& beam);
+
+//==========================================================================
+// 类：ScannerPipeline
+// 描述：融合的扫描仪模拟处理器（无状态）
+//      - 插值样本按需生成，不物化 (N-1) × SampleCount 数组
+//      - 递推对每个样本推进，但强度、颜色和 Z 只对保留的样本计算
+//      - 主点与光束点在同一遍历中输出，内存占用与输出规模成正比；
+//        不需要光束点时（BeamOutput 关闭）只写主点
+//      - 按（降采样倍数, 样本数类别, 光束画刷, 扫描仪模拟）编译期特化，
+//        设置变化时通过 Select 选择一次，内层循环使用常量步长且无死分支
+//==========================================================================
+class ScannerPipeline {
+public:
+    //==========================================================================
+    // 枚举：SimdLevel
+    // 描述：向量化运算的实现级别（处理实例按 CPU 支持自动选择，测试可指定级别对照）
+    //==========================================================================
+    enum class SimdLevel {
+        Auto,       // 按 CPU 支持选择最高级别
+        Scalar,     // 标量实现
+        SSE,        // SSE（4 通道）
+        AVX         // AVX（8 通道，运行时检测 CPU 支持）
+    };
+
+    //==========================================================================
+    // 函数：GetSampleCount
+    // 描述：计算固定样本数插值后的样本总数
+    // 参数：
+    //   pointCount - 原始点数量
+    //   sampleCount - 每段插值样本数
+    // 返回值：
+    //   样本总数
+    //==========================================================================
+    static size_t GetSampleCount(size_t pointCount, int sampleCount);
+
+    //==========================================================================
+    // 函数：Select
+    // 描述：选择与参数匹配的特化处理函数
+    //      降采样倍数为 1/2/4/8 的组合和 SampleCount = 8 有专用实例，自适应插值使用独立实例，
+    //      不输出光束点时只按主点降采样倍数特化，其他参数使用运行时通用实例
+    // 参数：
+    //   params - 处理参数
+    // 返回值：
+    //   特化的处理函数
+    //==========================================================================
+    static ScannerPipelineFunc Select(const ScannerPipelineParams& params);
+
+    //==========================================================================
+    // 函数：GetVariantName
+    // 描述：获取参数对应的特化实例名称（用于日志和性能测试）
+    // 参数：
+    //   params - 处理参数
+    // 返回值：
+    //   实例名称，例如 "sim/p2b2/s8" 或 "passthrough/brush"
+    //==========================================================================
+    static std::string GetVariantName(const ScannerPipelineParams& params);
+
+    //==========================================================================
+    // 函数：GetSamplePosition
+    // 描述：原始段 segment 上参数 t 处的插值位置（与处理实例的运算逐位相同，供参考路径使用）
+    //      三次插值的节点切线：Catmull-Rom 为 (P[i+1] - P[i-1]) / 2，
+    //      Hermite 为 (P[i+1] - P[i-1]) × 本段长 / (两侧段长之和)；
+    //      帧端点、零长度段、转角超过 60° 的拐角、段类型（消隐/光束/普通）变化处不平滑，
+    //      切线取本段弦向量；光束段（起点 Z > 0）总是线性
+    // 参数：
+    //   raw - 原始点（至少 2 个点）
+    //   segment - 原始段序号（< raw.Count - 1）
+    //   mode - 插值方式
+    //   t - 段内参数 [0, 1]
+    //   x, y - [输出] 插值位置
+    //==========================================================================
+    static void GetSamplePosition(const FrameView& raw, size_t segment, LaserSettings::InterpolationMode mode,
+                                  float t, float& x, float& y);
+
+    //==========================================================================
+    // 函数：MergePixelRuns
+    // 描述：LOD 合并：连续且落在同一网格单元的非光束点（Z = 0）合并为一个点，
+    //      位置、Z 和聚焦取首个点（光栅化到同一像素），颜色累加以保持加法混合亮度；
+    //      累加后任一颜色通道超过 maxColor 时从该点开始新的合并
+    // 参数：
+    //   points - [输入/输出] 点列表
+    //   cellsPerUnit - 每单位坐标的网格单元数（单元边界与 [-1, 1] 映射的像素边界对齐）
+    //   maxColor - 合并后颜色通道的上限（量化顶点格式最大可表示 4）
+    // 返回值：
+    //   合并掉的点数
+    //==========================================================================
+    static size_t MergePixelRuns(LaserFrame& points, float cellsPerUnit, float maxColor);
+
+    //==========================================================================
+    // 函数：SimplifyPoints
+    // 描述：输入简化：在相邻保留点之间用 Douglas-Peucker 移除到折线段距离不超过容差的点
+    //      帧首尾、光束点（Z ≠ 0）、与相邻点位置相同（驻留）或颜色/Z/聚焦与相邻点不同的点总是保留，
+    //      因此颜色和消隐变化、光束驻留与拐角驻留不受影响；距离按点到线段计算，折返路径不会被拉直
+    // 参数：
+    //   raw - 原始点
+    //   tolerance - 容差（原始坐标单位）
+    //   out - [输出] 保留的点（容量不少于 raw.Count）
+    //   arena - 暂存使用的帧内存池（为空时使用临时缓冲）
+    //   spans - [输出] 保留点 j 到下一个保留点之间的原始段数（容量不少于 raw.Count，可为空）
+    // 返回值：
+    //   保留的点数
+    //==========================================================================
+    static size_t SimplifyPoints(const FrameView& raw, float tolerance, const MutableFrameView& out,
+                                 FrameArena* arena, size_t* spans = nullptr);
+
+    //==========================================================================
+    // 函数：DecimateToBudget
+    // 描述：点预算抽取：点数超过预算时按重要性原地抽取到预算以内
+    //      必须保留：帧首尾、光束点（Z ≠ 0）、消隐变化两侧的点、颜色相对上一个保留点变化超过阈值的点，
+    //      以及路径方向累计转过 30° 的点（拐角按转角密度保留）；其余可见点按误差扩散均匀抽取，
+    //      可选的空白点全部移除（加法混合下没有贡献）。必须保留的点超过预算时只输出这些点（软预算）
+    // 参数：
+    //   points - [输入/输出] 点列表
+    //   budget - 点数预算（0 表示不限制）
+    //   arena - 暂存使用的帧内存池（为空时使用临时缓冲）
+    // 返回值：
+    //   抽取掉的点数
+    //==========================================================================
+    static size_t DecimateToBudget(LaserFrame& points, size_t budget, FrameArena* arena);
+
+    //==========================================================================
+    // 函数：BuildGalvoResponse
+    // 描述：二阶振镜模型的离散化：Φ 由缩放平方法计算矩阵指数，脉冲响应截断到
+    //      衰减包络低于 1e-6 处（最多 1024 个系数，高扫描速率 × 多样本 × 低固有频率时达到上限，
+    //      响应尾部被截去，由 TailMass 给出），截断后按和归一化保持静止点位置不变
+    // 参数：
+    //   naturalFrequency - 固有频率（Hz）
+    //   damping - 阻尼比
+    //   samplePeriod - 样本时长（秒）
+    // 返回值：
+    //   离散化结果（参数无效时 Taps 为空）
+    //==========================================================================
+    static GalvoResponse BuildGalvoResponse(float naturalFrequency, float damping, double samplePeriod);
+
+    //==========================================================================
+    // 函数：IsSimdLevelSupported
+    // 描述：当前构建和 CPU 是否支持指定的实现级别（Auto 和 Scalar 总是支持）
+    // 参数：
+    //   level - 实现级别
+    // 返回值：
+    //   支持返回 true
+    //==========================================================================
+    static bool IsSimdLevelSupported(SimdLevel level);
+
+    //==========================================================================
+    // 函数：ShadeSamples
+    // 描述：延迟着色（VectorizedShading 的第二遍）：按记录的速度平方计算边缘淡化强度并缩放颜色，
+    //      intensity = min(4, 0.4 × edgeFade / |v|) / max(1, 8 × edgeFade) × (1 - f) + f，
+    //      f = max(0, edgeFade - 0.5) × 2；纯 float 运算，SIMD 级别以 rsqrt + 一次牛顿迭代求 1 / |v|。
+    //      速度平方为负的样本（光束点或未移动）颜色不变；低于 1e-30（含 0 和非规格化数）时按强度上限着色
+    // 参数：
+    //   samples - [输入/输出] 样本（缩放 R/G/B 通道）
+    //   speedSq - 各样本的速度平方
+    //   edgeFade - 边缘淡化因子（内部下限 0.1）
+    //   level - 实现级别
+    // 返回值：
+    //   级别不受支持时不处理并返回 false
+    //==========================================================================
+    static bool ShadeSamples(const MutableFrameView& samples, const float* speedSq, float edgeFade,
+                             SimdLevel level = SimdLevel::Auto);
+
+    //==========================================================================
+    // 函数：ConvolveTaps
+    // 描述：振镜模型的 FIR 卷积：output[n] = Σ taps[i] × input[n + i]，n ∈ [first, last)；
+    //      taps 按窗口顺序存放（反转的脉冲响应）。各级别每个输出的累加顺序相同（不使用 FMA），结果逐位一致
+    // 参数：
+    //   input - 输入样本（至少 last + tapCount - 1 个）
+    //   taps - 卷积系数
+    //   tapCount - 系数数
+    //   first, last - 输出范围
+    //   output - [输出] 卷积结果（写入 [first, last)）
+    //   level - 实现级别
+    // 返回值：
+    //   级别不受支持时不处理并返回 false
+    //==========================================================================
+    static bool ConvolveTaps(const float* input, const float* taps, size_t tapCount,
+                             size_t first, size_t last, float* output, SimdLevel level = SimdLevel::Auto);
+
+    //==========================================================================
+    // 函数：Run
+    // 描述：执行融合处理（每次调用都重新选择特化实例，频繁调用时应缓存 Select 的结果）
+    // 参数：
+    //   raw - 原始点（非空）
+    //   params - 处理参数
+    //   processed - [输出] 主点列表
+    //   beam - [输出] 光束点列表
+    //==========================================================================
+    static void Run(const FrameView& raw, const ScannerPipelineParams& params,
+                    LaserFrame& processed, LaserFrame& beam);
+};
+
+} // namespace Core
+} // namespace BeyondLink
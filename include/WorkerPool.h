@@ -0,0 +1,136 @@
+﻿//==============================================================================
+// 文件：WorkerPool.h
+// 作者：Yunsio
+// 日期：2025-10-06
+// 描述：常驻工作线程池，线程在构造时创建，处理期间不再创建线程，
+//      每个线程有自己的任务队列，空闲时从其他线程的队列窃取任务
+//==============================================================================
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace BeyondLink {
+namespace Core {
+
+//==========================================================================
+// 类：WorkerPool
+// 描述：常驻工作线程池
+//      - ParallelFor 将任务按序号轮流分配到各线程队列，调用线程同时参与执行并在全部完成后返回
+//      - 线程先按顺序执行自己队列中的任务，队列空后从其他队列尾部窃取，
+//        调用者按代价从大到小排列任务时，重任务先开始，轻任务用于平衡
+//      - 从工作线程内部嵌套调用，或另一个线程正在使用线程池时，任务在调用线程上串行执行
+//==========================================================================
+class WorkerPool {
+public:
+    //==========================================================================
+    // 构造函数：WorkerPool
+    // 描述：创建工作线程
+    // 参数：
+    //   workerCount - 工作线程数（不含调用线程，0 表示不创建线程，全部串行）
+    //==========================================================================
+    explicit WorkerPool(size_t workerCount);
+
+    //==========================================================================
+    // 析构函数：~WorkerPool
+    // 描述：通知并等待所有工作线程退出
+    //==========================================================================
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    //==========================================================================
+    // 函数：ParallelFor
+    // 描述：并行执行 task(0) ... task(taskCount - 1)，全部完成后返回
+    // 参数：
+    //   taskCount - 任务数量
+    //   task - 任务函数（参数为任务序号）
+    //==========================================================================
+    void ParallelFor(size_t taskCount, const std::function<void(size_t)>& task);
+
+    //==========================================================================
+    // 函数：GetConcurrency
+    // 描述：获取并行度（工作线程数 + 调用线程）
+    // 返回值：
+    //   并行度
+    //==========================================================================
+    size_t GetConcurrency() const { return m_Workers.size() + 1; }
+
+    //==========================================================================
+    // 函数：GetDefaultWorkerCount
+    // 描述：根据硬件线程数计算默认工作线程数（硬件线程数 - 1，为主线程保留一个核心）
+    // 参数：
+    //   requested - 配置的线程数（<= 0 表示自动）
+    // 返回值：
+    //   工作线程数
+    //==========================================================================
+    static size_t GetDefaultWorkerCount(int requested);
+
+    //==========================================================================
+    // 函数：GetStealCount
+    // 描述：获取累计任务窃取次数（用于观察负载均衡）
+    // 返回值：
+    //   窃取次数
+    //==========================================================================
+    uint64_t GetStealCount() const { return m_StealCount.load(std::memory_order_relaxed); }
+
+private:
+    //==========================================================================
+    // 函数：WorkerLoop
+    // 描述：工作线程主循环（等待任务批次并执行）
+    // 参数：
+    //   self - 工作线程的队列序号（从 1 开始）
+    //==========================================================================
+    void WorkerLoop(size_t self);
+
+    //==========================================================================
+    // 函数：RunTasks
+    // 描述：执行自己队列中的任务，队列空后窃取其他队列的任务，直到全部领取完毕
+    // 参数：
+    //   self - 当前线程的队列序号（0 为调用线程）
+    //==========================================================================
+    void RunTasks(size_t self);
+
+    //==========================================================================
+    // 函数：PopTask / StealTask
+    // 描述：从自己队列头部领取 / 从其他队列尾部窃取一个任务
+    //==========================================================================
+    bool PopTask(size_t self, size_t& task);
+    bool StealTask(size_t self, size_t& task);
+
+    //==========================================================================
+    // 结构体：TaskQueue
+    // 描述：单个线程的任务队列（任务序号，Head 之前的已被领取）
+    //==========================================================================
+    struct TaskQueue {
+        std::mutex Mutex;
+        std::vector<size_t> Tasks;
+        size_t Head = 0;
+    };
+
+private:
+    std::vector<std::thread> m_Workers;          // 工作线程
+    std::mutex m_SubmitMutex;                    // 同一时刻只允许一个批次
+    std::mutex m_Mutex;                          // 批次状态互斥锁
+    std::condition_variable m_WakeCondition;     // 新批次/退出通知
+    std::condition_variable m_DoneCondition;     // 批次完成通知
+    
+    std::unique_ptr<TaskQueue[]> m_Queues;       // 每个线程的任务队列（0 为调用线程）
+    const std::function<void(size_t)>* m_Task;   // 当前批次任务
+    std::atomic<uint64_t> m_StealCount;          // 累计窃取次数
+    size_t m_PendingWorkers;                     // 尚未完成当前批次的工作线程数
+    uint64_t m_Batch;                            // 批次序号
+    bool m_Stopping;                             // 退出标志
+};
+
+} // namespace Core
+} // namespace BeyondLink